@@ -107,6 +107,7 @@ g_config.layer = {
 
 g_config.saves = {
     ext : ".oc3save",
+    bin : ".oc3bin",
     fast : "_fastsave",
     auto : "_autosave",
 }
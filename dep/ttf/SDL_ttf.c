@@ -2332,3 +2332,39 @@ int TTF_GetFontKerningSize(TTF_Font* font, int prev_index, int index)
   }
   return (delta.x >> 6);
 }
+
+int TTF_GetFontKerningSizeGlyphs(TTF_Font *font, Uint16 previous_ch, Uint16 ch)
+{
+    FT_Error error;
+    FT_UInt glyph_index, prev_index;
+    FT_Vector delta;
+
+    if ( !font || !(FT_HAS_KERNING( font->face ) && font->kerning) ) {
+        return 0;
+    }
+
+    error = Find_Glyph(font, ch, CACHED_METRICS);
+    if ( error ) {
+        TTF_SetFTError("Couldn't find glyph", error);
+        return -1;
+    }
+    glyph_index = font->current->index;
+
+    error = Find_Glyph(font, previous_ch, CACHED_METRICS);
+    if ( error ) {
+        TTF_SetFTError("Couldn't find glyph", error);
+        return -1;
+    }
+    prev_index = font->current->index;
+
+    if ( !prev_index || !glyph_index ) {
+        return 0;
+    }
+
+    error = FT_Get_Kerning( font->face, prev_index, glyph_index, ft_kerning_default, &delta );
+    if ( error ) {
+        TTF_SetFTError("Couldn't get glyph kerning", error);
+        return -1;
+    }
+    return (delta.x >> 6);
+}
@@ -253,6 +253,9 @@ extern DECLSPEC int SDLCALL TTF_WasInit(void);
 /* Get the kerning size of two glyphs */
 extern DECLSPEC int TTF_GetFontKerningSize(TTF_Font *font, int prev_index, int index);
 
+/* Get the kerning size of two characters, same as text rendering applies (from SDL_ttf 2.0.14) */
+extern DECLSPEC int TTF_GetFontKerningSizeGlyphs(TTF_Font *font, Uint16 previous_ch, Uint16 ch);
+
 /* We'll use SDL for reporting errors */
 #define TTF_SetError    SDL_SetError
 #define TTF_GetError    SDL_GetError
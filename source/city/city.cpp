@@ -34,6 +34,10 @@
 #include "economy.hpp"
 #include "city_impl.hpp"
 #include "ambientsound.hpp"
+#include "roadgraph.hpp"
+#include "coverage_field.hpp"
+#include "goods_broker.hpp"
+#include "tick_profiler.hpp"
 
 #include <set>
 
@@ -64,6 +68,9 @@ public:
   city::Walkers walkers;
   city::Options options;
   ScopedPtr<city::Statistic> statistic;
+  ScopedPtr<city::RoadGraph> roadGraph;
+  ScopedPtr<city::CoverageField> coverage;
+  ScopedPtr<city::GoodsBroker> goodsBroker;
 
   PlayerPtr player;
 
@@ -102,6 +109,9 @@ PlayerCity::PlayerCity(world::EmpirePtr empire)
   _d->funds.setTaxRate(econ::Treasury::defaultTaxPrcnt);
   _d->states.age = 0;
   _d->statistic.createInstance(*this);
+  _d->roadGraph.createInstance(*this);
+  _d->coverage.createInstance(*this);
+  _d->goodsBroker.createInstance(*this);
   _d->walkers.idCount = 1;
   _d->sentiment = city::Sentiment::defaultValue;
   _d->empMapPicture.load(ResourceGroup::empirebits, 1);
@@ -170,17 +180,30 @@ void PlayerCity::timeStep(unsigned int time)
     _d->calculatePopulation();
   }
 
+  city::TickProfiler::beginTick( time );
+  city::TickProfiler::StageScope stage( city::TickProfiler::statistic );
+
   //update walkers access map
   _d->statistic->update( time );
+
+  stage.next( city::TickProfiler::walkers );
   _d->walkers.update( this, time );
+
+  stage.next( city::TickProfiler::overlays );
   _d->overlays.update( this, time );
+
+  stage.next( city::TickProfiler::services );
   _d->services.update( this, time );
+
+  stage.next( city::TickProfiler::timers );
   city::Timers::instance().update( time );
 
   if( getOption( updateRoadsOnNextFrame ) > 0 )
   {
+    stage.next( city::TickProfiler::roads );
     setOption( updateRoadsOnNextFrame, 0 );
     _d->overlays.recalcRoadAccess();
+    _d->roadGraph->invalidate();
   }
 }
 
@@ -213,8 +236,12 @@ const Tile& PlayerCity::getBorderInfo( TileType type ) const
 }
 
 const OverlayList& PlayerCity::overlays() const  { return _d->overlays; }
+const city::OverlayIndex& PlayerCity::overlayIndex() const { return _d->overlays.index; }
 city::ActivePoints& PlayerCity::activePoints()   { return _d->activePoints; }
 city::Scribes& PlayerCity::scribes()             { return _d->scribes; }
+city::RoadGraph& PlayerCity::roadGraph()         { return *_d->roadGraph; }
+city::CoverageField& PlayerCity::coverage()      { return *_d->coverage; }
+city::GoodsBroker& PlayerCity::goodsBroker()     { return *_d->goodsBroker; }
 Picture PlayerCity::picture() const              { return _d->empMapPicture; }
 bool PlayerCity::isPaysTaxes() const             { return _d->funds.getIssueValue( econ::Issue::empireTax, econ::Treasury::lastYear ) > 0; }
 bool PlayerCity::haveOverduePayment() const      { return _d->funds.getIssueValue( econ::Issue::overduePayment, econ::Treasury::thisYear ) > 0; }
@@ -238,13 +265,36 @@ DateTime PlayerCity::lastAttack() const
 void PlayerCity::save( VariantMap& stream) const
 {
   LOG_CITY.info( "Create save map" );
-  City::save( stream );
+  saveState( stream );
 
   LOG_CITY.info( "Save tilemap information" );
   VariantMap vm_tilemap;
   _d->tilemap.save( vm_tilemap );
-
   stream[ literals::tilemap    ] = vm_tilemap;
+
+  LOG_CITY.info( "Save walkers information" );
+  VARIANT_SAVE_CLASS_D( stream, _d, walkers )
+
+  LOG_CITY.info( "Save overlays information" );
+  VariantMap vm_overlays;
+  for( auto overlay : _d->overlays )
+  {
+    VariantMap vm_overlay;
+    if( saveOverlay( overlay, vm_overlay ) )
+    {
+      auto pos = overlay->pos();
+      vm_overlays[ fmt::format( "{},{}", pos.i(), pos.j() ) ] = vm_overlay;
+    }
+  }
+  stream[ "overlays" ] = vm_overlays;
+
+  LOG_CITY.info( "Finalize save map" );
+}
+
+void PlayerCity::saveState( VariantMap& stream ) const
+{
+  City::save( stream );
+
   VARIANT_SAVE_ENUM_D( stream, _d, walkers.idCount )
 
   LOG_CITY.info( "Save main paramters " );
@@ -265,29 +315,6 @@ void PlayerCity::save( VariantMap& stream) const
   VARIANT_SAVE_CLASS_D( stream, _d, buildOptions )
   VARIANT_SAVE_CLASS_D( stream, _d, winTargets )
 
-  LOG_CITY.info( "Save walkers information" );
-  VARIANT_SAVE_CLASS_D( stream, _d, walkers )
-
-  LOG_CITY.info( "Save overlays information" );
-  VariantMap vm_overlays;
-  for( auto overlay : _d->overlays )
-  {
-    VariantMap vm_overlay;
-    object::Type otype = object::typeOrDefault( overlay );
-
-    try
-    {
-      overlay->save( vm_overlay );
-      auto pos = overlay->pos();
-      vm_overlays[ fmt::format( "{},{}", pos.i(), pos.j() ) ] = vm_overlay;
-    }
-    catch(...)
-    {
-      LOG_CITY.error( "Can't save overlay type " + object::toString( otype ));
-    }
-  }
-  stream[ "overlays" ] = vm_overlays;
-
   LOG_CITY.info( "Save services information" );
   VariantMap vm_services;
   for (auto service : _d->services)
@@ -300,16 +327,67 @@ void PlayerCity::save( VariantMap& stream) const
   VARIANT_SAVE_ANY_D( stream, _d, states.age )
   VARIANT_SAVE_ANY_D( stream, _d, states.birth )
   VARIANT_SAVE_CLASS_D( stream, _d, activePoints )
+}
 
-  LOG_CITY.info( "Finalize save map" );
+bool PlayerCity::saveOverlay( OverlayPtr overlay, VariantMap& stream ) const
+{
+  try
+  {
+    overlay->save( stream );
+    return true;
+  }
+  catch(...)
+  {
+    LOG_CITY.error( "Can't save overlay type " + object::toString( object::typeOrDefault( overlay ) ));
+  }
+
+  return false;
+}
+
+bool PlayerCity::saveWalker( WalkerPtr walker, VariantMap& stream ) const
+{
+  try
+  {
+    walker->save( stream );
+    return true;
+  }
+  catch(...)
+  {
+    LOG_CITY.error( "Can't save walker type " + WalkerHelper::getTypename( walker->type() ));
+  }
+
+  return false;
 }
 
 void PlayerCity::load( const VariantMap& stream )
 {
   LOG_CITY.info( "Start parse savemap" );
 
-  City::load( stream );
   _d->tilemap.load( stream.get( literals::tilemap ).toMap() );
+  loadState( stream );
+
+  LOG_CITY.info( "Load overlays" );
+  VariantMap vmOverlays = stream.get( "overlays" ).toMap();
+  for( const auto& item : vmOverlays)
+  {
+    if( !loadOverlay( item.second.toMap() ) )
+      LOG_CITY.warn( "Can't load overlay " + item.first );
+  }
+
+  LOG_CITY.info( "Parse walkers info" );
+  VariantMap walkers = stream.get( "walkers" ).toMap();
+  for( const auto& item : walkers)
+  {
+    if( !loadWalker( item.second.toMap() ) )
+      LOG_CITY.warn( "Can't load walker " + item.first );
+  }
+
+  finishLoad( stream );
+}
+
+void PlayerCity::loadState( const VariantMap& stream )
+{
+  City::load( stream );
   _d->walkers.grid.resize( Size::square( _d->tilemap.size() ) );
   VARIANT_LOAD_ENUM_D( _d, walkers.idCount, stream)
 
@@ -333,58 +411,48 @@ void PlayerCity::load( const VariantMap& stream )
   VARIANT_LOAD_CLASS_D( _d, tradeOptions, stream )
   VARIANT_LOAD_CLASS_D( _d, buildOptions, stream )
   _d->winTargets.load(stream.get( "winTargets").toMap());
+}
 
-  LOG_CITY.info( "Load overlays" );
-  VariantMap vmOverlays = stream.get( "overlays" ).toMap();
+bool PlayerCity::loadOverlay( const VariantMap& stream )
+{
+  VariantList config = stream.get( "config" ).toList();
 
-  for( const auto& item : vmOverlays)
-  {
-    VariantMap overlayParams = item.second.toMap();
-    VariantList config = overlayParams.get( "config" ).toList();
+  object::Type overlayType = (object::Type)config.get(ovconfig::idxType).toInt();
+  TilePos pos = config.get( ovconfig::idxLocation, TilePos::invalid() );
 
-    object::Type overlayType = (object::Type)config.get(ovconfig::idxType).toInt();
-    TilePos pos = config.get( ovconfig::idxLocation, TilePos::invalid() );
+  auto overlay = Overlay::create( overlayType );
+  if( overlay.isNull() || !config::tilemap.isValidLocation( pos ) )
+    return false;
 
-    auto overlay = Overlay::create( overlayType );
-    if( overlay.isValid() && config::tilemap.isValidLocation( pos ) )
-    {
-      city::AreaInfo info(this, pos);
-      info.onload = true;
+  city::AreaInfo info(this, pos);
+  info.onload = true;
 
-      overlay->build(info);
-      overlay->load(overlayParams);
-      _d->overlays.push_back(overlay);
-    }
-    else
-    {
-      LOG_CITY.warn( "Can't load overlay " + item.first );
-    }
-  }
+  overlay->build(info);
+  overlay->load(stream);
+  _d->overlays.push_back(overlay);
+  return true;
+}
+
+bool PlayerCity::loadWalker( const VariantMap& stream )
+{
+  walker::Type walkerType = stream.get( "type", (int)walker::unknown ).toEnum<walker::Type>();
+
+  WalkerPtr walker = Walker::create( walkerType, this );
+  if( walker.isNull() )
+    return false;
+
+  walker->load( stream );
+  _d->walkers.push_back( walker );
+  return true;
+}
 
+void PlayerCity::finishLoad( const VariantMap& stream )
+{
   for( auto overlay : _d->overlays )
   {
     overlay->afterLoad();
   }
 
-  LOG_CITY.info( "Parse walkers info" );
-  VariantMap walkers = stream.get( "walkers" ).toMap();
-  for( const auto& item : walkers)
-  {
-    VariantMap walkerInfo = item.second.toMap();
-    walker::Type walkerType = walkerInfo.get( "type", (int)walker::unknown ).toEnum<walker::Type>();
-
-    WalkerPtr walker = Walker::create( walkerType, this );
-    if( walker.isValid() )
-    {
-      walker->load( walkerInfo );
-      _d->walkers.push_back( walker );
-    }
-    else
-    {
-      LOG_CITY.warn( "Can't load walker " + item.first );
-    }
-  }
-
   LOG_CITY.info( "Load service info" );
   VariantMap services = stream.get( "services" ).toMap();
   for( const auto& item : services)
@@ -415,6 +483,7 @@ void PlayerCity::load( const VariantMap& stream )
   }
 
   setOption( PlayerCity::constructorMode, 0 );
+  _d->roadGraph->invalidate();
   VARIANT_LOAD_ANY_D( _d, states.age, stream )
   VARIANT_LOAD_CLASS_D_LIST( _d, activePoints, stream )
 }
@@ -758,6 +827,8 @@ void PlayerCity::clean()
   _d->walkers.clear();
   city::Timers::instance().reset();
   _d->overlays.clear();
+  _d->roadGraph->invalidate();
+  _d->coverage->invalidate();
   _d->tilemap.resize( 0 );
 }
 
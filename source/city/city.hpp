@@ -32,6 +32,10 @@ class VictoryConditions;
 class Scribes;
 class ActivePoints;
 class Statistic;
+class RoadGraph;
+class CoverageField;
+class OverlayIndex;
+class GoodsBroker;
 namespace trade { class Options; }
 namespace development { class Options; }
 }
@@ -102,6 +106,16 @@ public:
   virtual void save( VariantMap& stream ) const;
   virtual void load( const VariantMap& stream );
 
+  /** Parts of save for streamed formats, which keep tilemap, overlays and
+   *  walkers out of main map. Load goes as state, overlays, walkers, finish */
+  void saveState( VariantMap& stream ) const;
+  bool saveOverlay( OverlayPtr overlay, VariantMap& stream ) const;
+  bool saveWalker( WalkerPtr walker, VariantMap& stream ) const;
+  void loadState( const VariantMap& stream );
+  bool loadOverlay( const VariantMap& stream );
+  bool loadWalker( const VariantMap& stream );
+  void finishLoad( const VariantMap& stream );
+
   /** Add static object to city */
   void addOverlay(OverlayPtr overlay);
 
@@ -112,9 +126,21 @@ public:
   /** Get all static objects in city */
   const OverlayList& overlays() const;
 
+  /** Get static objects split by type and group */
+  const city::OverlayIndex& overlayIndex() const;
+
   city::ActivePoints& activePoints();
   city::Scribes& scribes();
 
+  /** Return cached distances over road network */
+  city::RoadGraph& roadGraph();
+
+  /** Return buildings reached by service walkers from every tile */
+  city::CoverageField& coverage();
+
+  /** Return storages which can give goods to walkers */
+  city::GoodsBroker& goodsBroker();
+
   const city::development::Options& buildOptions() const;
   void setBuildOptions(const city::development::Options& options);
 
@@ -29,16 +29,22 @@
 #include "objects/construction.hpp"
 #include "walker/helper.hpp"
 #include "game/difficulty.hpp"
+#include "roadgraph.hpp"
+#include "tick_profiler.hpp"
 
 namespace city
 {
 
 void Services::update(PlayerCityPtr, unsigned int time)
 {
+  TickProfiler::Breakdown breakdown( TickProfiler::serviceName );
   iterator serviceIt = begin();
   while( serviceIt != end() )
   {
+    breakdown.start();
     (*serviceIt)->timeStep( time );
+    if( breakdown.active() )
+      breakdown.stop( TickProfiler::serviceId( (*serviceIt)->name() ) );
 
     if( (*serviceIt)->isDeleted() )
     {
@@ -65,16 +71,20 @@ void Services::initialize(PlayerCityPtr city, const std::string& model)
 
 void Overlays::update(PlayerCityPtr city, unsigned int time)
 {
+  TickProfiler::Breakdown breakdown( TickProfiler::overlayType );
   iterator overlayIt = begin();
   while( overlayIt != end() )
   {
+    breakdown.start();
     (*overlayIt)->timeStep( time );
+    breakdown.stop( (*overlayIt)->type() );
 
     if( (*overlayIt)->isDeleted() )
     {
       onDestroyOverlay( city, *overlayIt );
       // remove the overlay from the overlay list
       (*overlayIt)->destroy();
+      index.remove( *overlayIt );
       overlayIt = erase(overlayIt);
     }
     else
@@ -83,9 +93,27 @@ void Overlays::update(PlayerCityPtr city, unsigned int time)
     }
   }
 
+  for( auto overlay : postponed() )
+  {
+    city->roadGraph().invalidate( overlay->type() );
+    index.add( overlay );
+  }
+
   merge();
 }
 
+void Overlays::push_back( OverlayPtr overlay )
+{
+  FlowList::push_back( overlay );
+  index.add( overlay );
+}
+
+void Overlays::clear()
+{
+  FlowList::clear();
+  index.clear();
+}
+
 void Overlays::recalcRoadAccess()
 {
   // for each overlay
@@ -100,6 +128,7 @@ void Overlays::recalcRoadAccess()
 void Overlays::onDestroyOverlay(PlayerCityPtr city, OverlayPtr overlay)
 {
   Desirability::update( city, overlay, Desirability::off );
+  city->roadGraph().invalidate( overlay->type() );
 }
 
 void Walkers::postpone(WalkerPtr w)
@@ -142,15 +171,18 @@ VariantMap Walkers::save() const
 
 void Walkers::update(PlayerCityPtr, unsigned int time)
 {
+  TickProfiler::Breakdown breakdown( TickProfiler::walkerType );
   auto wlkIt = begin();
   while( wlkIt != end() )
   {
     WalkerPtr walker = *wlkIt;
+    breakdown.start();
     walker->timeStep( time );
+    breakdown.stop( walker->type() );
     if( walker->isDeleted() )
     {
       // remove the walker from the walkers list
-      //grid.remove( *it );
+      grid.remove( walker );
       wlkIt = erase(wlkIt);
     }
     else { ++wlkIt; }
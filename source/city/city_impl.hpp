@@ -22,6 +22,7 @@
 #include "objects/predefinitions.hpp"
 #include "core/flowlist.hpp"
 #include "walkergrid.hpp"
+#include "overlay_index.hpp"
 
 namespace city
 {
@@ -40,6 +41,13 @@ public:
 class Overlays : public FlowList<Overlay>
 {
 public:
+  // overlays split by type and group, follows list changes
+  OverlayIndex index;
+
+  /** Add overlay right now, used on city load */
+  void push_back( OverlayPtr overlay );
+  void clear();
+
   void update( PlayerCityPtr city, unsigned int time );
   void recalcRoadAccess();
   void onDestroyOverlay( PlayerCityPtr city, OverlayPtr overlay );
@@ -25,6 +25,7 @@
 #include "walker/rioter.hpp"
 #include "core/variant_map.hpp"
 #include "game/gamedate.hpp"
+#include "core/hash.hpp"
 #include "events/event.hpp"
 #include "walker/mugger.hpp"
 #include "events/showinfobox.hpp"
@@ -228,7 +229,8 @@ void Disorder::timeStep( const unsigned int time )
     _d->crime.protestor.nextYear();
   }
 
-  if( game::Date::isWeekChanged() )
+  // houses change crime by own phases, average is taken once a week
+  if( game::Date::isWeekPhase( game::Date::phaseOf( Hash( name() ) ) ) )
   {
     _d->weekUpdate( time, _city() );
   }
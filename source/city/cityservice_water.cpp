@@ -17,40 +17,235 @@
 
 #include "cityservice_water.hpp"
 #include "city.hpp"
+#include "cityservice_factory.hpp"
 #include "gfx/tilemap.hpp"
-#include "game/gamedate.hpp"
-#include "gfx/tilesarray.hpp"
+#include "gfx/tileparams.hpp"
+#include "objects/watersupply.hpp"
+
+#include <set>
 
 using namespace gfx;
 
 namespace city
 {
 
-const int waterDecreaseInterval = game::Date::days2ticks( 5 );
+REGISTER_SERVICE_IN_FACTORY(Water,water)
 
-Water::Water( PlayerCityPtr city )
-  : city::Srvc( city, TEXT(Water) )
+namespace {
+enum { fullWater=100, noNode=-1 };
+}
+
+class Water::Impl
+{
+public:
+  std::vector<WaterSourcePtr> nodes;
+  std::vector<int> parent;        // union-find over nodes, links are taken both ways
+  std::vector<int> nodeAt;        // node by index of master tile
+  std::set<int> changed;          // nodes which components need new levels
+  bool rebuild;                   // destroy can't be undone in union-find, so all is relinked
+  bool resetCoverage;             // aquifer counters from save are rebuilt by reservoirs
+
+  int find( int node );
+  void unite( int a, int b );
+  int nodeOf( const Tilemap& tmap, const TilePos& pos ) const;
+  int append( const Tilemap& tmap, WaterSourcePtr source );
+  void link( Tilemap& tmap, int node, bool incoming );
+  void relinkAll( PlayerCityPtr city );
+  void updateLevels( const Tilemap& tmap );
+};
+
+int Water::Impl::find( int node )
 {
+  while( parent[ node ] != node )
+  {
+    parent[ node ] = parent[ parent[ node ] ];
+    node = parent[ node ];
+  }
+
+  return node;
 }
 
-void Water::timeStep( const unsigned int time )
-{  
-  if( time % waterDecreaseInterval == 0 )
+void Water::Impl::unite( int a, int b )
+{
+  a = find( a );
+  b = find( b );
+  if( a != b )
+    parent[ std::max( a, b ) ] = std::min( a, b );
+}
+
+int Water::Impl::nodeOf( const Tilemap& tmap, const TilePos& pos ) const
+{
+  if( !tmap.isInside( pos ) )
+    return noNode;
+
+  auto source = tmap.at( pos ).overlay<WaterSource>();
+  if( source.isNull() || source->isDeleted() )
+    return noNode;
+
+  const TilePos& master = source->pos();
+  return nodeAt[ master.j() * tmap.size() + master.i() ];
+}
+
+int Water::Impl::append( const Tilemap& tmap, WaterSourcePtr source )
+{
+  int& node = nodeAt[ source->pos().j() * tmap.size() + source->pos().i() ];
+  if( node != noNode && nodes[ node ] == source )
+    return noNode;
+
+  node = nodes.size();
+  nodes.push_back( source );
+  parent.push_back( node );
+  return node;
+}
+
+void Water::Impl::link( Tilemap& tmap, int node, bool incoming )
+{
+  WaterSourcePtr source = nodes[ node ];
+  for( auto& outlet : source->outlets() )
+  {
+    int target = nodeOf( tmap, outlet );
+    if( target != noNode )
+      unite( node, target );
+  }
+
+  if( !incoming )
+    return;
+
+  // new object may be outlet of neighbours, which were built earlier
+  TilesArray around = tmap.rect( source->pos() - TilePos( 1, 1 ), source->size() + Size::square( 2 ) );
+  for( auto tile : around )
+  {
+    int neighbour = nodeOf( tmap, tile->epos() );
+    if( neighbour == noNode || find( neighbour ) == find( node ) )
+      continue;
+
+    for( auto& outlet : nodes[ neighbour ]->outlets() )
+    {
+      if( nodeOf( tmap, outlet ) == node )
+      {
+        unite( node, neighbour );
+        break;
+      }
+    }
+  }
+}
+
+void Water::Impl::relinkAll( PlayerCityPtr city )
+{
+  Tilemap& tmap = city->tilemap();
+  nodes.clear();
+  parent.clear();
+  changed.clear();
+  nodeAt.assign( tmap.size() * tmap.size(), noNode );
+
+  auto sources = city->overlays().select<WaterSource>();
+  for( auto source : sources )
+  {
+    if( !source->isDeleted() )
+      append( tmap, source );
+  }
+
+  for( unsigned int node=0; node < nodes.size(); node++ )
+  {
+    link( tmap, node, false );
+    changed.insert( node );
+  }
+
+  rebuild = false;
+}
+
+void Water::Impl::updateLevels( const Tilemap& tmap )
+{
+  std::set<int> roots;
+  for( auto node : changed )
+    roots.insert( find( node ) );
+  changed.clear();
+
+  // levels of other components stay as they are
+  std::vector<int> level( nodes.size(), noNode );
+  std::vector<int> queue;
+  for( unsigned int node=0; node < nodes.size(); node++ )
   {
-    const TilesArray& tiles = _city()->tilemap().allTiles();
-    for( auto tile : tiles )
+    if( !roots.count( find( node ) ) )
+      continue;
+
+    level[ node ] = 0;
+    if( nodes[ node ]->isSource() )
     {
-      int value = tile->param( Tile::pFountainWater );
-      if( value > 0 )
-        tile->setParam( Tile::pFountainWater, math::max( 0, value-1) );
+      level[ node ] = fullWater;
+      queue.push_back( node );
+    }
+  }
 
-      value = tile->param( Tile::pWellWater );
-      if( value > 0 )
-        tile->setParam( Tile::pWellWater, math::max( 0, value-1) );
+  // all sources give same level, so first visit by bfs is the highest one
+  for( unsigned int head=0; head < queue.size(); head++ )
+  {
+    int node = queue[ head ];
+    if( level[ node ] <= 1 )
+      continue;
+
+    for( auto& outlet : nodes[ node ]->outlets() )
+    {
+      int target = nodeOf( tmap, outlet );
+      if( target != noNode && level[ target ] == 0 && !nodes[ target ]->isSource() )
+      {
+        level[ target ] = level[ node ] - 1;
+        queue.push_back( target );
+      }
     }
+  }
+
+  for( unsigned int node=0; node < nodes.size(); node++ )
+  {
+    if( level[ node ] != noNode )
+      nodes[ node ]->setWater( level[ node ] );
+  }
+}
+
+std::string Water::defaultName() { return TEXT(Water); }
+
+Water::Water( PlayerCityPtr city )
+  : city::Srvc( city, Water::defaultName() ), _d( new Impl )
+{
+  _d->rebuild = true;
+  _d->resetCoverage = true;
+}
 
+Water::~Water() {}
 
+void Water::timeStep( const unsigned int time )
+{
+  if( _d->resetCoverage )
+  {
+    TileParams::Plane plane = _city()->tilemap().params().plane( Tile::pReservoirWater );
+    std::fill( plane.begin(), plane.end(), 0 );
+    _d->resetCoverage = false;
   }
+
+  if( _d->rebuild )
+    _d->relinkAll( _city() );
+
+  if( !_d->changed.empty() )
+    _d->updateLevels( _city()->tilemap() );
+}
+
+void Water::addSource( WaterSourcePtr source )
+{
+  if( _d->rebuild || source.isNull() )
+    return;
+
+  Tilemap& tmap = _city()->tilemap();
+  int node = _d->append( tmap, source );
+  if( node == noNode )
+    return;
+
+  _d->link( tmap, node, true );
+  _d->changed.insert( node );
+}
+
+void Water::removeSource( WaterSourcePtr source )
+{
+  _d->rebuild = true;
 }
 
 }//end namespace city
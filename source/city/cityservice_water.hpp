@@ -20,17 +20,29 @@
 
 #include "cityservice.hpp"
 #include "game/predefinitions.hpp"
+#include "objects/predefinitions.hpp"
 
 namespace city
 {
 
+// Network of aqueducts and reservoirs. Connectivity is kept in union-find,
+// which grows on build and is rebuilt after destroy. Water levels are
+// recalculated only for components, which topology or sources changed.
 class Water : public city::Srvc
 {
 public:
+  static std::string defaultName();
   virtual void timeStep(const unsigned int time );
 
+  void addSource( WaterSourcePtr source );
+  void removeSource( WaterSourcePtr source );
+
+  Water( PlayerCityPtr city );
+  virtual ~Water();
+
 private:
-  Water( PlayerCityPtr city );  
+  class Impl;
+  ScopedPtr< Impl > _d;
 };
 
 }//end namespace city
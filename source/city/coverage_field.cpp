@@ -0,0 +1,155 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "coverage_field.hpp"
+#include "city.hpp"
+#include "gfx/tilemap.hpp"
+#include "gfx/tilemasks.hpp"
+#include "objects/building.hpp"
+#include <algorithm>
+#include <map>
+
+using namespace gfx;
+
+namespace city
+{
+
+namespace {
+struct Cell
+{
+  unsigned int generation;
+  CoverageField::Indexes buildings;
+
+  Cell() : generation( 0 ) {}
+};
+
+typedef std::vector<Cell> Cells;
+}
+
+class CoverageField::Impl
+{
+public:
+  typedef std::map<unsigned int, Cells> Layers;
+  typedef std::map<Building*, unsigned int> Numbers;
+
+  PlayerCity& city;
+  Layers layers;  // one layer per reach distance
+  std::vector<BuildingPtr> buildings;
+  Numbers numbers;
+  unsigned int generation;
+  unsigned int overlaysRevision;
+
+  Impl( PlayerCity& c ) : city( c ), generation( 1 ), overlaysRevision( 0 ) {}
+
+  void validate( const TileMasks& masks );
+  void reset();
+  unsigned int number( BuildingPtr building );
+  void fill( Cell& cell, const TilePos& pos, unsigned int distance );
+};
+
+CoverageField::CoverageField( PlayerCity& city ) : _d( new Impl( city ) ) {}
+
+CoverageField::~CoverageField() {}
+
+void CoverageField::Impl::validate( const TileMasks& masks )
+{
+  if( overlaysRevision != masks.overlaysRevision() )
+  {
+    overlaysRevision = masks.overlaysRevision();
+    reset();
+  }
+}
+
+void CoverageField::Impl::reset()
+{
+  buildings.clear();
+  numbers.clear();
+
+  generation++;
+  if( generation == 0 )
+  {
+    // stamps wrapped around, old cells could look actual again
+    layers.clear();
+    generation = 1;
+  }
+}
+
+unsigned int CoverageField::Impl::number( BuildingPtr building )
+{
+  Numbers::iterator it = numbers.find( building.object() );
+  if( it != numbers.end() )
+    return it->second;
+
+  unsigned int index = buildings.size();
+  buildings.push_back( building );
+  numbers[ building.object() ] = index;
+  return index;
+}
+
+void CoverageField::Impl::fill( Cell& cell, const TilePos& pos, unsigned int distance )
+{
+  cell.buildings.clear();
+  cell.generation = generation;
+
+  TilePos offset( distance, distance );
+  TilesArray area = city.tilemap().area( pos - offset, pos + offset );
+
+  std::vector<Building*> found;
+  for( auto tile : area )
+  {
+    BuildingPtr building = tile->overlay<Building>();
+    if( building.isValid() )
+      found.push_back( building.object() );
+  }
+
+  // same order as std::set<BuildingPtr> keeps
+  std::sort( found.begin(), found.end() );
+  found.erase( std::unique( found.begin(), found.end() ), found.end() );
+
+  for( auto building : found )
+    cell.buildings.push_back( number( building ) );
+}
+
+const CoverageField::Indexes& CoverageField::reached( const TilePos& pos, unsigned int distance )
+{
+  static const Indexes invalidIndexes;
+
+  const TileMasks& masks = _d->city.tilemap().masks();
+  if( !masks.isInside( pos.i(), pos.j() ) )
+    return invalidIndexes;
+
+  _d->validate( masks );
+
+  Cells& cells = _d->layers[ distance ];
+  if( (int)cells.size() != masks.size() * masks.size() )
+    cells.assign( masks.size() * masks.size(), Cell() );
+
+  Cell& cell = cells[ masks.index( pos.i(), pos.j() ) ];
+  if( cell.generation != _d->generation )
+    _d->fill( cell, pos, distance );
+
+  return cell.buildings;
+}
+
+BuildingPtr CoverageField::building( unsigned int index ) const
+{
+  return index < _d->buildings.size() ? _d->buildings[ index ] : BuildingPtr();
+}
+
+unsigned int CoverageField::count() const { return _d->buildings.size(); }
+
+void CoverageField::invalidate() { _d->reset(); }
+
+}//end namespace city
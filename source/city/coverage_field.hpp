@@ -0,0 +1,62 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __CAESARIA_COVERAGE_FIELD_H_INCLUDED__
+#define __CAESARIA_COVERAGE_FIELD_H_INCLUDED__
+
+#include "core/scopedptr.hpp"
+#include "core/position.hpp"
+#include "objects/predefinitions.hpp"
+#include <vector>
+
+class PlayerCity;
+
+namespace city
+{
+
+/*
+ * Buildings which service walker reaches from every tile.
+ * Lists are filled on first request and live until some tile
+ * gets another overlay. Buildings are numbered densely, so
+ * walkers can keep per building state in plain arrays.
+ */
+class CoverageField
+{
+public:
+  typedef std::vector<unsigned int> Indexes;
+
+  CoverageField( PlayerCity& city );
+  ~CoverageField();
+
+  /** Return numbers of buildings in square with given radius around tile,
+   *  ordered same way as ReachedBuildings set does */
+  const Indexes& reached( const TilePos& pos, unsigned int distance );
+
+  /** Return building by its number */
+  BuildingPtr building( unsigned int index ) const;
+
+  /** Return how many buildings have numbers now */
+  unsigned int count() const;
+
+  void invalidate();
+
+private:
+  class Impl;
+  ScopedPtr< Impl > _d;
+};
+
+}//end namespace city
+
+#endif //__CAESARIA_COVERAGE_FIELD_H_INCLUDED__
@@ -18,40 +18,70 @@
 #include "desirability.hpp"
 #include "objects/overlay.hpp"
 #include "city.hpp"
+#include "core/math.hpp"
 #include "gfx/tilemap.hpp"
-#include "gfx/tilearea.hpp"
+#include "gfx/tileparams.hpp"
+#include <vector>
 
 using namespace gfx;
 
+namespace {
+
+// plain loop over contiguous row, compiler vectorizes it
+inline void addSpan( TileParams::Value* row, int from, int to, int value )
+{
+  for( int i=from; i <= to; i++ )
+    row[ i ] = TileParams::fit( row[ i ] + value );
+}
+
+}
+
 void Desirability::update( PlayerCityPtr r, OverlayPtr overlay, bool onBuild )
 {
   if( r.isNull() )
     return;
 
-  Tilemap& tilemap = r->tilemap();
-
   const Desirability& dsrbl = overlay->desirability();
+  if( dsrbl.base == 0 && dsrbl.step == 0 )
+    return;
+
   int mul = ( onBuild ? 1 : -1);
+  int range = math::max( dsrbl.range, 0 );
 
-  //change desirability in selfarea
-  TilesArea area( tilemap, overlay->pos(), overlay->size() );
-  for( auto tile : area )
-  {
-    tile->changeParam( Tile::pDesirability, mul * dsrbl.base );
-  }
+  // value at distance d from footprint: base inside, base + (d-1)*step on ring d
+  std::vector<int> rings( range + 1 );
+  rings[ 0 ] = mul * dsrbl.base;
+  for( int d=1; d <= range; d++ )
+    rings[ d ] = mul * ( dsrbl.base + ( d - 1 ) * dsrbl.step );
+
+  TileParams::Plane plane = r->tilemap().params().plane( Tile::pDesirability );
+  const int size = plane.size();
+
+  // footprint, every ring is the perimeter of footprint grown by its number
+  const TilePos& pos = overlay->pos();
+  const int x0 = pos.i();
+  const int y0 = pos.j();
+  const int x1 = x0 + math::max( overlay->size().width(), 1 ) - 1;
+  const int y1 = y0 + math::max( overlay->size().height(), 1 ) - 1;
 
-  //change deisirability around
-  int current = mul * dsrbl.base;
-  for( int curRange=1; curRange <= dsrbl.range; curRange++ )
+  const int left = math::max( x0 - range, 0 );
+  const int right = math::min( x1 + range, size - 1 );
+  const int top = math::max( y0 - range, 0 );
+  const int bottom = math::min( y1 + range, size - 1 );
+
+  for( int j=top; j <= bottom; j++ )
   {
-    TilesArray perimetr = tilemap.rect( overlay->pos() - TilePos( curRange, curRange ),
-                                                overlay->size() + Size::square( 2 * curRange ) );
-    for( auto tile : perimetr )
-    {
-      tile->changeParam( Tile::pDesirability, current );
-    }
-
-    current += mul * dsrbl.step;
+    TileParams::Value* row = plane.row( j );
+    const int dj = math::max( 0, math::max( y0 - j, j - y1 ) );
+
+    // both sides of footprint column, only there ring number depends on i
+    for( int i=left; i < math::min( x0, right + 1 ); i++ )
+      row[ i ] = TileParams::fit( row[ i ] + rings[ math::max( x0 - i, dj ) ] );
+
+    addSpan( row, math::max( x0, left ), math::min( x1, right ), rings[ dj ] );
+
+    for( int i=math::max( x1 + 1, left ); i <= right; i++ )
+      row[ i ] = TileParams::fit( row[ i ] + rings[ math::max( i - x1, dj ) ] );
   }
 }
 
@@ -25,6 +25,7 @@
 #include "core/logger.hpp"
 #include "events/dispatcher.hpp"
 #include "gfx/tilemap.hpp"
+#include "gfx/tileparams.hpp"
 #include "cityservice_factory.hpp"
 
 using namespace gfx;
@@ -90,12 +91,11 @@ DesirabilityUpdater::DesirabilityUpdater(PlayerCityPtr city)
 
 void DesirabilityUpdater::Impl::update( PlayerCityPtr city, bool positive)
 {
-  const TilesArray& tiles = city->tilemap().allTiles();
+  TileParams::Plane plane = city->tilemap().params().plane( Tile::pDesirability );
+  const int delta = positive ? value : -value;
 
-  for( auto tile : tiles )
-  {
-    tile->changeParam( Tile::pDesirability, positive ? value : -value );
-  }
+  for( auto& current : plane )
+    current = TileParams::fit( current + delta );
 }
 
 }//end namespace city
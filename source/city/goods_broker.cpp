@@ -0,0 +1,162 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "goods_broker.hpp"
+#include "city.hpp"
+#include "overlay_index.hpp"
+#include "objects/building.hpp"
+#include "good/store.hpp"
+#include "gfx/tile.hpp"
+#include "gfx/tilesarray.hpp"
+#include "pathway/path_finding.hpp"
+#include <algorithm>
+#include <vector>
+
+using namespace gfx;
+
+namespace city
+{
+
+namespace {
+struct Candidate
+{
+  BuildingPtr building;
+  int qty;
+};
+
+inline bool richer( const Candidate& a, const Candidate& b ) { return a.qty > b.qty; }
+
+// road way can't be shorter than straight distance between footprints
+inline int minDistance( ConstructionPtr from, BuildingPtr to )
+{
+  int sizes = from->size().width() + to->size().width() + 2;
+  return (int)from->pos().distanceFrom( to->pos() ) - sizes;
+}
+
+}
+
+GoodsBroker::GoodsBroker( PlayerCity& city ) : _city( city ) {}
+
+GoodsBroker::Offer GoodsBroker::findSource( good::Product what, object::Type storageType,
+                                            ConstructionPtr from, int maxDistance, BuildingPtr exclude )
+{
+  Offer offer;
+  if( from.isNull() || from->roadside().empty() )
+    return offer;
+
+  std::vector<Candidate> candidates;
+  for( auto overlay : _city.overlayIndex().byType( storageType ) )
+  {
+    BuildingPtr building = overlay.as<Building>();
+    if( building.isNull() || building == exclude || building->isDeleted() )
+      continue;
+
+    if( minDistance( from, building ) > maxDistance )
+      continue;
+
+    Candidate candidate;
+    candidate.qty = building->store().available( what );
+    if( candidate.qty > 0 )
+    {
+      candidate.building = building;
+      candidates.push_back( candidate );
+    }
+  }
+
+  std::stable_sort( candidates.begin(), candidates.end(), richer );
+
+  if( candidates.empty() )
+    return offer;
+
+  // one road flood from every roadside tile, it stops early when the richest
+  // storage is reached, otherwise it knows all storages within max distance
+  PlayerCityPtr cityPtr( &_city );
+  Propagator propagator( cityPtr );
+  propagator.setAllDirections( false );
+  propagator.init( from );
+  propagator.propagateTo( candidates.front().building->roadside(), maxDistance );
+
+  for( auto& candidate : candidates )
+  {
+    Pathway way = propagator.wayTo( candidate.building->roadside() );
+    if( way.isValid() )
+    {
+      offer.building = candidate.building;
+      offer.qty = candidate.qty;
+      offer.way = way;
+      break;
+    }
+  }
+
+  return offer;
+}
+
+GoodsBroker::Offer GoodsBroker::findSink( good::Product what, int qty, object::Type storageType,
+                                          ConstructionPtr from, int maxDistance )
+{
+  Offer offer;
+  if( from.isNull() || from->roadside().empty() )
+    return offer;
+
+  std::vector<Candidate> candidates;
+  for( auto overlay : _city.overlayIndex().byType( storageType ) )
+  {
+    BuildingPtr building = overlay.as<Building>();
+    if( building.isNull() || building.object() == from.object() || building->isDeleted() )
+      continue;
+
+    if( minDistance( from, building ) > maxDistance )
+      continue;
+
+    Candidate candidate;
+    candidate.qty = building->store().freeRoom( what );
+    if( candidate.qty >= qty )
+    {
+      candidate.building = building;
+      candidates.push_back( candidate );
+    }
+  }
+
+  TilesArray targets;
+  for( auto& candidate : candidates )
+    targets.append( candidate.building->roadside() );
+
+  if( targets.empty() )
+    return offer;
+
+  // breadth first road flood, the first reached storage has the shortest way
+  PlayerCityPtr cityPtr( &_city );
+  Propagator propagator( cityPtr );
+  propagator.setAllDirections( false );
+  propagator.init( from );
+  Tile* reached = propagator.propagateTo( targets, maxDistance );
+  if( reached == 0 )
+    return offer;
+
+  for( auto& candidate : candidates )
+  {
+    if( candidate.building->roadside().contain( reached ) )
+    {
+      offer.building = candidate.building;
+      offer.qty = candidate.qty;
+      offer.way = propagator.wayTo( candidate.building->roadside() );
+      break;
+    }
+  }
+
+  return offer;
+}
+
+}//end namespace city
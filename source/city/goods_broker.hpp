@@ -0,0 +1,67 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __CAESARIA_GOODS_BROKER_H_INCLUDED__
+#define __CAESARIA_GOODS_BROKER_H_INCLUDED__
+
+#include "objects/predefinitions.hpp"
+#include "objects/constants.hpp"
+#include "good/good.hpp"
+#include "pathway/pathway.hpp"
+
+class PlayerCity;
+
+namespace city
+{
+
+/*
+ * Finds storage buildings which can give goods to city walkers or
+ * take goods from them. Storages answer from own per-product index
+ * (good::Store::available/freeRoom), which is rebuilt only after
+ * store, retrieve or reserve. Then one road flood from all roadside
+ * tiles, bounded by max distance, stops as soon as answer is known.
+ */
+class GoodsBroker
+{
+public:
+  struct Offer
+  {
+    BuildingPtr building;
+    int qty;
+    Pathway way;
+
+    Offer() : qty( 0 ) {}
+    bool isValid() const { return building.isValid(); }
+  };
+
+  GoodsBroker( PlayerCity& city );
+
+  /** Return storage of given type with most goods available for retrieve,
+   *  which can be reached by roads from building within max distance */
+  Offer findSource( good::Product what, object::Type storageType,
+                    ConstructionPtr from, int maxDistance, BuildingPtr exclude=BuildingPtr() );
+
+  /** Return storage of given type with room for qty of product,
+   *  which has shortest road way from building within max distance */
+  Offer findSink( good::Product what, int qty, object::Type storageType,
+                  ConstructionPtr from, int maxDistance );
+
+private:
+  PlayerCity& _city;
+};
+
+}//end namespace city
+
+#endif //__CAESARIA_GOODS_BROKER_H_INCLUDED__
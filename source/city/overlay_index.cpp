@@ -0,0 +1,75 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "overlay_index.hpp"
+#include "objects/overlay.hpp"
+
+namespace city
+{
+
+namespace {
+static const OverlayList emptyList;
+
+template<class Lists, class Key>
+void removeFrom( Lists& lists, const Key& key, OverlayPtr overlay )
+{
+  typename Lists::iterator it = lists.find( key );
+  if( it == lists.end() )
+    return;
+
+  it->second.remove( overlay );
+  if( it->second.empty() )
+    lists.erase( it );
+}
+
+template<class Lists, class Key>
+const OverlayList& listFrom( const Lists& lists, const Key& key )
+{
+  typename Lists::const_iterator it = lists.find( key );
+  return it != lists.end() ? it->second : emptyList;
+}
+}
+
+OverlayIndex::OverlayIndex() {}
+OverlayIndex::~OverlayIndex() {}
+
+void OverlayIndex::add( OverlayPtr overlay )
+{
+  if( overlay.isNull() )
+    return;
+
+  _types[ overlay->type() ].push_back( overlay );
+  _groups[ overlay->group() ].push_back( overlay );
+}
+
+void OverlayIndex::remove( OverlayPtr overlay )
+{
+  if( overlay.isNull() )
+    return;
+
+  removeFrom( _types, overlay->type(), overlay );
+  removeFrom( _groups, overlay->group(), overlay );
+}
+
+void OverlayIndex::clear()
+{
+  _types.clear();
+  _groups.clear();
+}
+
+const OverlayList& OverlayIndex::byType( object::Type type ) const { return listFrom( _types, type ); }
+const OverlayList& OverlayIndex::byGroup( object::Group group ) const { return listFrom( _groups, group ); }
+
+}//end namespace city
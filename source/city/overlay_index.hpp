@@ -0,0 +1,53 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __CAESARIA_OVERLAY_INDEX_H_INCLUDED__
+#define __CAESARIA_OVERLAY_INDEX_H_INCLUDED__
+
+#include "objects/predefinitions.hpp"
+#include "objects/constants.hpp"
+#include <map>
+
+namespace city
+{
+
+/*
+ * City overlays split by type and by group. Every list keeps
+ * the same relative order as the city overlays list has.
+ */
+class OverlayIndex
+{
+public:
+  OverlayIndex();
+  ~OverlayIndex();
+
+  void add( OverlayPtr overlay );
+  void remove( OverlayPtr overlay );
+  void clear();
+
+  const OverlayList& byType( object::Type type ) const;
+  const OverlayList& byGroup( object::Group group ) const;
+
+private:
+  typedef std::map<object::Type, OverlayList> TypeLists;
+  typedef std::map<object::Group, OverlayList> GroupLists;
+
+  TypeLists _types;
+  GroupLists _groups;
+};
+
+}//end namespace city
+
+#endif //__CAESARIA_OVERLAY_INDEX_H_INCLUDED__
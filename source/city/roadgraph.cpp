@@ -0,0 +1,217 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "roadgraph.hpp"
+#include "city.hpp"
+#include "statistic.hpp"
+#include "gfx/tilemap.hpp"
+#include "gfx/tilemasks.hpp"
+#include "objects/construction.hpp"
+#include <map>
+#include <queue>
+#include <vector>
+
+using namespace gfx;
+
+namespace city
+{
+
+namespace {
+struct Step { int i, j, cost; };
+static const Step steps[] = { {  0,  1, 10 }, {  1,  0, 10 }, {  0, -1, 10 }, { -1,  0, 10 },
+                              {  1,  1, 14 }, {  1, -1, 14 }, { -1, -1, 14 }, { -1,  1, 14 } };
+static const int stepsCount = 8;
+}
+
+struct Field
+{
+  bool actual;
+  unsigned int roadRevision;
+  ConstructionList destinations;
+  std::vector<int> cost;
+  std::vector<int> owner;
+
+  Field() : actual( false ), roadRevision( 0 ) {}
+};
+
+class RoadGraph::Impl
+{
+public:
+  typedef std::map<object::Type, Field> Fields;
+
+  PlayerCity& city;
+  Fields fields;
+
+  Impl( PlayerCity& c ) : city( c ) {}
+
+  Field& field( object::Type type );
+  void compute( Field& field, const TileMasks& masks );
+
+  inline bool isRoad( const TileMasks& masks, int i, int j ) const
+  {
+    return masks.is( i, j, TileMasks::road );
+  }
+
+  // diagonal move allowed only when both side tiles are roads, as in pathfinder
+  inline bool canStep( const TileMasks& masks, int i, int j, const Step& step ) const
+  {
+    if( !isRoad( masks, i + step.i, j + step.j ) )
+      return false;
+
+    if( step.i != 0 && step.j != 0 )
+      return isRoad( masks, i + step.i, j ) && isRoad( masks, i, j + step.j );
+
+    return true;
+  }
+};
+
+RoadGraph::RoadGraph( PlayerCity& city ) : _d( new Impl( city ) ) {}
+
+RoadGraph::~RoadGraph() {}
+
+Field& RoadGraph::Impl::field( object::Type type )
+{
+  Fields::iterator it = fields.find( type );
+  if( it == fields.end() )
+  {
+    it = fields.insert( std::make_pair( type, Field() ) ).first;
+    it->second.destinations = city.statistic().objects.find<Construction>( type );
+  }
+
+  return it->second;
+}
+
+void RoadGraph::Impl::compute( Field& field, const TileMasks& masks )
+{
+  typedef std::pair<int, unsigned int> Node;
+  std::priority_queue<Node, std::vector<Node>, std::greater<Node> > opened;
+
+  const int size = masks.size();
+  field.cost.assign( size * size, unreachable );
+  field.owner.assign( size * size, unreachable );
+
+  int index = 0;
+  for( auto construction : field.destinations )
+  {
+    for( auto tile : construction->roadside() )
+    {
+      if( !isRoad( masks, tile->i(), tile->j() ) )
+        continue;
+
+      unsigned int idx = masks.index( tile->i(), tile->j() );
+      if( field.cost[ idx ] == unreachable )
+      {
+        field.cost[ idx ] = 0;
+        field.owner[ idx ] = index;
+        opened.push( Node( 0, idx ) );
+      }
+    }
+    index++;
+  }
+
+  while( !opened.empty() )
+  {
+    Node current = opened.top();
+    opened.pop();
+
+    if( current.first > field.cost[ current.second ] )
+      continue;
+
+    const int ci = current.second % size;
+    const int cj = current.second / size;
+    for( int k=0; k < stepsCount; k++ )
+    {
+      const Step& step = steps[ k ];
+      if( !canStep( masks, ci, cj, step ) )
+        continue;
+
+      unsigned int nidx = masks.index( ci + step.i, cj + step.j );
+      int cost = current.first + step.cost;
+      if( field.cost[ nidx ] == unreachable || field.cost[ nidx ] > cost )
+      {
+        field.cost[ nidx ] = cost;
+        field.owner[ nidx ] = field.owner[ current.second ];
+        opened.push( Node( cost, nidx ) );
+      }
+    }
+  }
+
+  field.roadRevision = masks.roadRevision();
+  field.actual = true;
+}
+
+const ConstructionList& RoadGraph::destinations( object::Type type )
+{
+  return _d->field( type ).destinations;
+}
+
+ConstructionPtr RoadGraph::nearest( const TilePos& pos, object::Type type, int* distance )
+{
+  const TileMasks& masks = _d->city.tilemap().masks();
+  if( !masks.isInside( pos.i(), pos.j() ) )
+    return ConstructionPtr();
+
+  Field& field = _d->field( type );
+  if( field.destinations.empty() )
+    return ConstructionPtr();
+
+  if( !field.actual || field.roadRevision != masks.roadRevision() )
+    _d->compute( field, masks );
+
+  int bestCost = unreachable;
+  int bestOwner = unreachable;
+  if( _d->isRoad( masks, pos.i(), pos.j() ) )
+  {
+    unsigned int idx = masks.index( pos.i(), pos.j() );
+    bestCost = field.cost[ idx ];
+    bestOwner = field.owner[ idx ];
+  }
+  else
+  {
+    // walker stays out of roads, so enter network from the closest neighbor
+    for( int k=0; k < stepsCount; k++ )
+    {
+      const Step& step = steps[ k ];
+      if( !_d->canStep( masks, pos.i(), pos.j(), step ) )
+        continue;
+
+      unsigned int nidx = masks.index( pos.i() + step.i, pos.j() + step.j );
+      if( field.cost[ nidx ] == unreachable )
+        continue;
+
+      int cost = field.cost[ nidx ] + step.cost;
+      if( bestCost == unreachable || cost < bestCost )
+      {
+        bestCost = cost;
+        bestOwner = field.owner[ nidx ];
+      }
+    }
+  }
+
+  if( distance )
+    *distance = bestCost;
+
+  if( bestOwner == unreachable )
+    return ConstructionPtr();
+
+  ConstructionList::iterator it = field.destinations.begin();
+  std::advance( it, bestOwner );
+  return *it;
+}
+
+void RoadGraph::invalidate( object::Type type ) { _d->fields.erase( type ); }
+void RoadGraph::invalidate() { _d->fields.clear(); }
+
+}//end namespace city
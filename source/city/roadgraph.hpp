@@ -0,0 +1,63 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __CAESARIA_ROADGRAPH_H_INCLUDED__
+#define __CAESARIA_ROADGRAPH_H_INCLUDED__
+
+#include "core/scopedptr.hpp"
+#include "core/position.hpp"
+#include "objects/predefinitions.hpp"
+#include "objects/constants.hpp"
+
+class PlayerCity;
+
+namespace city
+{
+
+/*
+ * Cached distance fields over the road network, one per destination type.
+ * Every road tile keeps the walking cost to the closest building of that
+ * type and which building it is. Field is rebuilt on next request after
+ * roads change or buildings of that type were built or destroyed.
+ */
+class RoadGraph
+{
+public:
+  enum { unreachable=-1 };
+
+  RoadGraph( PlayerCity& city );
+  ~RoadGraph();
+
+  /** Return all buildings of given type */
+  const ConstructionList& destinations( object::Type type );
+
+  /** Return closest by roads building of given type, or null when no one is connected.
+   *  Distance measured as pathfinder does: 10 for straight step, 14 for diagonal one */
+  ConstructionPtr nearest( const TilePos& pos, object::Type type, int* distance=0 );
+
+  /** Drop cached field for given type */
+  void invalidate( object::Type type );
+
+  /** Drop all cached fields */
+  void invalidate();
+
+private:
+  class Impl;
+  ScopedPtr< Impl > _d;
+};
+
+}//end namespace city
+
+#endif //__CAESARIA_ROADGRAPH_H_INCLUDED__
@@ -352,15 +352,7 @@ size_t Statistic::_Workers::available() const
 
 size_t Statistic::_Objects::count(object::Type type) const
 {
-  size_t ret=0;
-  const OverlayList& buildings = _parent.rcity.overlays();
-  for( auto bld : buildings )
-  {
-    if( object::typeOrDefault( bld ) == type )
-      ret++;
-  }
-
-  return ret;
+  return _parent.rcity.overlayIndex().byType( type ).size();
 }
 
 OverlayList Statistic::_Objects::neighbors(OverlayPtr overlay, bool v) const
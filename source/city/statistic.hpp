@@ -33,6 +33,7 @@
 #include "industry.hpp"
 #include "pathway/pathway_helper.hpp"
 #include "city.hpp"
+#include "overlay_index.hpp"
 
 namespace city
 {
@@ -464,14 +465,12 @@ template< class T >
 inline SmartList< T > Statistic::_Objects::find( std::set<object::Type> which ) const
 {
   SmartList< T > ret;
-  auto ovs = _parent.rcity.overlays();
+  const city::OverlayIndex& index = _parent.rcity.overlayIndex();
 
-  for( auto ov : ovs )
+  for( auto type : which )
   {
-    if( which.count( ov->type() ) > 0 )
-    {
+    for( auto ov : index.byType( type ) )
       ret << ov;
-    }
   }
 
   return ret;
@@ -506,11 +505,13 @@ template< class T >
 inline SmartList<T> Statistic::_Objects::find( object::Group group ) const
 {
   SmartList<T> ret;
-  auto buildings = _parent.rcity.overlays();
+  const OverlayList& buildings = group == object::group::any
+                                   ? _parent.rcity.overlays()
+                                   : _parent.rcity.overlayIndex().byGroup( group );
   for( auto item : buildings )
   {
     SmartPtr<T> b = item.as<T>();
-    if( b.isValid() && (b->group() == group || group == object::group::any ) )
+    if( b.isValid() )
     {
       ret.push_back(b);
     }
@@ -523,10 +524,10 @@ template< class T >
 inline SmartList< T > Statistic::_Objects::find( object::TypeSet types ) const
 {
   SmartList< T > ret;
-  auto buildings = _parent.rcity.overlays();
-  for( auto bld : buildings )
+  const city::OverlayIndex& index = _parent.rcity.overlayIndex();
+  for( auto type : types )
   {
-    if( bld.isValid() && types.count( bld->type() ) > 0 )
+    for( auto bld : index.byType( type ) )
       ret.addIfValid( bld.as<T>() );
   }
 
@@ -537,7 +538,7 @@ template< class T >
 inline size_t Statistic::_Objects::count() const
 {
   size_t result = 0;
-  auto buildings = _parent.rcity.overlays();
+  const OverlayList& buildings = _parent.rcity.overlays();
   for( auto bld : buildings )
   {
     if( is_kind_of<T>( bld ) )
@@ -551,12 +552,11 @@ template< class T >
 inline SmartList< T > Statistic::_Objects::find( object::Type type ) const
 {
   SmartList< T > ret;
-  const auto& buildings = _parent.rcity.overlays();
+  const OverlayList& buildings = type == object::any
+                                   ? _parent.rcity.overlays()
+                                   : _parent.rcity.overlayIndex().byType( type );
   for( auto bld : buildings )
-  {
-    if( (object::typeOrDefault(bld) == type) || type == object::any )
-      ret.addIfValid( bld.as<T>() );
-  }
+    ret.addIfValid( bld.as<T>() );
 
   return ret;
 }
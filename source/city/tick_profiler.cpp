@@ -0,0 +1,275 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "tick_profiler.hpp"
+#include "core/format.hpp"
+#include "core/logger.hpp"
+#include "vfs/file.hpp"
+#include "walker/helper.hpp"
+#include "objects/constants.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <vector>
+
+namespace city
+{
+
+namespace {
+static const unsigned int ringSize = 1 << 17;  // power of two, ~3MB of samples
+static const char* stageNames[ TickProfiler::stageCount ] = { "statistic", "walkers", "overlays",
+                                                              "services", "timers", "roads" };
+static const char* categoryNames[ TickProfiler::categoryCount ] = { "stage", "walker", "overlay", "service" };
+
+struct Accum
+{
+  uint64_t duration;
+  unsigned int count;
+};
+
+typedef std::chrono::steady_clock Clock;
+}
+
+class ProfilerData
+{
+public:
+  // single writer ring: city thread reserves slot with one atomic add,
+  // reader takes last min(head,ringSize) samples
+  std::vector<TickProfiler::Sample> ring;
+  std::atomic<uint64_t> head;
+
+  uint64_t totals[ TickProfiler::stageCount ];
+  std::vector<Accum> sums[ TickProfiler::categoryCount ];
+  std::vector<unsigned int> touched[ TickProfiler::categoryCount ];
+
+  std::map<std::string, unsigned int> serviceIds;
+  std::vector<std::string> serviceNames;
+
+  Clock::time_point origin;
+
+  ProfilerData() : head( 0 ), origin( Clock::now() )
+  {
+    for( auto& total : totals )
+      total = 0;
+  }
+
+  static ProfilerData& instance()
+  {
+    static ProfilerData inst;
+    return inst;
+  }
+};
+
+bool TickProfiler::_enabled = false;
+unsigned int TickProfiler::_tick = 0;
+
+TickProfiler::StageScope::StageScope( Stage stage )
+  : _enabled( TickProfiler::enabled() ), _stage( stage ), _start( 0 )
+{
+  if( _enabled )
+    _start = now();
+}
+
+TickProfiler::StageScope::~StageScope() { _close(); }
+
+void TickProfiler::StageScope::next( Stage stage )
+{
+  _close();
+  _stage = stage;
+  if( _enabled )
+    _start = now();
+}
+
+void TickProfiler::StageScope::_close()
+{
+  if( !_enabled )
+    return;
+
+  uint64_t duration = now() - _start;
+  ProfilerData::instance().totals[ _stage ] += duration;
+  record( TickProfiler::stage, _stage, _start, duration );
+}
+
+TickProfiler::Breakdown::Breakdown( Category category )
+  : _enabled( TickProfiler::enabled() ), _category( category ), _start( 0 ), _from( 0 )
+{
+  if( _enabled )
+    _start = now();
+}
+
+TickProfiler::Breakdown::~Breakdown()
+{
+  if( !_enabled )
+    return;
+
+  ProfilerData& d = ProfilerData::instance();
+  std::vector<Accum>& sums = d.sums[ _category ];
+  std::vector<unsigned int>& touched = d.touched[ _category ];
+
+  // measured parts have no own start, put them one by one from
+  // beginning of breakdown so trace viewer nests them into stage
+  uint64_t at = _start;
+  for( auto id : touched )
+  {
+    Accum& accum = sums[ id ];
+    record( _category, id, at, accum.duration, accum.count );
+    at += accum.duration;
+    accum.duration = 0;
+    accum.count = 0;
+  }
+
+  touched.clear();
+}
+
+void TickProfiler::Breakdown::_add( unsigned int id, uint64_t duration )
+{
+  ProfilerData& d = ProfilerData::instance();
+  std::vector<Accum>& sums = d.sums[ _category ];
+  if( id >= sums.size() )
+  {
+    Accum empty = { 0, 0 };
+    sums.resize( id + 1, empty );
+  }
+
+  Accum& accum = sums[ id ];
+  if( accum.count == 0 )
+    d.touched[ _category ].push_back( id );
+
+  accum.duration += duration;
+  accum.count++;
+}
+
+void TickProfiler::setEnabled( bool enabled )
+{
+  ProfilerData& d = ProfilerData::instance();
+  if( enabled && d.ring.empty() )
+    d.ring.resize( ringSize );
+
+  _enabled = enabled;
+  Logger::info( "TickProfiler: {}", enabled ? "enabled" : "disabled" );
+}
+
+uint64_t TickProfiler::now()
+{
+  Clock::duration elapsed = Clock::now() - ProfilerData::instance().origin;
+  return std::chrono::duration_cast<std::chrono::nanoseconds>( elapsed ).count();
+}
+
+void TickProfiler::record( Category category, unsigned int id, uint64_t start,
+                           uint64_t duration, unsigned int count )
+{
+  ProfilerData& d = ProfilerData::instance();
+  if( d.ring.empty() )
+    return;
+
+  uint64_t index = d.head.fetch_add( 1, std::memory_order_relaxed );
+  Sample& sample = d.ring[ index & ( ringSize - 1 ) ];
+  sample.start = start;
+  sample.duration = (uint32_t)std::min<uint64_t>( duration, 0xffffffff );
+  sample.tick = _tick;
+  sample.count = count;
+  sample.category = (uint16_t)category;
+  sample.id = (uint16_t)id;
+}
+
+unsigned int TickProfiler::serviceId( const std::string& name )
+{
+  ProfilerData& d = ProfilerData::instance();
+  auto it = d.serviceIds.find( name );
+  if( it != d.serviceIds.end() )
+    return it->second;
+
+  unsigned int id = d.serviceNames.size();
+  d.serviceNames.push_back( name );
+  d.serviceIds[ name ] = id;
+  return id;
+}
+
+uint64_t TickProfiler::total( Stage stage ) { return ProfilerData::instance().totals[ stage ]; }
+
+std::string TickProfiler::name( Category category, unsigned int id )
+{
+  switch( category )
+  {
+  case stage: return id < stageCount ? stageNames[ id ] : "unknown";
+  case walkerType: return WalkerHelper::getTypename( (walker::Type)id );
+  case overlayType: return object::toString( (object::Type)id );
+  case serviceName:
+  {
+    const std::vector<std::string>& names = ProfilerData::instance().serviceNames;
+    return id < names.size() ? names[ id ] : "unknown";
+  }
+  default: break;
+  }
+
+  return "unknown";
+}
+
+unsigned int TickProfiler::size()
+{
+  uint64_t head = ProfilerData::instance().head.load( std::memory_order_acquire );
+  return (unsigned int)std::min<uint64_t>( head, ringSize );
+}
+
+void TickProfiler::clear()
+{
+  ProfilerData& d = ProfilerData::instance();
+  d.head.store( 0, std::memory_order_release );
+  for( auto& total : d.totals )
+    total = 0;
+}
+
+bool TickProfiler::exportTrace( const vfs::Path& filename )
+{
+  ProfilerData& d = ProfilerData::instance();
+  vfs::NFile file = vfs::NFile::open( filename, vfs::Entity::fmWrite );
+  if( !file.isOpen() )
+  {
+    Logger::warning( "TickProfiler: can't open file " + filename.toString() );
+    return false;
+  }
+
+  uint64_t head = d.head.load( std::memory_order_acquire );
+  uint64_t first = head > ringSize ? head - ringSize : 0;
+
+  std::map<unsigned int, std::string> nameCache[ categoryCount ];
+
+  std::string out = "{\"traceEvents\":[\n";
+  for( uint64_t index=first; index < head; index++ )
+  {
+    const Sample& sample = d.ring[ index & ( ringSize - 1 ) ];
+    unsigned int category = sample.category < categoryCount ? sample.category : stage;
+
+    std::string& name = nameCache[ category ][ sample.id ];
+    if( name.empty() )
+      name = TickProfiler::name( (Category)category, sample.id );
+
+    out += fmt::format( "{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"X\",\"pid\":1,\"tid\":1,"
+                        "\"ts\":{:.3f},\"dur\":{:.3f},\"args\":{{\"tick\":{},\"count\":{}}}}}{}\n",
+                        name, categoryNames[ category ],
+                        sample.start / 1000.0, sample.duration / 1000.0,
+                        sample.tick, sample.count, index + 1 < head ? "," : "" );
+  }
+  out += "],\"displayTimeUnit\":\"ms\"}\n";
+
+  file.write( out );
+  file.flush();
+
+  Logger::info( "TickProfiler: {} samples saved to {}", head - first, filename.toString() );
+  return true;
+}
+
+}//end namespace city
@@ -0,0 +1,116 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __CAESARIA_TICK_PROFILER_H_INCLUDED__
+#define __CAESARIA_TICK_PROFILER_H_INCLUDED__
+
+#include "vfs/path.hpp"
+#include <stdint.h>
+#include <string>
+
+namespace city
+{
+
+/** Timings of city tick: stages of PlayerCity::timeStep and time spent
+ *  by every walker type, overlay type and service inside them.
+ *  Samples are kept in ring buffer and export as chrome://tracing json.
+ *  When disabled every probe costs one branch. */
+class TickProfiler
+{
+public:
+  typedef enum { statistic=0, walkers, overlays, services, timers, roads, stageCount } Stage;
+  typedef enum { stage=0, walkerType, overlayType, serviceName, categoryCount } Category;
+
+  struct Sample
+  {
+    uint64_t start;     // ns from profiler start
+    uint32_t duration;  // ns
+    uint32_t tick;
+    uint32_t count;     // objects summed in sample
+    uint16_t category;
+    uint16_t id;
+  };
+
+  /** Measures stages of one tick one after another */
+  class StageScope
+  {
+  public:
+    StageScope( Stage stage );
+    ~StageScope();
+
+    /** Close current stage and start measure next one */
+    void next( Stage stage );
+
+  private:
+    void _close();
+
+    bool _enabled;
+    Stage _stage;
+    uint64_t _start;
+  };
+
+  /** Sums time of objects by id (type or service) inside stage,
+   *  writes one sample per id when goes out of scope */
+  class Breakdown
+  {
+  public:
+    Breakdown( Category category );
+    ~Breakdown();
+
+    inline bool active() const { return _enabled; }
+    inline void start() { if( _enabled ) _from = now(); }
+    inline void stop( unsigned int id ) { if( _enabled ) _add( id, now() - _from ); }
+
+  private:
+    void _add( unsigned int id, uint64_t duration );
+
+    bool _enabled;
+    Category _category;
+    uint64_t _start;
+    uint64_t _from;
+  };
+
+  static inline bool enabled() { return _enabled; }
+  static void setEnabled( bool enabled );
+
+  /** Mark start of city tick */
+  static inline void beginTick( unsigned int tick ) { _tick = tick; }
+
+  /** Nanoseconds from profiler start */
+  static uint64_t now();
+
+  static void record( Category category, unsigned int id, uint64_t start,
+                      uint64_t duration, unsigned int count=1 );
+
+  /** Small number for service name, valid while program runs */
+  static unsigned int serviceId( const std::string& name );
+
+  /** Total time of stage since last clear, not limited by ring size */
+  static uint64_t total( Stage stage );
+
+  static std::string name( Category category, unsigned int id );
+  static unsigned int size();
+  static void clear();
+
+  static bool exportTrace( const vfs::Path& filename );
+
+private:
+  static bool _enabled;
+  static unsigned int _tick;
+};
+
+}//end namespace city
+
+#endif //__CAESARIA_TICK_PROFILER_H_INCLUDED__
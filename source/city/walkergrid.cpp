@@ -19,37 +19,67 @@
 #include "walker/walker.hpp"
 #include "gfx/tile.hpp"
 #include "core/logger.hpp"
+#include <algorithm>
 
 namespace city
 {
 
 static const WalkerList invalidList = WalkerList();
 
+WalkersGrid::WalkersGrid() : _gsize( 0 ), _generation( 0 ) {}
+
 unsigned int WalkersGrid::_offset( const TilePos& pos )
 {
+  if( pos.i() < 0 || pos.j() < 0 || pos.i() >= _size.width() )
+    return _gsize;
+
   return ( pos.j() * _size.width() + pos.i() );
 }
 
 void WalkersGrid::clear()
 {
-  for( auto& cell : _grid)
-    cell.clear();
+  for( auto& item : _places )
+  {
+    if( item.second < _gsize )
+      _grid[ item.second ].clear();
+  }
+
+  _places.clear();
+  _crowded.clear();
 }
 
-void WalkersGrid::append( WalkerPtr a )
+void WalkersGrid::_place( WalkerPtr a, unsigned int offset )
 {
-  unsigned int offset = _offset( a->pos() );
+  _places[ a.object() ] = offset;
   if( offset < _gsize )
   {
     _grid[ offset ].push_back( a );
+    _markCrowded( offset );
   }
 }
 
+void WalkersGrid::_markCrowded( unsigned int offset )
+{
+  if( _grid[ offset ].size() > 1 && _marks[ offset ] != _generation )
+  {
+    _marks[ offset ] = _generation;
+    _crowded.push_back( offset );
+  }
+}
+
+void WalkersGrid::append( WalkerPtr a )
+{
+  if( _places.count( a.object() ) == 0 )
+    _place( a, _offset( a->pos() ) );
+}
+
 void WalkersGrid::resize( Size size )
 {
+  clear();
   _size = size;
   _gsize = size.area();
-  _grid.resize( _gsize );
+  _grid.assign( _gsize, WalkerList() );
+  _marks.assign( _gsize, 0 );
 }
 
 const Size& WalkersGrid::size() const
@@ -59,19 +89,41 @@ const Size& WalkersGrid::size() const
 
 void WalkersGrid::remove( WalkerPtr a)
 {
-  unsigned int offset = _offset( a->pos() );
-  if( offset < _gsize )
-  {
-    WalkerList& walkers = _grid[ offset ];
-    walkers.remove( a );
-  }
+  Places::iterator it = _places.find( a.object() );
+  if( it == _places.end() )
+    return;
+
+  if( it->second < _gsize )
+    _grid[ it->second ].remove( a );
+
+  _places.erase( it );
 }
 
 void WalkersGrid::update(const WalkerList& walkers)
 {
-  clear();
+  _generation++;
+  _crowded.clear();
+
   for( auto wlk : walkers )
-    append( wlk );
+  {
+    unsigned int offset = _offset( wlk->pos() );
+    Places::iterator it = _places.find( wlk.object() );
+    if( it == _places.end() )
+    {
+      _place( wlk, offset );
+    }
+    else if( it->second != offset )
+    {
+      if( it->second < _gsize )
+        _grid[ it->second ].remove( wlk );
+      _place( wlk, offset );
+    }
+    else if( offset < _gsize )
+    {
+      // walker stays on tile but still moves inside it
+      _markCrowded( offset );
+    }
+  }
 }
 
 bool compare_zvalue(const WalkerPtr& one, const WalkerPtr& two)
@@ -83,13 +135,15 @@ bool compare_zvalue(const WalkerPtr& one, const WalkerPtr& two)
 
 void WalkersGrid::sort()
 {
-  for( auto& cell : _grid )
+  // cells are almost sorted from previous tick, insertion sort is enough
+  for( auto offset : _crowded )
   {
-    if( cell.size() > 1 )
-    {
-      std::sort( cell.begin(), cell.end(), compare_zvalue );
-    }
+    WalkerList& cell = _grid[ offset ];
+    for( auto it = cell.begin(); it != cell.end(); ++it )
+      std::rotate( std::upper_bound( cell.begin(), it, *it, compare_zvalue ), it, it + 1 );
   }
+
+  _crowded.clear();
 }
 
 const WalkerList& WalkersGrid::at( const TilePos& pos)
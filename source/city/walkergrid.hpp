@@ -21,13 +21,20 @@
 #include "walker/predefinitions.hpp"
 #include "core/size.hpp"
 #include <vector>
+#include <unordered_map>
 
 namespace city
 {
 
+/*
+ * Walkers placed by tiles. Walker moves to another cell only when
+ * its tile changes, and only cells with several walkers get sorted.
+ */
 class WalkersGrid
 {
 public:
+  WalkersGrid();
+
   void clear();
 
   void append( WalkerPtr a );
@@ -41,12 +48,19 @@ public:
 
 private:
   unsigned int _offset(const TilePos& pos);
+  void _place( WalkerPtr a, unsigned int offset );
+  void _markCrowded( unsigned int offset );
 
   typedef std::vector< WalkerList > Grid;
+  typedef std::unordered_map< const Walker*, unsigned int > Places;
 
   Size _size;
   unsigned int _gsize;
   Grid _grid;
+  Places _places;                    // cell of every placed walker
+  std::vector<unsigned int> _crowded; // cells which need sorting
+  std::vector<unsigned int> _marks;
+  unsigned int _generation;
 };
 
 }//end namespace city
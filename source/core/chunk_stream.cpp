@@ -0,0 +1,563 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "chunk_stream.hpp"
+#include "core/variant_map.hpp"
+#include "core/variant_list.hpp"
+#include "core/stringarray.hpp"
+#include "core/position.hpp"
+#include "core/size.hpp"
+#include "gfx/tilepos.hpp"
+#include "core/logger.hpp"
+#include "vfs/file.hpp"
+#include <vector>
+
+namespace {
+static const uint32_t magic = chunkTag( 'C', 'C', 'H', 'K' );
+static const unsigned int fileHeaderSize = 8;
+static const unsigned int chunkHeaderSize = 12;
+static const unsigned int flushLimit = 64 * 1024;
+
+enum VariantTag { vNull=0, vFalse, vTrue, vInt, vUInt, vDouble, vString, vList, vMap, vPair, vPairF };
+
+inline void putU16( std::string& out, uint16_t value )
+{
+  out.push_back( (char)( value & 0xff ) );
+  out.push_back( (char)( value >> 8 ) );
+}
+
+inline void putU32( std::string& out, uint32_t value )
+{
+  for( int k=0; k < 4; k++ )
+    out.push_back( (char)( ( value >> ( k * 8 ) ) & 0xff ) );
+}
+
+inline void putVarint( std::string& out, uint64_t value )
+{
+  while( value >= 0x80 )
+  {
+    out.push_back( (char)( ( value & 0x7f ) | 0x80 ) );
+    value >>= 7;
+  }
+  out.push_back( (char)value );
+}
+
+inline uint64_t zigzag( int64_t value ) { return ( (uint64_t)value << 1 ) ^ (uint64_t)( value >> 63 ); }
+inline int64_t unzigzag( uint64_t value ) { return (int64_t)( value >> 1 ) ^ -(int64_t)( value & 1 ); }
+
+inline void putDouble( std::string& out, double value )
+{
+  uint64_t bits;
+  memcpy( &bits, &value, sizeof(bits) );
+  putU32( out, (uint32_t)( bits & 0xffffffff ) );
+  putU32( out, (uint32_t)( bits >> 32 ) );
+}
+
+inline void putString( std::string& out, const std::string& str )
+{
+  putVarint( out, str.size() );
+  out.append( str );
+}
+
+inline uint32_t getU32( const char* data )
+{
+  const unsigned char* u = (const unsigned char*)data;
+  return (uint32_t)u[0] | ((uint32_t)u[1] << 8) | ((uint32_t)u[2] << 16) | ((uint32_t)u[3] << 24);
+}
+
+inline uint16_t getU16( const char* data )
+{
+  const unsigned char* u = (const unsigned char*)data;
+  return (uint16_t)( u[0] | ( u[1] << 8 ) );
+}
+
+// mirrors Json::serialize, so loaders see same values as with text saves
+void putVariant( std::string& out, const Variant& value )
+{
+  if( value.isNull() )
+  {
+    out.push_back( vNull );
+    return;
+  }
+
+  switch( value.type() )
+  {
+  case Variant::List:
+  case Variant::NStringArray:
+  {
+    const VariantList list = value.toList();
+    out.push_back( vList );
+    putVarint( out, list.size() );
+    for( const auto& item : list )
+      putVariant( out, item );
+  }
+  break;
+
+  case Variant::Map:
+  {
+    const VariantMap vmap = value.toMap();
+    out.push_back( vMap );
+    putVarint( out, vmap.size() );
+    for( const auto& item : vmap )
+    {
+      putString( out, item.first );
+      putVariant( out, item.second );
+    }
+  }
+  break;
+
+  case Variant::String:
+  case Variant::NByteArray:
+    out.push_back( vString );
+    putString( out, value.toString() );
+  break;
+
+  case Variant::Double:
+  case Variant::Float:
+    out.push_back( vDouble );
+    putDouble( out, value.toDouble() );
+  break;
+
+  case Variant::NTilePos:
+  {
+    const TilePos& pos = value.toTilePos();
+    out.push_back( vPair );
+    putVarint( out, zigzag( pos.i() ) );
+    putVarint( out, zigzag( pos.j() ) );
+  }
+  break;
+
+  case Variant::NSize:
+  {
+    const Size& size = value.toSize();
+    out.push_back( vPair );
+    putVarint( out, zigzag( size.width() ) );
+    putVarint( out, zigzag( size.height() ) );
+  }
+  break;
+
+  case Variant::NPoint:
+  {
+    const Point& pos = value.toPoint();
+    out.push_back( vPair );
+    putVarint( out, zigzag( pos.x() ) );
+    putVarint( out, zigzag( pos.y() ) );
+  }
+  break;
+
+  case Variant::NPointF:
+  {
+    PointF pos = value.toPointF();
+    out.push_back( vPairF );
+    putDouble( out, pos.x() );
+    putDouble( out, pos.y() );
+  }
+  break;
+
+  case Variant::Bool:
+    out.push_back( value.toBool() ? vTrue : vFalse );
+  break;
+
+  case Variant::ULongLong:
+    out.push_back( vUInt );
+    putVarint( out, value.toULongLong() );
+  break;
+
+  case Variant::Int:
+  case Variant::UInt:
+    out.push_back( vInt );
+    putVarint( out, zigzag( value.toInt() ) );
+  break;
+
+  default:
+    if( value.canConvert( Variant::LongLong ) || value.canConvert( Variant::Long ) )
+    {
+      out.push_back( vInt );
+      putVarint( out, zigzag( value.toLongLong() ) );
+    }
+    else if( value.canConvert( Variant::String ) )
+    {
+      // this will catch Date, DateTime, Url, ...
+      out.push_back( vString );
+      putString( out, value.toString() );
+    }
+    else
+    {
+      out.push_back( vNull );
+    }
+  break;
+  }
+}
+
+}
+
+Chunk::Chunk() : _tag( 0 ), _version( 0 ), _pos( 0 ) {}
+
+Chunk::Chunk( uint32_t tag, unsigned int version, const ByteArray& data )
+  : _tag( tag ), _version( version ), _data( data ), _pos( 0 )
+{
+}
+
+uint32_t Chunk::tag() const { return _tag; }
+unsigned int Chunk::version() const { return _version; }
+unsigned int Chunk::size() const { return _data.size(); }
+bool Chunk::isValid() const { return _tag != 0; }
+bool Chunk::atEnd() const { return _pos >= _data.size(); }
+
+const char* Chunk::read( unsigned int size )
+{
+  if( _pos + size > _data.size() )
+  {
+    _pos = _data.size();
+    return 0;
+  }
+
+  const char* ret = _data.data() + _pos;
+  _pos += size;
+  return ret;
+}
+
+uint32_t Chunk::readU32()
+{
+  const char* data = read( 4 );
+  return data ? getU32( data ) : 0;
+}
+
+int32_t Chunk::readI32() { return (int32_t)readU32(); }
+
+uint64_t Chunk::readVarint()
+{
+  uint64_t ret = 0;
+  for( int shift=0; shift < 64 && _pos < _data.size(); shift += 7 )
+  {
+    unsigned char byte = (unsigned char)_data.data()[ _pos++ ];
+    ret |= (uint64_t)( byte & 0x7f ) << shift;
+    if( !( byte & 0x80 ) )
+      break;
+  }
+
+  return ret;
+}
+
+double Chunk::_readDouble()
+{
+  uint64_t bits = readU32();
+  bits |= (uint64_t)readU32() << 32;
+  double value;
+  memcpy( &value, &bits, sizeof(value) );
+  return value;
+}
+
+std::string Chunk::readString()
+{
+  unsigned int length = (unsigned int)readVarint();
+  const char* data = read( length );
+  return data ? std::string( data, length ) : std::string();
+}
+
+Variant Chunk::readVariant()
+{
+  const char* tag = read( 1 );
+  if( !tag )
+    return Variant();
+
+  switch( *tag )
+  {
+  case vFalse: return Variant( false );
+  case vTrue: return Variant( true );
+
+  case vInt:
+  {
+    int64_t value = unzigzag( readVarint() );
+    if( value >= INT32_MIN && value <= INT32_MAX )
+      return Variant( (int)value );
+    return Variant( (long long)value );
+  }
+
+  case vUInt: return Variant( (unsigned long long)readVarint() );
+
+  case vDouble: return Variant( _readDouble() );
+
+  case vString: return Variant( readString() );
+
+  case vList:
+  {
+    VariantList list;
+    uint64_t count = readVarint();
+    for( uint64_t k=0; k < count && !atEnd(); k++ )
+      list.push_back( readVariant() );
+    return list;
+  }
+
+  case vMap:
+  {
+    VariantMap vmap;
+    uint64_t count = readVarint();
+    for( uint64_t k=0; k < count && !atEnd(); k++ )
+    {
+      std::string key = readString();
+      vmap[ key ] = readVariant();
+    }
+    return vmap;
+  }
+
+  case vPair:
+  {
+    int first = (int)unzigzag( readVarint() );
+    int second = (int)unzigzag( readVarint() );
+    return VariantList( first, second );
+  }
+
+  case vPairF:
+  {
+    double first = _readDouble();
+    double second = _readDouble();
+    return VariantList( first, second );
+  }
+
+  default: break;
+  }
+
+  return Variant();
+}
+
+class ChunkWriter::Impl
+{
+public:
+  vfs::NFile file;
+  std::string buffer;
+  long chunkStart;
+  bool failed;
+
+  // short write or failed seek means disk full or io error,
+  // seek also flushes stdio buffer so delayed errors come here too
+  void put( const void* data, unsigned int size )
+  {
+    if( file.write( data, size ) != (int)size )
+      failed = true;
+  }
+
+  void seek( long pos )
+  {
+    if( !file.seek( pos ) )
+      failed = true;
+  }
+
+  void flush()
+  {
+    if( !buffer.empty() )
+    {
+      put( buffer.data(), buffer.size() );
+      buffer.clear();
+    }
+  }
+
+  void flushIfNeed()
+  {
+    if( buffer.size() >= flushLimit )
+      flush();
+  }
+};
+
+ChunkWriter::ChunkWriter( const vfs::Path& filename, unsigned int format )
+  : _d( new Impl )
+{
+  _d->chunkStart = -1;
+  _d->failed = false;
+  _d->file = vfs::NFile::open( filename, vfs::Entity::fmWrite );
+  if( !_d->file.isOpen() )
+  {
+    Logger::warning( "ChunkWriter: can't open file " + filename.toString() );
+    return;
+  }
+
+  _d->buffer.reserve( flushLimit * 2 );
+  putU32( _d->buffer, magic );
+  putU32( _d->buffer, format );
+}
+
+ChunkWriter::~ChunkWriter()
+{
+  if( _d->file.isOpen() )
+    finish();
+}
+
+bool ChunkWriter::isOpen() const { return _d->file.isOpen(); }
+
+bool ChunkWriter::finish()
+{
+  if( !_d->file.isOpen() )
+    return false;
+
+  if( _d->chunkStart >= 0 )
+    end();
+
+  _d->flush();
+  _d->file.flush();
+  return !_d->failed;
+}
+
+void ChunkWriter::begin( uint32_t tag, unsigned int version )
+{
+  if( _d->chunkStart >= 0 )
+    end();
+
+  _d->flush();
+  _d->chunkStart = _d->file.getPos();
+  putU32( _d->buffer, tag );
+  putU16( _d->buffer, (uint16_t)version );
+  putU16( _d->buffer, 0 );
+  putU32( _d->buffer, 0 );  // patched in end()
+}
+
+void ChunkWriter::end()
+{
+  if( _d->chunkStart < 0 )
+    return;
+
+  _d->flush();
+  long endPos = _d->file.getPos();
+  std::string size;
+  putU32( size, (uint32_t)( endPos - _d->chunkStart - chunkHeaderSize ) );
+
+  _d->seek( _d->chunkStart + chunkHeaderSize - 4 );
+  _d->put( size.data(), size.size() );
+  _d->seek( endPos );
+  _d->chunkStart = -1;
+}
+
+void ChunkWriter::write( const void* data, unsigned int size )
+{
+  if( size >= flushLimit )
+  {
+    // big planes go to file directly
+    _d->flush();
+    _d->put( data, size );
+    return;
+  }
+
+  _d->buffer.append( (const char*)data, size );
+  _d->flushIfNeed();
+}
+
+void ChunkWriter::writeU32( uint32_t value ) { putU32( _d->buffer, value ); _d->flushIfNeed(); }
+void ChunkWriter::writeI32( int32_t value ) { writeU32( (uint32_t)value ); }
+void ChunkWriter::writeVarint( uint64_t value ) { putVarint( _d->buffer, value ); _d->flushIfNeed(); }
+void ChunkWriter::writeString( const std::string& str ) { putString( _d->buffer, str ); _d->flushIfNeed(); }
+void ChunkWriter::writeVariant( const Variant& value ) { putVariant( _d->buffer, value ); _d->flushIfNeed(); }
+long ChunkWriter::size() const { return _d->file.getPos() + _d->buffer.size(); }
+
+class ChunkReader::Impl
+{
+public:
+  struct Entry
+  {
+    uint32_t tag;
+    unsigned int version;
+    long offset;
+    unsigned int size;
+  };
+
+  vfs::NFile file;
+  unsigned int format;
+  std::vector<Entry> entries;
+
+  const Entry* find( uint32_t tag ) const
+  {
+    for( const auto& entry : entries )
+    {
+      if( entry.tag == tag )
+        return &entry;
+    }
+
+    return 0;
+  }
+};
+
+ChunkReader::ChunkReader( const vfs::Path& filename )
+  : _d( new Impl )
+{
+  _d->format = 0;
+  _d->file = vfs::NFile::open( filename );
+  if( !_d->file.isOpen() )
+  {
+    Logger::warning( "ChunkReader: can't open file " + filename.toString() );
+    return;
+  }
+
+  char header[ chunkHeaderSize ];
+  if( _d->file.read( header, fileHeaderSize ) != (int)fileHeaderSize || getU32( header ) != magic )
+  {
+    Logger::warning( "ChunkReader: wrong header in " + filename.toString() );
+    _d->file = vfs::NFile();
+    return;
+  }
+
+  _d->format = getU32( header + 4 );
+
+  // only headers are read here, data stays on disk until asked
+  long fileSize = _d->file.size();
+  long pos = fileHeaderSize;
+  while( pos + (long)chunkHeaderSize <= fileSize )
+  {
+    _d->file.seek( pos );
+    if( _d->file.read( header, chunkHeaderSize ) != (int)chunkHeaderSize )
+      break;
+
+    Impl::Entry entry;
+    entry.tag = getU32( header );
+    entry.version = getU16( header + 4 );
+    entry.size = getU32( header + 8 );
+    entry.offset = pos + chunkHeaderSize;
+
+    if( entry.offset + (long)entry.size > fileSize )
+    {
+      Logger::warning( "ChunkReader: truncated chunk in " + filename.toString() );
+      break;
+    }
+
+    _d->entries.push_back( entry );
+    pos = entry.offset + entry.size;
+  }
+}
+
+ChunkReader::~ChunkReader() {}
+
+bool ChunkReader::isOpen() const { return _d->file.isOpen(); }
+unsigned int ChunkReader::format() const { return _d->format; }
+bool ChunkReader::has( uint32_t tag ) const { return _d->find( tag ) != 0; }
+
+Chunk ChunkReader::read( uint32_t tag ) const
+{
+  const Impl::Entry* entry = _d->find( tag );
+  if( !entry )
+    return Chunk();
+
+  _d->file.seek( entry->offset );
+  ByteArray data = _d->file.read( entry->size );
+  if( data.size() != entry->size )
+    return Chunk();
+
+  return Chunk( entry->tag, entry->version, data );
+}
+
+bool ChunkReader::isChunkFile( const vfs::Path& filename )
+{
+  vfs::NFile file = vfs::NFile::open( filename );
+  char header[ fileHeaderSize ];
+  return file.isOpen()
+         && file.read( header, fileHeaderSize ) == (int)fileHeaderSize
+         && getU32( header ) == magic;
+}
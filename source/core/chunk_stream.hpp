@@ -0,0 +1,121 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __CAESARIA_CHUNK_STREAM_H_INCLUDED__
+#define __CAESARIA_CHUNK_STREAM_H_INCLUDED__
+
+#include "core/bytearray.hpp"
+#include "core/variant.hpp"
+#include "core/scopedptr.hpp"
+#include "vfs/path.hpp"
+#include <stdint.h>
+
+// Binary container made of typed chunks:
+//   file  : magic "CCHK", u32 format, chunk...
+//   chunk : u32 tag, u16 version, u16 reserved, u32 size, data[size]
+// All numbers are little endian. Unknown chunks are skipped by readers.
+
+inline uint32_t chunkTag( char a, char b, char c, char d )
+{
+  return (uint32_t)(unsigned char)a | ((uint32_t)(unsigned char)b << 8)
+         | ((uint32_t)(unsigned char)c << 16) | ((uint32_t)(unsigned char)d << 24);
+}
+
+/** Data of one chunk, values are read one by one in write order */
+class Chunk
+{
+public:
+  Chunk();
+  Chunk( uint32_t tag, unsigned int version, const ByteArray& data );
+
+  uint32_t tag() const;
+  unsigned int version() const;
+  unsigned int size() const;
+
+  bool isValid() const;
+  bool atEnd() const;
+
+  //! pointer to next size bytes or null when chunk is shorter
+  const char* read( unsigned int size );
+
+  uint32_t readU32();
+  int32_t readI32();
+  uint64_t readVarint();
+  std::string readString();
+  Variant readVariant();
+
+private:
+  double _readDouble();
+
+  uint32_t _tag;
+  unsigned int _version;
+  ByteArray _data;
+  unsigned int _pos;
+};
+
+/** Writes chunks straight to file, only small buffer is held in memory.
+    Chunk size is patched in header when chunk ends. */
+class ChunkWriter
+{
+public:
+  ChunkWriter( const vfs::Path& filename, unsigned int format );
+  ~ChunkWriter();
+
+  bool isOpen() const;
+
+  //! closes last chunk and flushes file, false if any write failed
+  bool finish();
+
+  void begin( uint32_t tag, unsigned int version=1 );
+  void end();
+
+  void write( const void* data, unsigned int size );
+  void writeU32( uint32_t value );
+  void writeI32( int32_t value );
+  void writeVarint( uint64_t value );
+  void writeString( const std::string& str );
+
+  //! compact binary form of value, same data as json keeps
+  void writeVariant( const Variant& value );
+
+  //! bytes written to file
+  long size() const;
+
+private:
+  class Impl;
+  ScopedPtr<Impl> _d;
+};
+
+/** Reads chunk table on open, chunk data is loaded only when requested */
+class ChunkReader
+{
+public:
+  ChunkReader( const vfs::Path& filename );
+  ~ChunkReader();
+
+  bool isOpen() const;
+  unsigned int format() const;
+
+  bool has( uint32_t tag ) const;
+  Chunk read( uint32_t tag ) const;
+
+  static bool isChunkFile( const vfs::Path& filename );
+
+private:
+  class Impl;
+  ScopedPtr<Impl> _d;
+};
+
+#endif //__CAESARIA_CHUNK_STREAM_H_INCLUDED__
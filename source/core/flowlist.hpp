@@ -34,6 +34,7 @@ public:
   }
 
   void postpone( SmartPtr<T> overlay ) { _willAdd.push_back(overlay); }
+  const SmartList<T>& postponed() const { return _willAdd; }
 
 private:
   SmartList<T> _willAdd;
@@ -21,298 +21,310 @@
 #include "variant_list.hpp"
 #include "core/format.hpp"
 #include "gfx/tilepos.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
 
 static std::string lastParsedObjectName;
-static std::string sanitizeString( const std::string& str)
+
+namespace {
+
+inline bool isWhitespace( char c ) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+inline bool isNumberChar( char c ) { return ( c >= '0' && c <= '9' ) || c == '+' || c == '-' || c == '.' || c == 'e' || c == 'E'; }
+
+void appendSanitized( std::string& out, const std::string& str )
 {
-  std::string output;
-  output.reserve(str.length());
-  output += "\"";
+  out += '"';
 
-  for (std::string::size_type i = 0; i < str.length(); ++i)
+  // plain runs are copied at once, only special chars go one by one
+  const char* data = str.data();
+  size_t run = 0;
+  for( size_t i = 0; i < str.length(); ++i )
   {
-    switch (str[i])
+    const char* escaped = 0;
+    switch( data[i] )
     {
-    case '\"':              output += "\\\"";              break;
-    //case '/':              output += "\\/";               break;
-    case '\b':             output += "\\b";               break;
-    case '\f':             output += "\\f";               break;
-    case '\n':             output += "\\n";               break;
-    case '\r':             output += "\\r";               break;
-    case '\t':             output += "\\t";               break;
-    case '\\':             output += "\\\\";              break;
-    default:               output += str[i];            break;
+    case '\"': escaped = "\\\""; break;
+    case '\b': escaped = "\\b"; break;
+    case '\f': escaped = "\\f"; break;
+    case '\n': escaped = "\\n"; break;
+    case '\r': escaped = "\\r"; break;
+    case '\t': escaped = "\\t"; break;
+    case '\\': escaped = "\\\\"; break;
+    default: continue;
     }
+
+    out.append( data + run, i - run );
+    out.append( escaped );
+    run = i + 1;
   }
-  output += "\"";
-  return output;
+
+  out.append( data + run, str.length() - run );
+  out += '"';
 }
 
-static std::string join(const StringArray& rlist, const std::string& sep)
+// locale independent enough, json keeps floats in quotes
+void appendFloat( std::string& out, double value )
 {
-  std::string res;
-  for( const auto& it : rlist )
+  char buffer[ 320 ];
+  int length = snprintf( buffer, sizeof(buffer), "%f", value );
+  for( int i=0; i < length; i++ )
   {
-    if(!res.empty())
-    {
-      res.append( sep );
-    }
-    res.append( it );
+    if( buffer[i] == ',' )
+      buffer[i] = '.';
   }
-  return res;
+
+  out.append( buffer, std::max( 0, std::min<int>( length, sizeof(buffer) - 1 ) ) );
 }
 
-/**
- * parse
- */
-Variant Json::parse(const std::string &json)
+void appendPair( std::string& out, int a, int b )
 {
-  bool success = true;
-  return Json::parse(json, success);
+  char buffer[ 32 ];
+  int length = snprintf( buffer, sizeof(buffer), "[ %d, %d ]", a, b );
+  out.append( buffer, std::max( 0, std::min<int>( length, sizeof(buffer) - 1 ) ) );
 }
 
-/**
- * parse
- */
-Variant Json::parse(const std::string& json, bool &success )
+void appendInt( std::string& out, long long value )
 {
-  success = true;
-  //Return an empty Variant if the JSON data is either null or empty
-  if( !json.empty() )
-  {
-    int index = 0;
-    std::string data = json;
-    //We'll start from index 0
+  char buffer[ 32 ];
+  int length = snprintf( buffer, sizeof(buffer), "%lld", value );
+  out.append( buffer, std::max( 0, std::min<int>( length, sizeof(buffer) - 1 ) ) );
+}
 
-    //Parse the first value
-    Variant value = Json::parseValue(data, index, success);
+bool writeValue( std::string& out, const Variant& data, const std::string& tab );
 
-    //Return the parsed value
-    return value;
+bool writeList( std::string& out, const VariantList& list )
+{
+  if( list.empty() )
+  {
+    out += "[]";
+    return true;
   }
-  else
+
+  size_t start = out.size();
+  out += "[ ";
+  bool first = true;
+  for( const auto& item : list )
   {
-    //Return the empty Variant
-    return Variant();
+    if( !first )
+      out += ", ";
+    first = false;
+
+    if( !writeValue( out, item, "" ) )
+    {
+      out.resize( start );
+      return false;
+    }
   }
+  out += " ]";
+  return true;
 }
 
-std::string Json::serialize(const Variant &data, const std::string& tab)
+void writeMap( std::string& out, const VariantMap& vmap, const std::string& tab )
 {
-   bool success = true;
-   return Json::serialize(data, success, tab);
+  if( vmap.empty() )
+  {
+    out += "{}";
+    return;
+  }
+
+  std::string childTab = tab + "  ";
+  out += "{ \n";
+  bool first = true;
+  for( const auto& item : vmap )
+  {
+    if( !first )
+      out += ",\n";
+    first = false;
+
+    out += tab;
+    appendSanitized( out, item.first );
+    out += " : ";
+    if( !writeValue( out, item.second, childTab ) )
+      out += "\"nonSerializableValue\"";
+  }
+
+  out += "\n";
+  out.append( tab, 0, tab.size() > 2 ? tab.size() - 2 : 0 );
+  out += "}";
 }
 
-std::string Json::serialize(const Variant &data, bool &success, const std::string& tab)
+// leaves out untouched when value can't be written
+bool writeValue( std::string& out, const Variant& data, const std::string& tab )
 {
-  std::string str;
-  success = true;
-
   if( data.isNull() ) // invalid or null?
   {
-    return "null";
+    out += "null";
+    return true;
   }
 
   switch( data.type() )
   {
+    // containers are walked in place, toList()/toMap() would copy whole subtree
     case Variant::List:
-    case Variant::NStringArray: // variant is a list?
-    {
-      const VariantList rlist = data.toList();
+      return writeList( out, *static_cast<const VariantList*>( data.constData() ) );
 
-      if( rlist.empty() )
-      {
-        str = "[]";
-      }
-      else
-      {
-        StringArray values;
-        std::string serializedValue;
-        serializedValue.reserve( 512 );
-        for( auto& item : rlist )
-        {
-          serializedValue = serialize( item, "" );
-          if( serializedValue.empty() )
-          {
-              success = false;
-              break;
-          }
-
-          values.push_back( serializedValue );
-        }
+    case Variant::NStringArray:
+      return writeList( out, data.toList() );
 
-        str = "[ " + join( values, ", " ) + " ]";
-      }
-    }
-    break;
-
-    case Variant::Map: // variant is a map?
-    {
-      VariantMap vmap = data.toMap();
-
-      if( vmap.empty() )
-      {
-        str = "{}";
-      }
-      else
-      {
-        str = "{ \n";
-        StringArray pairs;
-        std::string serializedValue;
-        serializedValue.reserve( 512 );
-        for( auto& item : vmap )
-        {
-          serializedValue = serialize( item.second, tab + "  ");
-          if( serializedValue.empty())
-          {
-            pairs.push_back( tab + sanitizeString( item.first ) + std::string( " : \"nonSerializableValue\"" ) );
-            continue;
-          }
-          pairs.push_back( tab + sanitizeString( item.first ) + " : " + serializedValue );
-        }
-        str += join(pairs, ",\n");
-        std::string rtab( tab );
-        rtab.resize( std::max<int>( 0, tab.size() - 2 ) );
-        str += std::string( "\n" ) + rtab + "}";
-      }
-    }
+    case Variant::Map:
+      writeMap( out, *static_cast<const VariantMap*>( data.constData() ), tab );
     break;
 
     case Variant::String:
     case Variant::NByteArray: // a string or a byte array?
-    {
-      str = sanitizeString( data.toString() );
-    }
+      appendSanitized( out, data.toString() );
     break;
 
     case Variant::Double:
-    case Variant::Float: // double?
-    {
-      // TODO: cheap hack - almost locale independent double formatting
-      str = utils::format( 0xff, "\"%f\"", data.toDouble() );
-      str = utils::replace(str, ",", ".");
-      if( str.find(".") == std::string::npos && str.find("e") == std::string::npos )
-      {
-         str += ".0";
-      }
-    }
+    case Variant::Float:
+      out += '"';
+      appendFloat( out, data.toDouble() );
+      out += '"';
     break;
 
     case Variant::NTilePos:
     {
       const TilePos& pos = data.toTilePos();
-      str = utils::format( 0xff, "[ %d, %d ]", pos.i(), pos.j() );
+      appendPair( out, pos.i(), pos.j() );
     }
     break;
 
     case Variant::NSize:
     {
       const Size& size = data.toSize();
-      str = utils::format( 0xff, "[ %d, %d ]", size.width(), size.height() );
+      appendPair( out, size.width(), size.height() );
     }
     break;
 
     case Variant::NPoint:
     {
       const Point& pos = data.toPoint();
-      str = utils::format( 0xff, "[ %d, %d ]", pos.x(), pos.y() );
+      appendPair( out, pos.x(), pos.y() );
     }
     break;
 
     case Variant::NPointF:
     {
       PointF pos = data.toPointF();
-      // TODO: cheap hack - almost locale independent double formatting
-      std::string posX = utils::replace(utils::format( 0xff, "%f", pos.x()), ",", ".");
-      std::string posY = utils::replace(utils::format( 0xff, "%f", pos.y()), ",", ".");
-      str = fmt::format( "[ {0}, {1} ]", posX, posY );
+      out += "[ ";
+      appendFloat( out, pos.x() );
+      out += ", ";
+      appendFloat( out, pos.y() );
+      out += " ]";
     }
     break;
 
     case Variant::Bool: // boolean value?
-    {
-      str = data.toBool() ? "true" : "false";
-    }
+      out += data.toBool() ? "true" : "false";
     break;
 
     case Variant::ULongLong: // large unsigned number?
     {
-      str = utils::format( 0xff, "%u", data.toULongLong() );
+      char buffer[ 32 ];
+      int length = snprintf( buffer, sizeof(buffer), "%llu", data.toULongLong() );
+      out.append( buffer, std::max( 0, std::min<int>( length, sizeof(buffer) - 1 ) ) );
     }
     break;
 
     case Variant::Int: // simple int?
-    {
-      str = utils::format( 0xff, "%d", data.toInt() );
-    }
-    break;
-
     case Variant::UInt:
-    {
-      str = utils::format( 0xff, "%d", data.toInt() );
-    }
+      appendInt( out, data.toInt() );
     break;
 
     default:
-      if ( data.canConvert( Variant::LongLong ) ) // any signed number?
+      if( data.canConvert( Variant::LongLong ) || data.canConvert( Variant::Long ) ) // any signed number?
       {
-        str = utils::i2str( data.toLongLong() );
+        appendInt( out, data.toLongLong() );
       }
-      else if (data.canConvert( Variant::Long ))
-      {
-        str = utils::i2str( data.toLongLong() );
-      }
-      else if (data.canConvert( Variant::String ) ) // can value be converted to string?
+      else if( data.canConvert( Variant::String ) ) // can value be converted to string?
       {
         // this will catch Date, DateTime, Url, ...
-        str = sanitizeString( data.toString() );
+        appendSanitized( out, data.toString() );
       }
       else
       {
-        success = false;
+        return false;
       }
     break;
   }
 
-  return success ? str : std::string();
+  return true;
 }
 
+// Walks buffer once by index, nothing is copied except names and values
+class JsonReader
+{
+public:
+  JsonReader( const char* data, int size ) : json( data ), size( size ), index( 0 ) {}
+
+  Variant parseValue( bool& success );
+
+private:
+  Variant parseObject( bool& success );
+  VariantList parseArray( bool& success );
+  void parseString( bool& success, std::string& str );
+  std::string parseObjectName( bool& success, char limiter=':' );
+  void parseComment( bool& success );
+  Variant parseNumber();
+
+  int nextToken();
+  int lookAhead() { int saveIndex = index; int token = nextToken(); index = saveIndex; return token; }
+
+  void eatWhitespace() { while( index < size && isWhitespace( json[index] ) ) index++; }
+
+  // std::string like access, zero after end of data
+  char at( int i ) const { return i < size ? json[i] : 0; }
+
+  // std::string::substr semantic
+  std::string sub( int pos, int count ) const
+  {
+    pos = math::clamp( pos, 0, size );
+    return std::string( json + pos, std::min( count, size - pos ) );
+  }
+
+  const char* json;
+  int size;
+  int index;
+};
+
 /**
  * parseValue
  */
-Variant Json::parseValue(const std::string &json, int &index, bool &success)
+Variant JsonReader::parseValue( bool& success )
 {
   //Determine what kind of data we should parse by
   //checking out the upcoming token
   bool done = false;
-  while(!done)
+  while( !done )
   {
-    int token = Json::lookAhead(json, index);
+    int token = lookAhead();
     switch( token )
     {
-      case JsonTokenString:      
+      case JsonTokenString:
       {
         std::string str;
-        Json::parseString(json, index, success, str);
-        return Variant(str);
+        parseString( success, str );
+        return Variant( str );
       }
       break;
 
-      case JsonTokenNumber:      return Json::parseNumber(json, index);
+      case JsonTokenNumber: return parseNumber();
 
       case JsonTokenCommentOpen:
-        Json::parseComment(json, index, success);
+        parseComment( success );
       break;
 
       case JsonTokenCurlyOpen:
       case JsonTokenObjectName:
-          return Json::parseObject(json, index, success);
+        return parseObject( success );
+
+      case JsonTokenSquaredOpen: return parseArray( success );
+      case JsonTokenTrue:  nextToken(); return Variant( true );
+      case JsonTokenFalse: nextToken(); return Variant( false );
+      case JsonTokenNull:  nextToken(); return Variant();
 
-      case JsonTokenSquaredOpen: return Json::parseArray(json, index, success);
-      case JsonTokenTrue:  Json::nextToken(json, index); return Variant(true);
-      case JsonTokenFalse: Json::nextToken(json, index); return Variant(false);
-      case JsonTokenNull:  Json::nextToken(json, index); return Variant();
-      case JsonTokenNone:
+      default:
         done = true;
       break;
     }
@@ -320,24 +332,23 @@ Variant Json::parseValue(const std::string &json, int &index, bool &success)
 
   //If there were no tokens, flag the failure and return an empty Variant
   success = false;
-  return Variant( std::string( json.c_str() + index ));
+  return Variant( sub( index, size ) );
 }
 
 /**
  * parseObject
  */
-Variant Json::parseObject(const std::string &json, int &index, bool &success)
+Variant JsonReader::parseObject( bool& success )
 {
   VariantMap rmap;
   //Get rid of the whitespace and increment index
-  Json::nextToken(json, index);
+  nextToken();
 
   //Loop through all of the key/value pairs of the object
-  bool done = false;
-  while(!done)
+  while( true )
   {
     //Get the upcoming token
-    int token = Json::lookAhead(json, index);
+    int token = lookAhead();
 
     switch( token )
     {
@@ -345,52 +356,45 @@ Variant Json::parseObject(const std::string &json, int &index, bool &success)
       {
         success = false;
         bool sc;
-        std::string errText = Json::parseObjectName( json, index, sc ).toString();
-        return Variant( errText );
+        return Variant( parseObjectName( sc ) );
       }
     break;
 
     case JsonTokenComma:
-      {
-        Json::nextToken(json, index);
-      }
+      nextToken();
     break;
 
     case JsonTokenCurlyClose:
-      {
-        Json::nextToken(json, index);
-        return Variant( rmap );
-      }
+      nextToken();
+      return Variant( rmap );
     break;
 
     case JsonTokenCommentOpen:
-      {
-        Json::parseComment(json, index, success);
-      }
+      parseComment( success );
     break;
 
     case JsonTokenObjectName:
       {
-        std::string name = Json::parseObjectName( json, index, success ).toString();
+        std::string name = parseObjectName( success );
         lastParsedObjectName = name;
 
-        if(!success)
+        if( !success )
         {
-          return Variant(name);
+          return Variant( name );
         }
 
-        name = utils::replace( name, " ", "" );
+        name.erase( std::remove( name.begin(), name.end(), ' ' ), name.end() );
 
         index++;
-        Variant value = Json::parseValue(json, index, success);
+        Variant value = parseValue( success );
 
-        if(!success)
+        if( !success )
         {
           return Variant( value.toString() );
         }
 
         //Assign the value to the key in the map
-        rmap[name] = value;
+        rmap[ name ] = value;
       }
     break;
 
@@ -398,82 +402,75 @@ Variant Json::parseObject(const std::string &json, int &index, bool &success)
       {
         //Parse the key/value pair's name
         std::string name;
-        Json::parseString(json, index, success,name);
+        parseString( success, name );
 
-        if(!success)
+        if( !success )
         {
           return Variant();
         }
 
-        //Get the next token
-        token = Json::nextToken(json, index);
-
         //If the next token is not a colon, flag the failure
         //return an empty Variant
-        if(token != JsonTokenColon)
+        if( nextToken() != JsonTokenColon )
         {
           success = false;
           std::string errText = utils::format( 0xff, "Wrong token colon near \"%s\"", name.c_str() );
-          return Variant(errText);
+          return Variant( errText );
         }
 
         //Parse the key/value pair's value
-        Variant value = Json::parseValue(json, index, success);
+        Variant value = parseValue( success );
 
-        if(!success)
+        if( !success )
         {
           return Variant();
         }
 
         //Assign the value to the key in the map
-        rmap[name] = value;
+        rmap[ name ] = value;
       }
     break;
     }
-  } //end while(!done)
-
-  //Return the map successfully
-  return Variant(rmap);
+  }
 }
 
 /**
  * parseArray
  */
-VariantList Json::parseArray(const std::string &json, int &index, bool &success)
+VariantList JsonReader::parseArray( bool& success )
 {
   VariantList list;
 
-  Json::nextToken(json, index);
+  nextToken();
 
-  bool done = false;
-  while(!done)
+  while( true )
   {
-    int token = Json::lookAhead(json, index);
+    int token = lookAhead();
 
-    if(token == JsonTokenNone)
+    if( token == JsonTokenNone )
     {
       success = false;
       return VariantList();
     }
-    else if(token == JsonTokenComma)
+    else if( token == JsonTokenComma )
     {
-      Json::nextToken(json, index);
+      nextToken();
     }
-    else if(token == JsonTokenSquaredClose)
+    else if( token == JsonTokenSquaredClose )
     {
-      Json::nextToken(json, index);
+      nextToken();
       break;
     }
     else
     {
-      Variant value = Json::parseValue(json, index, success);
+      Variant value = parseValue( success );
 
-      if(!success)
+      if( !success )
       {
         return VariantList();
       }
 
-      list.push_back(value);
+      list.push_back( value );
     }
   }
 
@@ -483,25 +480,18 @@ VariantList Json::parseArray(const std::string &json, int &index, bool &success)
 /**
  * parse comment
  */
-void Json::parseComment(const std::string &json, int &index, bool &success)
+void JsonReader::parseComment( bool& success )
 {
   success = false;
-  index+=2;
+  index += 2;
 
-  bool complete = false;
-  while(!complete)
+  while( index < size )
   {
-    if(index == (int)json.size())
-    {
-      break;
-    }
+    char c = json[ index++ ];
 
-    char c = json[index++];
-
-    if(c == '/' && json[ index - 2 ] == '*' )
+    if( c == '/' && json[ index - 2 ] == '*' )
     {
-      complete = true;
-      success = true;;
+      success = true;
       break;
     }
   }
@@ -510,283 +500,269 @@ void Json::parseComment(const std::string &json, int &index, bool &success)
 /**
 * parse object name without colons
 */
-Variant Json::parseObjectName(const std::string &json, int &index, bool &success, char limiter )
+std::string JsonReader::parseObjectName( bool& success, char limiter )
 {
-  std::string s;
-
-  eatWhitespace(json, index);
+  eatWhitespace();
 
+  int start = index;
+  int lastIndex = math::clamp<int>( index + 64, 0, size );
+  int end = lastIndex;
   bool complete = false;
-
-  int lastIndex = math::clamp<int>( index + 64, 0, json.size() );
   for( int i=index; i < lastIndex; i++ )
   {
-    if( json[i+1] != limiter )
-    {
-      s += json[ i ];
-    }
-    else
+    if( at( i+1 ) == limiter )
     {
-      s += json[ i ];
-      index = (i + 1);
+      end = i + 1;
+      index = end;
       complete = true;
       break;
     }
   }
 
-  std::string items("{}[],");
-  for( unsigned int i=0; i < s.size(); i++ )
+  std::string s( json + start, end - start );
+  if( s.find_first_of( "{}[]," ) != std::string::npos )
   {
-    if( items.find( s[i] ) != std::string::npos )
-    {
-      s = json.substr( std::max( 0, index-20 ), lastIndex );
-      complete = false;
-      break;
-    }
+    s = sub( std::max( 0, index-20 ), lastIndex );
+    complete = false;
   }
 
   if( !complete )
   {
     success = false;
-    std::string advText = json.substr( std::max( 0, index - 60), 120 );
-    std::string errText = utils::format( 0xff, "Wrong symbol in object name \"%s\"  at \n %s", s.c_str(), advText.c_str() );
-    return Variant( errText );
+    std::string advText = sub( std::max( 0, index - 60 ), 120 );
+    return utils::format( 0xff, "Wrong symbol in object name \"%s\"  at \n %s", s.c_str(), advText.c_str() );
   }
 
-  return Variant(s);
+  return s;
 }
 
 /**
  * parse string with colons
  */
-void Json::parseString(const std::string &json, int &index, bool &success, std::string& str)
+void JsonReader::parseString( bool& success, std::string& str )
 {
   str.clear();
-        char c;
+  eatWhitespace();
 
-        Json::eatWhitespace(json, index);
+  index++; // opening quote
 
-        c = json[index++];
+  bool complete = false;
+  while( index < size )
+  {
+    int run = index;
+    while( index < size && json[index] != '\"' && json[index] != '\\' )
+      index++;
 
-        bool complete = false;
-        while(!complete)
-        {
-          if(index == (int)json.size())
-          {
-            break;
-          }
-
-          c = json[index++];
-
-          if(c == '\"')
-          {
-            complete = true;
-            break;
-          }
-          else if(c == '\\')
-          {
-            if(index == (int)json.size())
-            {
-              break;
-            }
-
-            c = json[index++];
-
-            switch (c)
-            {
-            case '\"': case '\\': str += c; break;
-            case '/': str.append("/"); break;
-            case 'b': str.append("\b"); break;
-            case 'f': str.append("\f"); break;
-            case 'n': str.append("\n"); break;
-            case 'r': str.append("\r"); break;
-            case 't': str.append("\t"); break;
-
-            case 'u':
-              _GAME_DEBUG_BREAK_IF(true && "yet not work");
-            break;
-            }
-          }
-          else
-          {
-            str += c;
-          }
-        }
+    str.append( json + run, index - run );
+    if( index == size )
+      break;
 
-        if(!complete)
-        {
-                success = false;
-                str.clear();
-        }
+    char c = json[ index++ ];
+    if( c == '\"' )
+    {
+      complete = true;
+      break;
+    }
+
+    if( index == size )
+      break;
+
+    c = json[ index++ ];
+    switch( c )
+    {
+    case '\"': case '\\': str += c; break;
+    case '/': str += '/'; break;
+    case 'b': str += '\b'; break;
+    case 'f': str += '\f'; break;
+    case 'n': str += '\n'; break;
+    case 'r': str += '\r'; break;
+    case 't': str += '\t'; break;
+
+    case 'u':
+      _GAME_DEBUG_BREAK_IF(true && "yet not work");
+    break;
+    }
+  }
+
+  if( !complete )
+  {
+    success = false;
+    str.clear();
+  }
 }
 
 /**
  * parseNumber
  */
-Variant Json::parseNumber(const std::string &json, int &index)
+Variant JsonReader::parseNumber()
 {
-  Json::eatWhitespace(json, index);
-
-  int lastIndex = Json::lastIndexOfNumber(json, index);
-  int charLength = (lastIndex - index) + 1;
-  std::string numberStr;
-
-  numberStr = json.substr( index, charLength );
-
-  index = lastIndex + 1;
-
-  if( numberStr.find('.') != std::string::npos )
+  eatWhitespace();
+
+  int start = index;
+  while( index < size && isNumberChar( json[index] ) )
+    index++;
+
+  // converters want terminated string, numbers fit on stack
+  int length = index - start;
+  char buffer[ 32 ];
+  std::string longNumber;
+  const char* number = buffer;
+  if( length < (int)sizeof(buffer) )
   {
-    return Variant( utils::toFloat( numberStr.c_str() ) );
-  }
-  else if( numberStr[0] == '-' )
-  {
-    return Variant( utils::toInt( numberStr.c_str() ) );
+    memcpy( buffer, json + start, length );
+    buffer[ length ] = 0;
   }
   else
   {
-    return Variant( utils::toUint( numberStr.c_str() ) );
+    longNumber.assign( json + start, length );
+    number = longNumber.c_str();
   }
-}
-
-/**
- * lastIndexOfNumber
- */
-static const std::string digitsTemplateStr("0123456789+-.eE");
-int Json::lastIndexOfNumber(const std::string &json, int index)
-{
-   int lastIndex;
 
-   for( lastIndex = index; lastIndex < (int)json.size(); lastIndex++)
-   {
-     if( digitsTemplateStr.find( json[lastIndex] ) == std::string::npos )
-     {
-             break;
-     }
-   }
-
-   return lastIndex -1;
-}
-
-/**
- * eatWhitespace
- */
-static const std::string whitespaceTemplate(" \t\n\r");
-void Json::eatWhitespace(const std::string &json, int &index)
-{
-  for(; index < (int)json.size(); index++)
+  if( memchr( number, '.', length ) != 0 )
   {
-    if( whitespaceTemplate.find(json[index]) == std::string::npos)
-    {
-      break;
-    }
+    return Variant( utils::toFloat( number ) );
+  }
+  else if( number[0] == '-' )
+  {
+    return Variant( utils::toInt( number ) );
+  }
+  else
+  {
+    return Variant( utils::toUint( number ) );
   }
-}
-
-/**
- * lookAhead
- */
-int Json::lookAhead(const std::string &json, int index)
-{
-  int saveIndex = index;
-  return Json::nextToken(json, saveIndex);
 }
 
 /**
  * nextToken
  */
-int Json::nextToken(const std::string &json, int &index)
+int JsonReader::nextToken()
 {
-  //int saveIndex = index;
-  Json::eatWhitespace(json, index);
+  eatWhitespace();
 
-  if(index == (int)json.size())
+  if( index == size )
   {
      return JsonTokenNone;
   }
 
-  char c = json[index];
+  char c = json[ index ];
   index++;
   switch( c )
   {
-          case '{': return JsonTokenCurlyOpen;
-          case '}': return JsonTokenCurlyClose;
-          case '[': return JsonTokenSquaredOpen;
-          case ']': return JsonTokenSquaredClose;
-          case ',': return JsonTokenComma;
-          case '"': return JsonTokenString;
-          case '0': case '1': case '2': case '3': case '4':
-          case '5': case '6': case '7': case '8': case '9':
-          case '-': return JsonTokenNumber;
-          case ':': return JsonTokenColon;
+    case '{': return JsonTokenCurlyOpen;
+    case '}': return JsonTokenCurlyClose;
+    case '[': return JsonTokenSquaredOpen;
+    case ']': return JsonTokenSquaredClose;
+    case ',': return JsonTokenComma;
+    case '"': return JsonTokenString;
+    case '0': case '1': case '2': case '3': case '4':
+    case '5': case '6': case '7': case '8': case '9':
+    case '-': return JsonTokenNumber;
+    case ':': return JsonTokenColon;
   }
 
   index--;
 
-  int remainingLength = json.size() - index;
+  int remainingLength = size - index;
+  const char* p = json + index;
 
   if( remainingLength > 2 )
   {
-     if( json[index] == '/' && json[index + 1] == '*' )
-     {
-       index += 2;
-       return JsonTokenCommentOpen;
-     }
-
-     if(  json[index] == '*' && json[index + 1] == '/' )
-     {
-       index += 2;
-       return JsonTokenCommentClose;
-     }
+    if( p[0] == '/' && p[1] == '*' )
+    {
+      index += 2;
+      return JsonTokenCommentOpen;
+    }
+
+    if( p[0] == '*' && p[1] == '/' )
+    {
+      index += 2;
+      return JsonTokenCommentClose;
+    }
   }
 
-  //True
-  if(remainingLength >= 4)
+  if( remainingLength >= 4 && !strncmp( p, "true", 4 ) )
   {
-     if( json[index] == 't' && json[index + 1] == 'r' &&
-         json[index + 2] == 'u' && json[index + 3] == 'e')
-     {
-             index += 4;
-             return JsonTokenTrue;
-     }
+    index += 4;
+    return JsonTokenTrue;
   }
 
-  //False
-  if (remainingLength >= 5)
+  if( remainingLength >= 5 && !strncmp( p, "false", 5 ) )
   {
-     if( json[index] == 'f' && json[index + 1] == 'a' &&
-         json[index + 2] == 'l' && json[index + 3] == 's' &&
-         json[index + 4] == 'e')
-     {
-         index += 5;
-         return JsonTokenFalse;
-     }
+    index += 5;
+    return JsonTokenFalse;
   }
 
-  //Null
-  if (remainingLength >= 4)
+  if( remainingLength >= 4 && !strncmp( p, "null", 4 ) )
   {
-     if (json[index] == 'n' && json[index + 1] == 'u' &&
-             json[index + 2] == 'l' && json[index + 3] == 'l')
-     {
-             index += 4;
-             return JsonTokenNull;
-     }
+    index += 4;
+    return JsonTokenNull;
   }
 
   if( remainingLength > 1 )
   {
-    int lastIndex = math::clamp<int>( index + 64, 0, json.size() );
-    for( int i=index+1; i < lastIndex ; i++ )
+    int lastIndex = math::clamp<int>( index + 64, 0, size );
+    if( memchr( json + index + 1, ':', lastIndex - index - 1 ) != 0 )
     {
-      if( json[i] == ':' )
-      {
-        return JsonTokenObjectName;
-      }
+      return JsonTokenObjectName;
     }
   }
 
   return JsonTokenNone;
 }
 
+}
+
+/**
+ * parse
+ */
+Variant Json::parse(const std::string &json)
+{
+  bool success = true;
+  return Json::parse(json, success);
+}
+
+/**
+ * parse
+ */
+Variant Json::parse(const std::string& json, bool &success )
+{
+  return Json::parse( json.data(), json.size(), success );
+}
+
+Variant Json::parse(const char* data, unsigned int size, bool &success)
+{
+  success = true;
+  //Return an empty Variant if the JSON data is either null or empty
+  if( !data || !size )
+    return Variant();
+
+  JsonReader reader( data, size );
+  return reader.parseValue( success );
+}
+
+std::string Json::serialize(const Variant &data, const std::string& tab)
+{
+  bool success = true;
+  return Json::serialize(data, success, tab);
+}
+
+std::string Json::serialize(const Variant &data, bool &success, const std::string& tab)
+{
+  std::string out;
+  success = Json::serialize( data, tab, out );
+  return out;
+}
+
+bool Json::serialize(const Variant &data, const std::string& tab, std::string& out)
+{
+  size_t start = out.size();
+  if( !writeValue( out, data, tab ) )
+  {
+    out.resize( start );
+    return false;
+  }
+
+  return true;
+}
+
 std::string Json::lastParsedObject() { return lastParsedObjectName; }
@@ -47,7 +47,9 @@ enum JsonToken
  * \class Json
  * \brief A JSON data parser
  *
- * Json parses a JSON data into a QVariant hierarchy.
+ * Json parses a JSON data into a Variant hierarchy. Parser works in one
+ * pass over given buffer without copying it, serializer appends to one
+ * output string.
  */
 class Json
 {
@@ -67,6 +69,15 @@ public:
     */
    static Variant parse(const std::string &json, bool &success);
 
+   /**
+    * Parse JSON data in place, buffer need not be null terminated
+    *
+    * \param data The JSON data
+    * \param size Size of data in bytes
+    * \param success The success of the parsing
+    */
+   static Variant parse(const char* data, unsigned int size, bool &success);
+
    /**
    * This method generates a textual JSON representation
    *
@@ -85,107 +96,18 @@ public:
    */
    static std::string serialize(const Variant &data, bool &success, const std::string& tab);
 
-   static std::string lastParsedObject();
-
- private:
-   /**
-    * Parses a value starting from index
-    *
-    * \param json The JSON data
-    * \param index The start index
-    * \param success The success of the parse process
-    *
-    * \return Variant The parsed value
-    */
-   static Variant parseValue(const std::string &json, int &index,
-                                                      bool &success);
-
-   /**
-    * Parses an object starting from index
-    *
-    * \param json The JSON data
-    * \param index The start index
-    * \param success The success of the object parse
-    *
-    * \return Variant The parsed object map
-    */
-   static Variant parseObject(const std::string &json, int &index,
-                                                              bool &success);
-
-   /**
-    * Parses an array starting from index
-    *
-    * \param json The JSON data
-    * \param index The starting index
-    * \param success The success of the array parse
-    *
-    * \return Variant The parsed variant array
-    */
-   static VariantList parseArray(const std::string &json, int &index,
-                                 bool &success);
-
-   /**
-    * Parses a string starting from index
-    *
-    * \param json The JSON data
-    * \param index The starting index
-    * \param success The success of the string parse
-    *
-    * \return QVariant The parsed string
-    */
-   static void parseString(const std::string &json, int &index, bool &success, std::string& str);
-   
-   static Variant parseObjectName(const std::string &json, int &index, bool &success, char limiters=':' );
-
-   static void parseComment(const std::string &json, int &index, bool &success);
-
    /**
-    * Parses a number starting from index
-    *
-    * \param json The JSON data
-    * \param index The starting index
-    *
-    * \return QVariant The parsed number
-    */
-   static Variant parseNumber(const std::string &json, int &index);
-
-   /**
-    * Get the last index of a number starting from index
-    *
-    * \param json The JSON data
-    * \param index The starting index
-    *
-    * \return The last index of the number
-    */
-   static int lastIndexOfNumber(const std::string &json, int index);
-
-   /**
-    * Skip unwanted whitespace symbols starting from index
-    *
-    * \param json The JSON data
-    * \param index The start index
-    */
-   static void eatWhitespace(const std::string &json, int &index);
-
-   /**
-    * Check what token lies ahead
-    *
-    * \param json The JSON data
-    * \param index The starting index
-    *
-    * \return int The upcoming token
-    */
-   static int lookAhead(const std::string &json, int index);
+   * Appends textual JSON representation to out
+   *
+   * \param data The JSON data generated by the parser.
+   * \param tab Indent of nested objects
+   * \param out Output buffer, left unchanged on failure
+   *
+   * \return The success of the serialization
+   */
+   static bool serialize(const Variant &data, const std::string& tab, std::string& out);
 
-   /**
-    * Get the next JSON token
-    *
-    * \param json The JSON data
-    * \param index The starting index
-    *
-    * \return int The next JSON token
-    */
-   static int nextToken(const std::string &json, int &index);
+   static std::string lastParsedObject();
 };
 
 #endif //__CAESARIA_JSON_PARSER_H_INCLUDE__
@@ -46,7 +46,7 @@ VariantMap load (vfs::NFile f)
       return VariantMap();
 
     bool jsonParsingOk;
-    Variant ret = Json::parse( data.toString(), jsonParsingOk);
+    Variant ret = Json::parse( data.data(), data.size(), jsonParsingOk);
     if( jsonParsingOk )
     {
       return ret.toMap();
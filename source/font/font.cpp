@@ -17,6 +17,7 @@
 
 #include "font.hpp"
 #include "font_collection.hpp"
+#include "glyph_cache.hpp"
 #include <GameGfx>
 #include <GameLogger>
 #include <GameCore>
@@ -33,11 +34,31 @@ class Font::Impl
 {
 public:
   TTF_Font *ttfFont = nullptr;
+  GlyphCache* glyphs = nullptr;
   SDL_Color color;
   int size = 0;
   int style = 0;
+
+  // coverage of cached run painted with font color, same pixels as TTF_RenderUTF8_Blended
+  SDL_Surface* createSurface( const GlyphCache::Run& run );
+  std::vector<Uint32> pixels;
 };
 
+SDL_Surface* Font::Impl::createSurface( const GlyphCache::Run& run )
+{
+  int count = run.size.area();
+  if( count <= 0 )
+    return 0;
+
+  Uint32 rgb = (color.r << 16) | (color.g << 8) | color.b;
+  pixels.resize( count );
+  for( int i=0; i < count; i++ )
+    pixels[ i ] = rgb | ( (Uint32)run.coverage[ i ] << 24 );
+
+  return SDL_CreateRGBSurfaceFrom( pixels.data(), run.size.width(), run.size.height(), 32, run.size.width() * 4,
+                                   0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000 );
+}
+
 
 Font::Font() : _d(new Impl)
 {
@@ -70,6 +91,9 @@ Font::Font( const Font& other ) : _d( new Impl )
 
 unsigned int Font::getWidthFromCharacter( unsigned int c ) const
 {
+  if( _d->glyphs )
+    return _d->glyphs->advance( c );
+
   int minx, maxx, miny, maxy, advance;
   TTF_GlyphMetrics( _d->ttfFont, c, &minx, &maxx, &miny, &maxy, &advance );
 
@@ -114,6 +138,10 @@ Size Font::getTextSize( const std::string& text ) const
   int w=0, h=0;
   if( isValid() )
   {
+    Size size;
+    if( _d->glyphs && _d->glyphs->textSize( text, size ) )
+      return size;
+
     TTF_SizeUTF8( _d->ttfFont, text.c_str(), &w, &h );
   }
 
@@ -199,11 +227,13 @@ Font Font::withColor(NColor color)
 void Font::_setHdc(void* ptr)
 {
   _d->ttfFont = (TTF_Font*)ptr;
+  _d->glyphs = nullptr;
 }
 
 void Font::_setStyle(int style)
 {
   _d->style = style;
+  _d->glyphs = GlyphCache::find( _d->ttfFont );
 }
 
 void Font::draw( Picture& dstpic, const std::string &text, const int dx, const int dy, bool useAlpha, bool updatextTx )
@@ -214,7 +244,10 @@ void Font::draw( Picture& dstpic, const std::string &text, const int dx, const i
 #if defined(GAME_PLATFORM_EMSCRIPTEN)
   SDL_Surface* sText = TTF_RenderText_Solid( _d->ttfFont, text.c_str(), _d->color );
 #else
-  SDL_Surface* sText = TTF_RenderUTF8_Blended( _d->ttfFont, text.c_str(), _d->color );
+  const GlyphCache::Run* run = _d->glyphs ? _d->glyphs->render( text ) : 0;
+  SDL_Surface* sText = run
+                         ? _d->createSurface( *run )
+                         : TTF_RenderUTF8_Blended( _d->ttfFont, text.c_str(), _d->color );
 #endif
 
   if( sText )
@@ -229,6 +262,7 @@ void Font::draw( Picture& dstpic, const std::string &text, const int dx, const i
 
     if( !dstpic.surface() ) {
       Logger::warning("Font::draw dstpic surface is null");
+      SDL_FreeSurface( sText );
       return;
     }
 
@@ -259,7 +293,13 @@ void Font::draw(Picture &dstpic, const std::string &text, const Point& pos, bool
 
 Picture Font::once(const std::string &text, bool mayChange)
 {
-  SDL_Surface* textSurface = TTF_RenderUTF8_Blended( _d->ttfFont, text.c_str(), _d->color );
+  const GlyphCache::Run* run = _d->glyphs ? _d->glyphs->render( text ) : 0;
+  SDL_Surface* textSurface = run
+                               ? _d->createSurface( *run )
+                               : TTF_RenderUTF8_Blended( _d->ttfFont, text.c_str(), _d->color );
+  if( !textSurface )
+    return Picture();
+
   Picture ret( Size( textSurface->w, textSurface->h ), (unsigned char*)textSurface->pixels, mayChange );
   SDL_FreeSurface( textSurface );
   ret.update();
@@ -272,6 +312,7 @@ Font::~Font() {}
 Font& Font::operator=( const Font& other )
 {
   _d->ttfFont = other._d->ttfFont;
+  _d->glyphs = other._d->glyphs;
   _d->color = other._d->color;
   return *this;
 }
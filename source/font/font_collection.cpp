@@ -120,9 +120,8 @@ Font FontCollection::_addFont(const std::string& name, vfs::Path pathFont, const
 
   if (bold)
     style |= TTF_STYLE_BOLD;
-  font0._setStyle( style );
-
   TTF_SetFontStyle(ttf, style);
+  font0._setStyle( style );
 
   std::string rname = name;
   if (rname.empty())
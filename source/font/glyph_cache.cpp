@@ -0,0 +1,379 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "glyph_cache.hpp"
+#include "SDL_ttf.h"
+
+#include <algorithm>
+#include <cstring>
+#include <list>
+#include <unordered_map>
+
+namespace {
+enum { atlasWidth=512, directGlyphs=256, runsLimit=256 };
+
+static const Uint16 unknownUnicode = 0xFFFD;
+static const Uint16 bomNative = 0xFEFF;
+static const Uint16 bomSwapped = 0xFFFE;
+
+// mirrors UTF8_getch from SDL_ttf, characters are cut to ucs2 like there
+Uint16 nextChar( const char*& text, size_t& left )
+{
+  const unsigned char* p = (const unsigned char*)text;
+  unsigned int ch = unknownUnicode;
+  size_t tail = 0;
+
+  if( p[0] >= 0xFC ) { if( (p[0] & 0xFE) == 0xFC ) { ch = p[0] & 0x01; tail = 5; } }
+  else if( p[0] >= 0xF8 ) { if( (p[0] & 0xFC) == 0xF8 ) { ch = p[0] & 0x03; tail = 4; } }
+  else if( p[0] >= 0xF0 ) { if( (p[0] & 0xF8) == 0xF0 ) { ch = p[0] & 0x07; tail = 3; } }
+  else if( p[0] >= 0xE0 ) { if( (p[0] & 0xF0) == 0xE0 ) { ch = p[0] & 0x0F; tail = 2; } }
+  else if( p[0] >= 0xC0 ) { if( (p[0] & 0xE0) == 0xC0 ) { ch = p[0] & 0x1F; tail = 1; } }
+  else if( (p[0] & 0x80) == 0 ) { ch = p[0]; }
+
+  text++;
+  left--;
+  while( tail > 0 && left > 0 )
+  {
+    p++;
+    if( (p[0] & 0xC0) != 0x80 )
+      break;
+
+    ch = (ch << 6) | (p[0] & 0x3F);
+    text++;
+    left--;
+    tail--;
+  }
+
+  if( tail > 0 || (ch >= 0xD800 && ch <= 0xDFFF)
+      || ch == 0xFFFE || ch == 0xFFFF || ch > 0x10FFFF )
+    ch = unknownUnicode;
+
+  return (Uint16)ch;
+}
+
+struct Glyph
+{
+  bool loaded;
+  bool rasterized;
+  int minx, maxx, miny, advance;   // metrics with bold overhang, like TTF_GlyphMetrics gives
+  int shift;                       // offset of rasterized box from pen position
+  int x, y, width, height;         // box in atlas, empty for blank glyphs
+
+  Glyph() : loaded(false), rasterized(false),
+            minx(0), maxx(0), miny(0), advance(0),
+            shift(0), x(0), y(0), width(0), height(0) {}
+};
+
+struct Placed
+{
+  Glyph* glyph;
+  Uint16 c;
+  int x;
+};
+
+struct Entry
+{
+  std::string text;
+  GlyphCache::Run run;
+  bool rendered;
+};
+
+typedef std::list<Entry> Entries;
+typedef std::unordered_map<TTF_Font*, GlyphCache*> Caches;
+}
+
+class GlyphCache::Impl
+{
+public:
+  TTF_Font* font;
+  int height;
+  int ascent;
+  bool kerning;
+
+  std::vector<Glyph> direct;                      // latin glyphs without hashing
+  std::unordered_map<Uint16, Glyph> glyphs;
+  std::unordered_map<unsigned int, int> kernings;
+
+  // 8-bit coverage atlas, grows down by shelves
+  std::vector<unsigned char> atlas;
+  struct {
+    int x;
+    int y;
+    int height;
+  } shelf;
+
+  // most recently used runs go first
+  Entries runs;
+  std::unordered_map<std::string, Entries::iterator> runIndex;
+  std::vector<Placed> placed;
+
+  Glyph* glyph( Uint16 c );
+  int kerningOf( Uint16 prev, Uint16 c );
+  bool rasterize( Glyph& g, Uint16 c );
+  bool layout( const std::string& text, Size& size, std::vector<Placed>* positions );
+  Entry* entry( const std::string& text );
+};
+
+Glyph* GlyphCache::Impl::glyph( Uint16 c )
+{
+  Glyph& g = c < directGlyphs ? direct[ c ] : glyphs[ c ];
+  if( !g.loaded )
+  {
+    int maxy;
+    if( TTF_GlyphMetrics( font, c, &g.minx, &g.maxx, &g.miny, &maxy, &g.advance ) < 0 )
+      return 0;
+
+    g.loaded = true;
+  }
+
+  return &g;
+}
+
+int GlyphCache::Impl::kerningOf( Uint16 prev, Uint16 c )
+{
+  if( !kerning )
+    return 0;
+
+  unsigned int key = ( (unsigned int)prev << 16 ) | c;
+  auto it = kernings.find( key );
+  if( it != kernings.end() )
+    return it->second;
+
+  int value = TTF_GetFontKerningSizeGlyphs( font, prev, c );
+  kernings[ key ] = value;
+  return value;
+}
+
+bool GlyphCache::Impl::rasterize( Glyph& g, Uint16 c )
+{
+  // glyph is rendered alone, box starts left from pen when minx is negative
+  g.shift = std::min( g.minx, 0 );
+  g.rasterized = true;
+
+  if( std::max( g.advance, g.maxx ) - g.shift <= 0 )
+    return true;
+
+  SDL_Color white = { 0xff, 0xff, 0xff, 0xff };
+  SDL_Surface* srf = TTF_RenderGlyph_Blended( font, c, white );
+  if( !srf )
+  {
+    g.rasterized = false;
+    return false;
+  }
+
+  int w = srf->w;
+  int h = srf->h;
+  if( shelf.x + w > atlasWidth )
+  {
+    shelf.y += shelf.height;
+    shelf.x = 0;
+    shelf.height = 0;
+  }
+
+  // glyph wider than atlas stays blank, gui fonts never reach it
+  if( w <= atlasWidth )
+  {
+    g.x = shelf.x;
+    g.y = shelf.y;
+    g.width = w;
+    g.height = h;
+
+    atlas.resize( std::max<size_t>( atlas.size(), (size_t)( shelf.y + h ) * atlasWidth ), 0 );
+    for( int y=0; y < h; y++ )
+    {
+      const Uint32* src = (const Uint32*)( (const Uint8*)srf->pixels + y * srf->pitch );
+      unsigned char* dst = &atlas[ ( g.y + y ) * atlasWidth + g.x ];
+      for( int x=0; x < w; x++ )
+        dst[ x ] = src[ x ] >> 24;
+    }
+
+    shelf.x += w;
+    shelf.height = std::max( shelf.height, h );
+  }
+
+  SDL_FreeSurface( srf );
+  return true;
+}
+
+bool GlyphCache::Impl::layout( const std::string& text, Size& size, std::vector<Placed>* positions )
+{
+  const char* p = text.c_str();
+  size_t left = strlen( p );
+
+  int x = 0;
+  int minx = 0;
+  int maxx = 0;
+  int miny = 0;
+  int start = 0;
+  bool first = true;
+  Uint16 prev = 0;
+
+  while( left > 0 )
+  {
+    Uint16 c = nextChar( p, left );
+    if( c == bomNative || c == bomSwapped )
+      continue;
+
+    Glyph* g = glyph( c );
+    if( !g )
+      return false;
+
+    if( !first )
+      x += kerningOf( prev, c );
+
+    // SDL_ttf moves whole line right when first glyph hangs to the left
+    if( first && g->minx < 0 )
+      start = -g->minx;
+    first = false;
+
+    minx = std::min( minx, x + g->minx );
+    maxx = std::max( maxx, x + std::max( g->advance, g->maxx ) );
+    miny = std::min( miny, g->miny );
+
+    if( positions )
+    {
+      Placed item = { g, c, start + x };
+      positions->push_back( item );
+    }
+
+    x += g->advance;
+    prev = c;
+  }
+
+  size = Size( maxx - minx, std::max( height, ascent - miny ) );
+  return true;
+}
+
+Entry* GlyphCache::Impl::entry( const std::string& text )
+{
+  auto it = runIndex.find( text );
+  if( it != runIndex.end() )
+  {
+    runs.splice( runs.begin(), runs, it->second );
+    return &runs.front();
+  }
+
+  Entry item;
+  if( !layout( text, item.run.size, 0 ) )
+    return 0;
+
+  item.text = text;
+  item.rendered = false;
+
+  if( runs.size() >= runsLimit )
+  {
+    runIndex.erase( runs.back().text );
+    runs.pop_back();
+  }
+
+  runs.push_front( item );
+  runIndex[ text ] = runs.begin();
+  return &runs.front();
+}
+
+GlyphCache* GlyphCache::find( TTF_Font* font )
+{
+  static Caches caches;
+
+  if( !font )
+    return 0;
+
+  Caches::iterator it = caches.find( font );
+  if( it != caches.end() )
+    return it->second;
+
+  // underline, strike and outline are drawn by SDL_ttf over whole line
+  GlyphCache* cache = 0;
+  int lineStyles = TTF_STYLE_UNDERLINE | TTF_STYLE_STRIKETHROUGH;
+  if( !( TTF_GetFontStyle( font ) & lineStyles ) && TTF_GetFontOutline( font ) <= 0 )
+    cache = new GlyphCache( font );
+
+  caches[ font ] = cache;
+  return cache;
+}
+
+GlyphCache::GlyphCache( TTF_Font* font ) : _d( new Impl )
+{
+  _d->font = font;
+  _d->height = TTF_FontHeight( font );
+  _d->ascent = TTF_FontAscent( font );
+  _d->kerning = TTF_GetFontKerning( font ) != 0;
+  _d->direct.resize( directGlyphs );
+  _d->shelf.x = _d->shelf.y = _d->shelf.height = 0;
+}
+
+GlyphCache::~GlyphCache() {}
+
+bool GlyphCache::textSize( const std::string& text, Size& size )
+{
+  Entry* item = _d->entry( text );
+  if( !item )
+    return false;
+
+  size = item->run.size;
+  return true;
+}
+
+const GlyphCache::Run* GlyphCache::render( const std::string& text )
+{
+  Entry* item = _d->entry( text );
+  if( !item )
+    return 0;
+
+  if( item->rendered )
+    return &item->run;
+
+  int width = item->run.size.width();
+  int height = item->run.size.height();
+  std::vector<Placed>& placed = _d->placed;
+  placed.clear();
+
+  Size size;
+  _d->layout( text, size, &placed );
+  for( auto& p : placed )
+  {
+    if( !p.glyph->rasterized && !_d->rasterize( *p.glyph, p.c ) )
+      return 0;
+  }
+
+  std::vector<unsigned char>& coverage = item->run.coverage;
+  coverage.assign( width * height, 0 );
+
+  // glyphs may overlap, coverage is or'ed like SDL_ttf does
+  for( auto& p : placed )
+  {
+    const Glyph& g = *p.glyph;
+    int x0 = p.x + g.shift;
+    int from = std::max( 0, -x0 );
+    int to = std::min( g.width, width - x0 );
+    int rows = std::min( g.height, height );
+    for( int y=0; y < rows; y++ )
+    {
+      const unsigned char* src = &_d->atlas[ ( g.y + y ) * atlasWidth + g.x ];
+      unsigned char* dst = &coverage[ y * width ];
+      for( int x=from; x < to; x++ )
+        dst[ x0 + x ] |= src[ x ];
+    }
+  }
+
+  item->rendered = true;
+  return &item->run;
+}
+
+int GlyphCache::advance( unsigned int c )
+{
+  Glyph* g = _d->glyph( (Uint16)c );
+  return g ? g->advance : 0;
+}
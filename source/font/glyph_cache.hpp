@@ -0,0 +1,60 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __CAESARIA_GLYPH_CACHE_H_INCLUDED__
+#define __CAESARIA_GLYPH_CACHE_H_INCLUDED__
+
+#include <string>
+#include <vector>
+#include "core/size.hpp"
+#include "core/scopedptr.hpp"
+
+typedef struct _TTF_Font TTF_Font;
+
+// Glyphs of one ttf font (family, size and style) rasterized once to
+// coverage atlas, with advance and kerning tables for measuring.
+// Laid out strings are kept in small LRU, so labels which redraw same
+// text don't touch freetype at all. Layout follows TTF_RenderUTF8_Blended,
+// so runs are identical to what SDL_ttf draws for the whole string.
+class GlyphCache
+{
+public:
+  struct Run
+  {
+    Size size;
+    std::vector<unsigned char> coverage;  // alpha of text, size.width() * size.height()
+  };
+
+  //! shared cache of font, null when font uses style which glyphs can't reproduce
+  static GlyphCache* find( TTF_Font* font );
+
+  ~GlyphCache();
+
+  //! same size as TTF_SizeUTF8 gives, false when text has glyph which font can't load
+  bool textSize( const std::string& text, Size& size );
+
+  //! run is valid until next call, null when text has glyph which font can't load
+  const Run* render( const std::string& text );
+
+  int advance( unsigned int c );
+
+private:
+  GlyphCache( TTF_Font* font );
+
+  class Impl;
+  ScopedPtr<Impl> _d;
+};
+
+#endif //__CAESARIA_GLYPH_CACHE_H_INCLUDED__
@@ -0,0 +1,121 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "binary_save.hpp"
+#include "core/variant_map.hpp"
+#include "core/logger.hpp"
+#include "core/debug_timer.hpp"
+#include "gfx/tilemap.hpp"
+#include "city/city.hpp"
+#include "world/empire.hpp"
+#include "religion/pantheon.hpp"
+#include "objects/overlay.hpp"
+#include "walker/walker.hpp"
+#include "player.hpp"
+#include "game.hpp"
+#include <vector>
+
+namespace game
+{
+
+namespace binsave
+{
+
+namespace {
+void writeMap( ChunkWriter& writer, uint32_t tag, const VariantMap& vm )
+{
+  writer.begin( tag );
+  writer.writeVariant( vm );
+  writer.end();
+}
+}
+
+bool save( const vfs::Path& filename, const VariantMap& meta, const Game& game )
+{
+  unsigned int startTime = DebugTimer::ticks();
+
+  ChunkWriter writer( filename, format );
+  if( !writer.isOpen() )
+  {
+    Logger::error( "BinarySave: can't open file " + filename.toString() );
+    return false;
+  }
+
+  writeMap( writer, binsave::meta, meta );
+
+  VariantMap vm_player;
+  game.player()->save( vm_player );
+  writeMap( writer, binsave::player, vm_player );
+
+  PlayerCityPtr pcity = game.city();
+
+  // planes go to file as they are in memory, little endian on all our platforms
+  std::vector<int32_t> bitset;
+  std::vector<int16_t> desirability;
+  std::vector<int16_t> imgId;
+  const gfx::Tilemap& tmap = pcity->tilemap();
+  tmap.savePlanes( bitset, desirability, imgId );
+
+  writer.begin( binsave::tilemap );
+  writer.writeI32( tmap.size() );
+  writer.write( bitset.data(), bitset.size() * sizeof(int32_t) );
+  writer.write( desirability.data(), desirability.size() * sizeof(int16_t) );
+  writer.write( imgId.data(), imgId.size() * sizeof(int16_t) );
+  writer.end();
+
+  VariantMap vm_city;
+  pcity->saveState( vm_city );
+  writeMap( writer, binsave::city, vm_city );
+
+  writer.begin( binsave::overlays );
+  for( auto overlay : pcity->overlays() )
+  {
+    VariantMap vm_overlay;
+    if( pcity->saveOverlay( overlay, vm_overlay ) )
+      writer.writeVariant( vm_overlay );
+  }
+  writer.end();
+
+  writer.begin( binsave::walkers );
+  for( auto walker : pcity->walkers() )
+  {
+    VariantMap vm_walker;
+    if( pcity->saveWalker( walker, vm_walker ) )
+      writer.writeVariant( vm_walker );
+  }
+  writer.end();
+
+  VariantMap vm_empire;
+  game.empire()->save( vm_empire );
+  writeMap( writer, binsave::empire, vm_empire );
+
+  VariantMap vm_pantheon;
+  religion::rome::Pantheon::instance().save( vm_pantheon );
+  writeMap( writer, binsave::pantheon, vm_pantheon );
+
+  if( !writer.finish() )
+  {
+    Logger::error( "BinarySave: write failed for " + filename.toString() );
+    return false;
+  }
+
+  Logger::info( "BinarySave: {} bytes saved to {} in {} ms", writer.size(), filename.toString(),
+                DebugTimer::ticks() - startTime );
+  return true;
+}
+
+}//end namespace binsave
+
+}//end namespace game
@@ -0,0 +1,53 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef _CAESARIA_BINARY_SAVE_H_INCLUDE_
+#define _CAESARIA_BINARY_SAVE_H_INCLUDE_
+
+#include "core/chunk_stream.hpp"
+
+class Game;
+class VariantMap;
+
+namespace game
+{
+
+// Binary save: one chunk per subsystem. Tilemap planes are stored raw,
+// overlays and walkers as records one after another, so saver never
+// builds whole city tree and loader decodes chunk only when it needs it.
+namespace binsave
+{
+
+enum { format=1 };
+
+static const char* const extension = ".oc3bin";
+
+static const uint32_t meta     = chunkTag( 'M', 'E', 'T', 'A' );  // version, date, events, restart file
+static const uint32_t player   = chunkTag( 'P', 'L', 'Y', 'R' );
+static const uint32_t empire   = chunkTag( 'E', 'M', 'P', 'R' );
+static const uint32_t pantheon = chunkTag( 'P', 'N', 'T', 'H' );
+static const uint32_t city     = chunkTag( 'C', 'I', 'T', 'Y' );  // city params without objects
+static const uint32_t tilemap  = chunkTag( 'T', 'M', 'A', 'P' );  // size, bitset[], desirability[], imgId[]
+static const uint32_t overlays = chunkTag( 'O', 'V', 'L', 'S' );  // overlay records till chunk end
+static const uint32_t walkers  = chunkTag( 'W', 'L', 'K', 'S' );  // walker records till chunk end
+
+//! meta is filled by Saver, same values as top of json save
+bool save( const vfs::Path& filename, const VariantMap& meta, const Game& game );
+
+}//end namespace binsave
+
+}//end namespace game
+
+#endif //_CAESARIA_BINARY_SAVE_H_INCLUDE_
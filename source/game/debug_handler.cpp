@@ -71,6 +71,7 @@
 #include "core/timer.hpp"
 #include "steam.hpp"
 #include "objects/house_spec.hpp"
+#include "city/tick_profiler.hpp"
 
 using namespace gfx;
 using namespace citylayer;
@@ -168,7 +169,9 @@ enum {
   fill_random_claypit,
   empire_toggle_capua,
   empire_toggle_londinium,
-  reset_steam_prefs
+  reset_steam_prefs,
+  toggle_tick_profiler,
+  export_tick_profile
 };
 
 class DebugHandler::Impl
@@ -246,6 +249,8 @@ void DebugHandler::insertTo( Game* game, gui::MainMenu* menu)
 
   ADD_DEBUG_EVENT( other, send_player_army )
   ADD_DEBUG_EVENT( other, screenshot )
+  ADD_DEBUG_EVENT( other, toggle_tick_profiler )
+  ADD_DEBUG_EVENT( other, export_tick_profile )
 
   ADD_DEBUG_EVENT( disaster, random_fire )
   ADD_DEBUG_EVENT( disaster, random_collapse )
@@ -492,6 +497,31 @@ void DebugHandler::Impl::handleEvent(int event)
   }
   break;
 
+  case toggle_tick_profiler:
+  {
+    bool enable = !city::TickProfiler::enabled();
+    city::TickProfiler::setEnabled( enable );
+    events::dispatch<WarningMessage>( enable ? "DEBUG: Tick profiler enabled" : "DEBUG: Tick profiler disabled",
+                                      events::WarningMessage::neitral );
+  }
+  break;
+
+  case export_tick_profile:
+  {
+    DateTime time = DateTime::currenTime();
+    vfs::Path filename = utils::format( 0xff, "ticks_[%04d_%02d_%02d_%02d_%02d_%02d].json",
+                                        time.year(), time.month(), time.day(),
+                                        time.hour(), time.minutes(), time.seconds() );
+    vfs::Directory saveDir = SETTINGS_STR( savedir );
+    vfs::Path path = saveDir/filename;
+
+    bool saved = city::TickProfiler::exportTrace( path );
+    events::dispatch<WarningMessage>( saved ? "DEBUG: Tick profile saved to " + path.toString()
+                                            : "DEBUG: Can't save tick profile",
+                                      events::WarningMessage::neitral );
+  }
+  break;
+
   case reset_steam_prefs:
     if( steamapi::available() )
     {
@@ -50,6 +50,7 @@
 #include "events/warningmessage.hpp"
 #include "gfx/picture_info_bank.hpp"
 #include "gfx/sdl_engine.hpp"
+#include "gfx/null_engine.hpp"
 #include "objects/overlay.hpp"
 #include "gfx/tilemap_config.hpp"
 #include "gamestate.hpp"
@@ -103,6 +104,7 @@ public:
 
   void initLocale(bool& isOk , std::string& result);
   void initVideo(bool& isOk, std::string& result);
+  void initNullVideo(bool& isOk, std::string& result);
   void initSound(bool& isOk, std::string& result);
   void initPictures(bool& isOk, std::string& result);
   void initHotkeys(bool& isOk, std::string& result);
@@ -172,6 +174,15 @@ void Game::Impl::initVideo(bool& isOk, std::string& result)
   engine->init();
 }
 
+void Game::Impl::initNullVideo(bool& isOk, std::string& result)
+{
+  Logger::debug( "GraficEngine: create headless" );
+
+  engine = new NullEngine();
+  engine->setScreenSize( SETTINGS_VALUE( resolution ) );
+  engine->init();
+}
+
 void Game::Impl::initSound(bool& isOk, std::string& result)
 {
   Logger::debug( "init sound engine" );
@@ -302,7 +313,11 @@ void Game::save(std::string filename) const
 {
   game::Saver saver;
   saver.setRestartFile( _dfunc()->restartFile );
-  saver.save( filename, *this );
+  if( !saver.save( filename, *this ) )
+  {
+    events::dispatch<WarningMessage>( "Can't save game to " + vfs::Path( filename ).baseName().removeExtension(), WarningMessage::negative );
+    return;
+  }
 
   SETTINGS_SET_VALUE( lastGame, Variant( filename ) );
 
@@ -399,7 +414,7 @@ void Game::Impl::initArchiveLoaders(bool& isOk, std::string& result)
   fs.addArchiveLoader(new vfs::ZipArchiveLoader(&fs));
 }
 
-void Game::initialize()
+void Game::initialize(bool headless)
 {
   __D_REF(d, Game)
   #define ADD_STEP(obj,functor) { #functor, makeDelegate(obj,&functor) }
@@ -416,6 +431,22 @@ void Game::initialize()
     ADD_STEP( &d, Impl::initHotkeys ),
     ADD_STEP( &d, Impl::createSaveDir ),
   };
+
+  if( headless )
+  {
+    //no window, no sound and no input, gui lives only for scripts
+    steps = {
+      ADD_STEP( &d, Impl::initTilemapSettings ),
+      ADD_STEP( &d, Impl::initVfsSettings ),
+      ADD_STEP( &d, Impl::initMetrics ),
+      ADD_STEP( &d, Impl::initArchiveLoaders ),
+      ADD_STEP( &d, Impl::initLocale ),
+      ADD_STEP( &d, Impl::initNullVideo ),
+      ADD_STEP( &d, Impl::initFontCollection ),
+      ADD_STEP( &d, Impl::initUI ),
+      ADD_STEP( &d, Impl::createSaveDir ),
+    };
+  }
   #undef ADD_STEP
 
   for (auto& step : steps)
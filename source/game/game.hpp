@@ -51,7 +51,7 @@ public:
   void save(std::string filename) const;
   bool load(std::string filename);
 
-  void initialize();
+  void initialize(bool headless=false);
 
   bool exec();
 
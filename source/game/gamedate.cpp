@@ -16,12 +16,30 @@
 // Copyright 2012-2014 Dalerank, dalerankn8@gmail.com
 
 #include "gamedate.hpp"
+#include "settings.hpp"
+#include <algorithm>
 
 namespace game
 {
 
 namespace {
   unsigned int tickInDay = 25;
+  // shortest week and month, so every phase falls into each period once
+  unsigned int minWeekTicks = DateTime::daysInWeek * 25;
+  unsigned int minMonthTicks = DateTime::weekInMonth * DateTime::daysInWeek * 25;
+
+  unsigned int daysFromWeekStart( DateTime date )
+  {
+    unsigned int days = 0;
+    // longest week is tail of month plus first week of next one
+    while( date.day() % DateTime::daysInWeek != 0 && days < DateTime::daysInWeek * 2 )
+    {
+      date.appendDay( -1 );
+      days++;
+    }
+
+    return days;
+  }
 }
 
 unsigned int Date::days2ticks(unsigned int days)
@@ -36,7 +54,8 @@ void Date::timeStep( unsigned int time )
   _monthChange = false;
   _yearChange = false;
 
-  if( time % tickInDay == 0 )
+  _dayTick = time % tickInDay;
+  if( _dayTick == 0 )
   {
     DateTime save = _current;
     _current.appendDay();
@@ -45,17 +64,56 @@ void Date::timeStep( unsigned int time )
     _weekChange = (_current.day() % DateTime::daysInWeek) == 0;
     _monthChange = (save.month() != _current.month());
     _yearChange = (save.year() != _current.year());
+
+    _weekDay = _weekChange ? 0 : _weekDay+1;
+    _monthDay = _monthChange ? 0 : _monthDay+1;
   }  
 }
 
+bool Date::isWeekPhase( unsigned int phase )
+{
+  const Date& d = instance();
+  if( !d._phased )
+    return d._weekChange;
+
+  return d._weekDay * tickInDay + d._dayTick == phase % minWeekTicks;
+}
+
+bool Date::isMonthPhase( unsigned int phase )
+{
+  const Date& d = instance();
+  if( !d._phased )
+    return d._monthChange;
+
+  return d._monthDay * tickInDay + d._dayTick == phase % minMonthTicks;
+}
+
+unsigned int Date::phaseOf( unsigned int key )
+{
+  // neighbour tiles and similar names must not get near phases
+  key ^= key >> 16;
+  key *= 0x45d9f3b;
+  key ^= key >> 16;
+  return key;
+}
+
 void Date::init( const DateTime& date )
 {
   _current = date;
+  _phased = SETTINGS_VALUE( phasedUpdates );
+  _dayTick = 0;
+  _weekDay = daysFromWeekStart( date );
+  _monthDay = std::max( date.day(), (unsigned char)1 ) - 1;
 }
 
 Date::Date()
 {
   _current = DateTime( -350, 0, 0 );
+  _dayChange = _weekChange = _monthChange = _yearChange = false;
+  _phased = true;
+  _dayTick = 0;
+  _weekDay = 0;
+  _monthDay = 0;
 }
 
 }// end namespace game
@@ -39,6 +39,15 @@ public:
   static inline bool isMonthChanged() { return instance()._monthChange; }
   static inline bool isYearChanged() { return instance()._yearChange; }
 
+  //! true once per week/month on tick given by phase, so periodic work of many
+  //! objects is spread over period instead of running on calendar boundary.
+  //! When phased updates are disabled, it is same as isWeekChanged/isMonthChanged
+  static bool isWeekPhase( unsigned int phase );
+  static bool isMonthPhase( unsigned int phase );
+
+  //! stable phase from object key, like tile position hash or service name hash
+  static unsigned int phaseOf( unsigned int key );
+
   static unsigned int days2ticks( unsigned int days );
 
 private:
@@ -51,6 +60,12 @@ private:
   bool _weekChange;
   bool _monthChange;
   bool _yearChange;
+
+  //position in current week and month, weeks start on days 7,14,21,28
+  bool _phased;
+  unsigned int _dayTick;
+  unsigned int _weekDay;
+  unsigned int _monthDay;
 };
 
 }//end namespace game
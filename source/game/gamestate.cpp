@@ -329,6 +329,8 @@ void InSplash::mountArchives(ResourceLoader &loader)
     }
 
     loader.loadFromModel(SETTINGS_RC_PATH(sg2model), gfxDir);
+    if (game::Settings::get("no-atlas-cache").isNull())
+      loader.useAtlasCache(SETTINGS_STR(cacheDir));
     _game->engine()->setFlag( Engine::batching, false );
   }
   else
@@ -21,6 +21,7 @@
 #include "loader_map.hpp"
 #include "loader_sav.hpp"
 #include "loader_oc3save.hpp"
+#include "loader_binary.hpp"
 #include "loader_mission.hpp"
 #include "loader_omap.hpp"
 #include "core/position.hpp"
@@ -164,11 +165,11 @@ bool Loader::Impl::maySetSign(const Tile &tile)
 void Loader::Impl::clearTile(Tile& tile)
 {
   int startOffset  = ( (math::random( 10 ) > 6) ? 62 : 232 );
-  int imgId = math::random( 58 );
+  // land1a_N has image id 244+N
+  unsigned int imgId = 244 + startOffset + math::random( 58 );
 
-  Picture pic( config::rc.land1a, startOffset + imgId );
-  tile.setPicture( config::rc.land1a, startOffset + imgId );
-  tile.setImgId( imgid::fromResource( pic.name() ) );
+  tile.setPicture( imgid::toPictureId( imgId ) );
+  tile.setImgId( imgId );
 }
 
 void Loader::Impl::initLoaders()
@@ -176,6 +177,7 @@ void Loader::Impl::initLoaders()
   loaders.push_back( new loader::C3Map() );
   loaders.push_back( new loader::C3Sav() );
   loaders.push_back( new loader::OC3() );
+  loaders.push_back( new loader::Binary() );
   loaders.push_back( new loader::Mission() );
   loaders.push_back( new loader::OMap() );
 }
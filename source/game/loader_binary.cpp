@@ -0,0 +1,160 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "loader_binary.hpp"
+#include "binary_save.hpp"
+#include "core/variant_map.hpp"
+#include "core/locale.hpp"
+#include "core/logger.hpp"
+#include "gfx/tilemap.hpp"
+#include "city/city.hpp"
+#include "world/empire.hpp"
+#include "religion/pantheon.hpp"
+#include "events/dispatcher.hpp"
+#include "gamedate.hpp"
+#include "settings.hpp"
+#include "player.hpp"
+#include "saver.hpp"
+#include "game.hpp"
+#include <vector>
+
+namespace game
+{
+
+namespace loader
+{
+
+class Binary::Impl
+{
+public:
+  std::string restartFile;
+
+  bool loadTilemap( const ChunkReader& reader, gfx::Tilemap& tmap );
+  void loadCity( const ChunkReader& reader, PlayerCityPtr pcity );
+};
+
+bool Binary::Impl::loadTilemap( const ChunkReader& reader, gfx::Tilemap& tmap )
+{
+  Chunk chunk = reader.read( binsave::tilemap );
+  int size = chunk.readI32();
+  unsigned int count = size > 0 ? size * size : 0;
+
+  const char* bitsetData = chunk.read( count * sizeof(int32_t) );
+  const char* desData = chunk.read( count * sizeof(int16_t) );
+  const char* imgIdData = chunk.read( count * sizeof(int16_t) );
+  if( !count || !bitsetData || !desData || !imgIdData )
+  {
+    Logger::warning( "!!! BinaryLoader: wrong tilemap chunk, size {}", size );
+    return false;
+  }
+
+  // chunk data has no alignment guarantee
+  std::vector<int32_t> bitset( count );
+  std::vector<int16_t> desirability( count );
+  std::vector<int16_t> imgId( count );
+  memcpy( bitset.data(), bitsetData, count * sizeof(int32_t) );
+  memcpy( desirability.data(), desData, count * sizeof(int16_t) );
+  memcpy( imgId.data(), imgIdData, count * sizeof(int16_t) );
+
+  tmap.loadPlanes( size, bitset.data(), desirability.data(), imgId.data() );
+  return true;
+}
+
+void Binary::Impl::loadCity( const ChunkReader& reader, PlayerCityPtr pcity )
+{
+  VariantMap state = reader.read( binsave::city ).readVariant().toMap();
+  pcity->loadState( state );
+
+  // records are decoded one at a time, no map of all objects is built
+  Chunk overlays = reader.read( binsave::overlays );
+  while( !overlays.atEnd() )
+  {
+    if( !pcity->loadOverlay( overlays.readVariant().toMap() ) )
+      Logger::warning( "BinaryLoader: can't load overlay" );
+  }
+
+  Chunk walkers = reader.read( binsave::walkers );
+  while( !walkers.atEnd() )
+  {
+    if( !pcity->loadWalker( walkers.readVariant().toMap() ) )
+      Logger::warning( "BinaryLoader: can't load walker" );
+  }
+
+  pcity->finishLoad( state );
+}
+
+bool Binary::load(const std::string& filename, Game& game)
+{
+  Logger::debug( "BinaryLoader: start loading from " + filename );
+  ChunkReader reader( filename );
+  if( !reader.isOpen() )
+    return false;
+
+  if( reader.format() != binsave::format )
+  {
+    Logger::debug( "BinaryLoader: unsupported format {0}", reader.format() );
+    return false;
+  }
+
+  VariantMap vm = reader.read( binsave::meta ).readVariant().toMap();
+  _d->restartFile = vm[ SaverOptions::restartFile ].toString();
+
+  VariantMap scenario_vm = vm[ "scenario" ].toMap();
+  game.setTimeMultiplier( (int)vm[ "timemultiplier"] );
+
+  game::Date::instance().init( scenario_vm[ "date" ].toDateTime() );
+  events::Dispatcher::instance().load( scenario_vm[ "events" ].toMap() );
+
+  Variant lastTr = scenario_vm[ "translation" ];
+  Locale::addTranslation( lastTr.toString() );
+  SETTINGS_SET_VALUE( lastTranslation, lastTr );
+
+  game.player()->load( reader.read( binsave::player ).readVariant().toMap() );
+
+  if( !_d->loadTilemap( reader, game.city()->tilemap() ) )
+    return false;
+
+  _d->loadCity( reader, game.city() );
+
+  game.empire()->load( reader.read( binsave::empire ).readVariant().toMap() );
+  religion::rome::Pantheon::instance().load( reader.read( binsave::pantheon ).readVariant().toMap() );
+
+  return true;
+}
+
+int Binary::climateType(const std::string& filename)
+{
+  // only meta chunk is read
+  ChunkReader reader( filename );
+  VariantMap vm = reader.read( binsave::meta ).readVariant().toMap();
+  Variant climate = vm[ "scenario" ].toMap().get( "climate" );
+  return climate.isNull() ? -1 : climate.toInt();
+}
+
+bool Binary::isLoadableFileExtension(const std::string& filename)
+{
+  return vfs::Path( filename ).isMyExtension( binsave::extension );
+}
+
+std::string Binary::restartFile() const { return _d->restartFile; }
+
+Binary::Binary() : _d( new Impl )
+{
+
+}
+
+}//end namespace loader
+
+}//end namespace game
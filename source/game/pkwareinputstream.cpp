@@ -50,67 +50,206 @@ SOFTWARE.
 
 using namespace std;
 
+namespace {
+
+enum { lengthBits=7, offsetBits=8, eofLength=519, scratchSize=256 };
+
+/**
+* Bits of table index, read in the same order as from stream
+*/
+struct Pattern {
+	unsigned int bits;
+	int used;
+	
+	Pattern(unsigned int bits) : bits(bits), used(0) {}
+	
+	int readBits(int length) {
+		int result = (bits >> used) & ((1 << length) - 1);
+		used += length;
+		return result;
+	}
+	
+	int readBit() {
+		return readBits(1);
+	}
+};
+
 /**
-* Dictionary for keeping track of past read bytes
+* Reverse the bits in `number', essentially converting it from little
+* endian to big endian or vice versa.
 */
-class PKDictionary {
-	public:
-		/**
-		* Creates a new dictionary of size `size'
-		*/
-		PKDictionary(int size) {
-			dictionary = new unsigned char[size];
-			this->size = size;
-			this->first = -1;
+int reverse(int number, int length) {
+	int result = 0;
+	for (int i = 0; i < length; i++) {
+		if (0 != (number & (1 << i))) {
+			result |= (1 << (length - 1 - i));
 		}
-		
-		~PKDictionary() {
-			delete[] dictionary;
+	}
+	return result;
+}
+
+/**
+* Prefix of copy length: returns base value, extra bits are read
+* verbatim after the prefix
+*/
+int copyLength(Pattern &p, int &extra) {
+	extra = 0;
+	int bits = p.readBits(2);
+	if (bits == 3) { // 11
+		return 3;
+	} else if (bits == 1) { // 10x
+		return 4 - 2 * p.readBit();
+	} else if (bits == 2) { // 01
+		if (p.readBit() == 1) { // 011
+			return 5;
 		}
-		
-		/**
-		* Returns the byte at the specified position.
-		* Also does a PUT for this byte since the compression
-		* algorithm requires it
-		*/
-		unsigned char get(int position) {
-			int index = (size + first - position) % size;
-			put(dictionary[index]);
-			return dictionary[index];
+		return 7 - p.readBit(); // 010x
+	}
+	
+	bits = p.readBits(2);
+	if (bits == 3) { // 0011
+		return 8;
+	} else if (bits == 1) { // 0010
+		if (p.readBit() == 1) { // 00101
+			return 9;
 		}
-		
-		/**
-		* Adds a byte to the dictionary
-		*/
-		void put(unsigned char b) {
-			first = (first + 1) % size;
-			dictionary[first] = b;
+		return 10 + p.readBit(); // 00100x
+	} else if (bits == 2) { // 0001
+		if (p.readBit() == 1) { // 00011xx
+			extra = 2;
+			return 12;
 		}
+		extra = 3; // 00010xxx
+		return 16;
+	}
 	
-	private:
-		int size;
-		int first;
-		unsigned char *dictionary;
+	bits = p.readBits(2);
+	if (bits == 3) { // 000011xxxx
+		extra = 4;
+		return 24;
+	} else if (bits == 1) { // 000010xxxxx
+		extra = 5;
+		return 40;
+	} else if (bits == 2) { // 000001xxxxxx
+		extra = 6;
+		return 72;
+	} else if (p.readBit() == 1) { // 0000001xxxxxxx
+		extra = 7;
+		return 136;
+	}
+	extra = 8; // 0000000xxxxxxxx
+	return 264;
+}
+
+/**
+* Gets the "high" value of the copy offset, the lower N bits
+* are stored verbatim; N depends on the copy length and the
+* dictionary size.
+*/
+int copyOffsetHigh(Pattern &p) {
+	int bits = p.readBits(2);
+	if (bits == 3) { // 11
+		return 0;
+	} else if (bits == 1) { // 10
+		bits = p.readBits(2);
+		if (bits == 3) { // 1011
+			return 0x1;
+		} else if (bits == 1) { // 1010
+			return 0x2;
+		} else if (bits == 2) { // 1001x
+			return 0x4 - p.readBit();
+		}
+		return 0x6 - p.readBit(); // 1000x
+	} else if (bits == 2) { // 01
+		bits = p.readBits(4);
+		if (bits == 0) {
+			return 0x17 - p.readBit();
+		}
+		return 0x16 - reverse(bits, 4);
+	}
+	
+	bits = p.readBits(2); // 00
+	if (bits == 3) {
+		return 0x1f - reverse(p.readBits(3), 3);
+	} else if (bits == 1) {
+		return 0x27 - reverse(p.readBits(3), 3);
+	} else if (bits == 2) {
+		return 0x2f - reverse(p.readBits(3), 3);
+	}
+	return 0x3f - reverse(p.readBits(4), 4);
+}
+
+/**
+* Decoded prefix code: value, number of bits it takes in stream and
+* number of verbatim bits which follow it
+*/
+struct Code {
+	unsigned short value;
+	unsigned char length;
+	unsigned char extra;
+};
+
+/**
+* Lookup tables indexed by next bits of stream, built once from
+* the decoding trees above
+*/
+struct Tables {
+	Code lengths[1 << lengthBits];
+	Code offsets[1 << offsetBits];
+	
+	Tables() {
+		for (int i = 0; i < (1 << lengthBits); i++) {
+			Pattern p(i);
+			int extra;
+			lengths[i].value = copyLength(p, extra);
+			lengths[i].length = p.used;
+			lengths[i].extra = extra;
+		}
+		
+		for (int i = 0; i < (1 << offsetBits); i++) {
+			Pattern p(i);
+			offsets[i].value = copyOffsetHigh(p);
+			offsets[i].length = p.used;
+			offsets[i].extra = 0;
+		}
+	}
 };
 
+const Tables& tables() {
+	static Tables instance;
+	return instance;
+}
+
+}
+
 PKWareInputStream::PKWareInputStream(string filename, int file_length) {
 	ifstream *i = new ifstream();
 	i->open(filename.c_str(), ios::in|ios::binary);
 	if (!i->is_open()) {
+		delete i;
 		input = NULL;
 		throw PKException("File not readable");
 	}
 	input = i;
 	this->close_stream = true;
-	this->file_length = file_length;
-	init();
+	try {
+		init(NULL, file_length);
+	} catch (PKException&) {
+		delete input;
+		throw;
+	}
 }
 
 PKWareInputStream::PKWareInputStream(istream *i, bool close_stream, int file_length) {
 	input = i;
 	this->close_stream = close_stream;
-	this->file_length = file_length;
-	init();
+	init(NULL, file_length);
+}
+
+PKWareInputStream::PKWareInputStream(const char *data, int length) {
+	input = NULL;
+	close_stream = false;
+	init(data, length);
 }
 
 PKWareInputStream::~PKWareInputStream() {
@@ -120,77 +259,15 @@ PKWareInputStream::~PKWareInputStream() {
 }
 
 unsigned char PKWareInputStream::read() {
-	if (read_copying) {
-		//cout << "Copying bytes from offset " << read_offset << "; " << read_length << " bytes left" << endl;
-		read_length--;
-		if (read_length <= 0) {
-			read_copying = false;
-		}
-		unsigned char b = dictionary->get(read_offset);
-		return b;
-	} else {
-		if (readBit() == 0) {
-			// Copy byte verbatim
-			int result = readBits(8);
-			dictionary->put((unsigned char)result);
-			//cout << "Reading verbatim byte: " << result << endl;
-			return (unsigned char)result;
-		}
-		// Needs to copy stuff from the dictionary
-		read_length = getCopyLength();
-		if (read_length >= 519) {
-			//cout << "519 read: end of file" << endl;
-			throw PKException("EOF");
-		}
-		
-		read_offset = getCopyOffset(read_length);
-		//cout << "Copying " << read_length << " bytes from offset " << read_offset << endl;
-		unsigned char b = dictionary->get(read_offset);
-		read_length--;
-		read_copying = true;
-		return b;
+	unsigned char b;
+	if (decode(&b, 1) == 0) {
+		throw PKException("EOF");
 	}
+	return b;
 }
 
 int PKWareInputStream::read(unsigned char *buf, int length) {
-	int current = 0;
-	try {
-		int max = length;
-		while (current < max) {
-			if (read_copying) {
-				while (current < max && read_copying) {
-					read_length--;
-					if (read_length <= 0) {
-						read_copying = false;
-					}
-					buf[current++] = dictionary->get(read_offset);
-				}
-			} else if (readBit() == 0) {
-				// Copy byte verbatim
-				int result = readBits(8);
-				dictionary->put((unsigned char)result);
-				buf[current++] = (unsigned char)result;
-			} else {
-				// Needs to copy stuff from the dictionary
-				read_length = getCopyLength();
-				if (read_length >= 519) {
-					return current;
-				}
-				
-				read_offset = getCopyOffset(read_length);
-				buf[current++] = dictionary->get(read_offset);
-				read_length--;
-				read_copying = true;
-			}
-		}
-		return current;
-	} catch (PKException e) {
-		if (e.msg == "EOF") {
-			//cout << "EOF thrown, current = " << current << endl;
-			return current;
-		}
-		throw;
-	}
+	return decode(buf, length);
 }
 
 unsigned char PKWareInputStream::readByte() {
@@ -216,28 +293,22 @@ unsigned int PKWareInputStream::readInt() {
 
 /**
 * Skips length bytes from the input
-* @todo Make much more efficient
 */
 void PKWareInputStream::skip(int length) {
-	for (int i = 0; i < length; i++) {
-		read();
+	unsigned char scratch[scratchSize];
+	while (length > 0) {
+		int count = min(length, (int)scratchSize);
+		if (decode(scratch, count) < count) {
+			throw PKException("EOF");
+		}
+		length -= count;
 	}
 }
 
 void PKWareInputStream::empty() {
-	//int i = 0;
-	try {
-		bool success = true;
-		while (success) {
-			read();
-			//i++;
-		}
-	} catch (PKException e) {
-		if (e.msg == "EOF") {
-			//cout << "Emptied. " << i << " bytes discarded" << endl;
-			return;
-		}
-		throw;
+	unsigned char scratch[scratchSize];
+	while (!finished) {
+		decode(scratch, scratchSize);
 	}
 }
 
@@ -246,258 +317,143 @@ void PKWareInputStream::empty() {
 ///////////////////////////
 
 /**
-* Initialises the stream
+* Initialises the stream, compressed data is read from input
+* when `data' is NULL
 */
-void PKWareInputStream::init() {
-	// First get the file length if it hasn't been given
-	if (file_length == -1) {
-		int current = input->tellg();
-		input->seekg(0, ios::end);
-		file_length = (int)input->tellg() - current;
-		input->seekg(current, ios::beg);
-		cout << "Discovered file length: " << file_length << endl;
+void PKWareInputStream::init(const char *data, int length) {
+	if (data == NULL) {
+		// First get the file length if it hasn't been given
+		if (length == -1) {
+			int current = input->tellg();
+			input->seekg(0, ios::end);
+			length = (int)input->tellg() - current;
+			input->seekg(current, ios::beg);
+			cout << "Discovered file length: " << length << endl;
+		}
+		if (length <= 2) {
+			throw PKException("File too small");
+		}
+		// Whole block is read at once, so decoding doesn't touch stream
+		buffer.resize(length);
+		input->read(buffer.data(), length);
+		length = (int)input->gcount();
+		data = buffer.data();
 	}
-	if (file_length <= 2) {
+	if (length <= 2) {
 		throw PKException("File too small");
 	}
-	eof_reached = false;
-	readHeader();
-	fillBuffer();
-	// Init the remaining variables
-	bufBit = 0;
-	read_offset = 0;
-	read_length = 0;
-	read_copying = false;
-}
-
-/**
-* Reads the 2-byte header and initialises the dictionary
-*/
-void PKWareInputStream::readHeader() {
+	
 	// Read the header to decide on the encoding type
-	char c;
-	input->read(&c, 1);
-	if (c != 0) {
+	if (data[0] != 0) {
 		throw PKException("Static dictionary not supported");
 	}
 	
-	input->read(&c, 1);
-	dictionary_bits = (int)c;
-	switch (dictionary_bits) {
-		case 4: dictSize = 1024; break;
-		case 5: dictSize = 2048; break;
-		case 6: dictSize = 4096; break;
-		default:
-			throw PKException("Unknown dictionary size");
+	dictionary_bits = (int)data[1];
+	if (dictionary_bits < 4 || dictionary_bits > 6) {
+		throw PKException("Unknown dictionary size");
 	}
-  dictionary.reset( new PKDictionary(dictSize) );
-  buffer.resize( BUFFER_SIZE );
-	//System.out.println("Dictionary size: "+dictSize);
-	file_length -= 2; // Subtract two header bytes from total file length
-}
-
-/**
-* Gets the amount of bytes to copy from the dictionary
-*/
-int PKWareInputStream::getCopyLength() {
-	int bits;
 	
-	bits = readBits(2);
-	if (bits == 3) { // 11
-		return 3;
-	} else if (bits == 1) { // 10x
-		return 4 - 2 * readBit();
-	} else if (bits == 2) { // 01
-		if (readBit() == 1) { // 011
-			return 5;
-		} else { // 010x
-			return 7 - readBit();
-		}
-	} else if (bits == 0) { // 00
-		bits = readBits(2);
-		if (bits == 3) { // 0011
-			return 8;
-		} else if (bits == 1) { // 0010
-			if (readBit() == 1) { // 00101
-				return 9;
-			} else { // 00100x
-				return 10 + readBit();
-			}
-		} else if (bits == 2) { // 0001
-			if (readBit() == 1) { // 00011xx
-				return 12 + readBits(2);
-			} else { // 00010xxx
-				return 16 + readBits(3);
-			}
-		} else if (bits == 0) { // 0000
-			bits = readBits(2);
-			if (bits == 3) { // 000011xxxx
-				return 24 + readBits(4);
-			} else if (bits == 1) { // 000010xxxxx
-				return 40 + readBits(5);
-			} else if (bits == 2) { // 000001xxxxxx
-				return 72 + readBits(6);
-			} else if (bits == 0) { // 000000
-				if (readBit() == 1) { // 0000001xxxxxxx
-					return 136 + readBits(7);
-				} else { // 0000000xxxxxxxx
-					return 264 + readBits(8);
-				}
-			}
-		}
-	}
-	throw PKException("Invalid copy length");
-}
-
-/**
-* Gets the offset at which to start copying bytes from the dictionary
-*/
-int PKWareInputStream::getCopyOffset(int length) {
-	int lower_bits, result;
-	if (length == 2) {
-		lower_bits = 2;
-	} else {
-		lower_bits = dictionary_bits;
-	}
+	int dictSize = 64 << dictionary_bits;
+	dictionary.resize(dictSize);
+	dict = (unsigned char*)dictionary.data();
+	dict_mask = dictSize - 1;
+	dict_first = dict_mask;
 	
-	result = getCopyOffsetHigh() << lower_bits;
-	result |= readBits(lower_bits);
-	return result;
+	next = (const unsigned char*)data + 2;
+	end = (const unsigned char*)data + length;
+	bits = 0;
+	bit_count = 0;
+	read_offset = 0;
+	read_length = 0;
+	finished = false;
 }
 
 /**
-* Gets the "high" value of the copy offset, the lower N bits
-* are stored verbatim; N depends on the copy length and the
-* dictionary size.
+* Decodes up to `length' bytes, stops early only at the end marker
 */
-int PKWareInputStream::getCopyOffsetHigh() {
-	int bits;
+int PKWareInputStream::decode(unsigned char *buf, int length) {
+	const Tables &t = tables();
+	int current = 0;
 	
-	bits = readBits(2);
-	if (bits == 3) { // 11
-		return 0;
-	} else if (bits == 1) { // 10
-		bits = readBits(2);
-		if (bits == 3) { // 1011
-			return 0x1;
-		} else if (bits == 1) { // 1010
-			return 0x2;
-		} else if (bits == 2) { // 1001x
-			return 0x4 - readBit();
-		} else if (bits == 0) { // 1000x
-			return 0x6 - readBit();
+	while (current < length && !finished) {
+		if (read_length > 0) {
+			// Copy from dictionary, every copied byte is put back into it
+			int count = min(read_length, length - current);
+			read_length -= count;
+			for (int i = 0; i < count; i++) {
+				unsigned char b = dict[(dict_first - read_offset) & dict_mask];
+				dict_first = (dict_first + 1) & dict_mask;
+				dict[dict_first] = b;
+				buf[current++] = b;
+			}
+			continue;
 		}
-	} else if (bits == 2) { // 01
-		bits = readBits(4);
-		if (bits == 0) {
-			return 0x17 - readBit();
-		} else {
-			bits = reverse(bits, 4);
-			return 0x16 - bits;
+		
+		// Longest copy header takes 1+7+8+8+6 bits, literal takes 9
+		if (bit_count < 32) {
+			refill();
 		}
-	} else if (bits == 0) { // 00
-		bits = readBits(2);
-		if (bits == 3) {
-			bits = reverse(readBits(3), 3);
-			return 0x1f - bits;
-		} else if (bits == 1) {
-			bits = reverse(readBits(3), 3);
-			return 0x27 - bits;
-		} else if (bits == 2) {
-			bits = reverse(readBits(3), 3);
-			return 0x2f - bits;
-		} else {
-			bits = reverse(readBits(4), 4);
-			return 0x3f - bits;
+		
+		if ((bits & 1) == 0) {
+			// Copy byte verbatim
+			need(9);
+			unsigned char b = (unsigned char)(bits >> 1);
+			bits >>= 9;
+			bit_count -= 9;
+			dict_first = (dict_first + 1) & dict_mask;
+			dict[dict_first] = b;
+			buf[current++] = b;
+			continue;
 		}
-	}
-	
-	throw PKException("Invalid copy offset");
-}
-
-/**
-* Reverse the bits in `number', essentially converting it from little
-* endian to big endian or vice versa.
-*/
-int PKWareInputStream::reverse(int number, int length) {
-	int result = 0;
-	for (int i = 0; i < length; i++) {
-		if (0 != (number & (1 << i))) {
-			// Set bit in result
-			result |= (1 << (length - 1 - i));
+		
+		// Needs to copy stuff from the dictionary
+		need(1);
+		bits >>= 1;
+		bit_count--;
+		
+		const Code &len = t.lengths[bits & ((1 << lengthBits) - 1)];
+		need(len.length + len.extra);
+		bits >>= len.length;
+		read_length = len.value + (int)(bits & ((1 << len.extra) - 1));
+		bits >>= len.extra;
+		bit_count -= len.length + len.extra;
+		
+		if (read_length >= eofLength) {
+			read_length = 0;
+			finished = true;
+			break;
 		}
+		
+		int lower_bits = (read_length == 2) ? 2 : dictionary_bits;
+		const Code &high = t.offsets[bits & ((1 << offsetBits) - 1)];
+		need(high.length + lower_bits);
+		bits >>= high.length;
+		read_offset = (high.value << lower_bits) | (int)(bits & ((1 << lower_bits) - 1));
+		bits >>= lower_bits;
+		bit_count -= high.length + lower_bits;
 	}
-	return result;
-}
-
-/**
-* Fill the internal buffer
-*/
-void PKWareInputStream::fillBuffer() {
-	bufOffset = 0;
-	if (file_length <= BUFFER_SIZE) {
-    input->read(buffer.data(), file_length);
-		eof_reached = true;
-		eof_position = file_length;
-	} else {
-    input->read(buffer.data(), BUFFER_SIZE);
-		file_length -= BUFFER_SIZE;
-	}
-}
-
-/**
-* Advances the data pointer one byte, filling the buffer
-* if necessary
-*/
-void PKWareInputStream::advanceByte() {
-	bufOffset++;
-	if (eof_reached && bufOffset >= eof_position) {
-		throw PKException("EOF (invalid)");
-	}
-	if (bufOffset >= BUFFER_SIZE) {
-		fillBuffer();
-	}
-	bufBit = 0;
+	return current;
 }
 
 /**
-* Reads one single bit
+* Moves whole bytes from the block into bit buffer
 */
-unsigned char PKWareInputStream::readBit() {
-	if (bufBit == 8) {
-		advanceByte();
+void PKWareInputStream::refill() {
+	while (bit_count <= 56 && next < end) {
+		bits |= (uint64_t)(*next++) << bit_count;
+		bit_count += 8;
 	}
-	unsigned char b = (unsigned char)((buffer[bufOffset] & (1 << bufBit)) >> bufBit);
-	bufBit++;
-	return b;
 }
 
 /**
-* Reads bits in little endian order
-* @param length Number of bits to read. Should never be more than 8.
-* @return int Value of the bits read
+* Makes sure `count' bits are in bit buffer, the stream is broken
+* when the block ends before them
 */
-int PKWareInputStream::readBits(int length) {
-	int result;
-	if (bufBit == 8) {
-		advanceByte();
-	}
-	// Check to see if we span multiple bytes
-	if (bufBit + length > 8) {
-		// First take last remaining bits in this byte & put them in place
-		result = ((buffer[bufOffset] & 0xff) >> bufBit);
-		int length2 = length + bufBit - 8;
-		int length1 = length - length2;
-		advanceByte();
-		
-		// Read length2 bytes from the second byte & add them to the result
-		result |= ((buffer[bufOffset]) & ((1 << length2) - 1)) << length1;
-		bufBit = length2;
-	} else {
-		// Same byte, easy!
-		result = buffer[bufOffset] >> bufBit;
-		result &= (1 << length) - 1;
-		bufBit += length;
+void PKWareInputStream::need(int count) {
+	if (bit_count < count) {
+		refill();
+		if (bit_count < count) {
+			throw PKException("EOF (invalid)");
+		}
 	}
-	return result;
 }
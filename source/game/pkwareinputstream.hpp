@@ -20,8 +20,8 @@
 #define pkwareinputstream_h
 
 #include <string>
+#include <stdint.h>
 #include "core/bytearray.hpp"
-#include "core/scopedptr.hpp"
 //#include <istream>
 
 /**
@@ -35,14 +35,11 @@ class PKException {
 		}
 };
 
-/**
-* Internal class
-*/
-class PKDictionary;
-
 /**
 * Input class for reading files / blocks of data compressed with the
 * PKWare Compression Library.
+* Compressed block is kept in memory and decoded with lookup tables,
+* so no stream calls happen while decoding.
 * All methods (including constructors) may throw a PKException
 */
 class PKWareInputStream {
@@ -66,6 +63,14 @@ class PKWareInputStream {
 		* compressed block
 		*/
 		PKWareInputStream(std::istream *i, bool close_stream = true, int file_length = -1);
+
+		/**
+		* Constructor
+		* @param data Compressed block in memory, it must live until
+		* this object is destroyed
+		* @param length Length of the compressed block
+		*/
+		PKWareInputStream(const char *data, int length);
 		~PKWareInputStream();
 		
 		/**
@@ -108,37 +113,33 @@ class PKWareInputStream {
 		void empty();
 		
 	private:
-		void init();
-		void readHeader();
-		int getCopyLength();
-		int getCopyOffset(int length);
-		int getCopyOffsetHigh();
-		int reverse(int number, int length);
-		void fillBuffer();
-		void advanceByte();
-		unsigned char readBit();
-		int readBits(int length);
+		void init(const char *data, int length);
+		int decode(unsigned char *buf, int length);
+		void refill();
+		void need(int count);
 		
 		// Class variables (comments is where they're initialised)
 		std::istream *input; // ctor
-		int dictSize; // readHeader
-    ByteArray buffer; // fillBuffer
-		int bufOffset; // fillBuffer
-		int bufBit; // init
-		int dictionary_bits; // readHeader
-    ScopedPtr<PKDictionary> dictionary; // readHeader
+		bool close_stream; // ctor
+		ByteArray buffer; // ctor, compressed block read from stream
+		
+		// Bit reader, bits come from lowest to highest like in stream
+		const unsigned char *next; // init
+		const unsigned char *end; // init
+		uint64_t bits; // init
+		int bit_count; // init
+		int dictionary_bits; // init
 		
-		// For the reading of bytes:
+		// Dictionary of past bytes, size is power of two
+		ByteArray dictionary; // init
+		unsigned char *dict; // init
+		unsigned int dict_mask; // init
+		unsigned int dict_first; // init
+		
+		// Copy which didn't fit into previous read
 		int read_offset; // init
 		int read_length; // init
-		bool read_copying; // init
-		int file_length; // ctor or init
-		
-		// For detecting end of stream:
-		bool eof_reached; // init, fillBuffer
-		int eof_position; // fillBuffer
-		bool close_stream; // ctor
-		static const int BUFFER_SIZE = 4096;
+		bool finished; // init, decode
 };
 
 #endif /* pkwareinputstream_h */
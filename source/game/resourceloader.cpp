@@ -25,6 +25,10 @@
 #include "game/settings.hpp"
 #include "core/variant_list.hpp"
 #include "gfx/loader.hpp"
+#include "vfs/archive_sg2.hpp"
+#include "gfx/atlas_cache.hpp"
+#include "core/format.hpp"
+#include <thread>
 
 using namespace vfs;
 
@@ -111,9 +115,24 @@ void ResourceLoader::loadFiles(Path path)
 
 void ResourceLoader::loadFiles(ArchivePtr archive)
 {
-  const vfs::Entries::Items& files = archive->entries()->items();
   gfx::PictureBank& pb = gfx::PictureBank::instance();
 
+  // original graphics are decoded by groups straight to pictures
+  Sg2ArchiveReader* sg2 = dynamic_cast<Sg2ArchiveReader*>( archive.object() );
+  if( sg2 )
+  {
+    int workers = std::max<int>( std::thread::hardware_concurrency(), 1 );
+    for( auto& group : sg2->groups() )
+    {
+      gfx::Pictures pics = sg2->loadGroup( group, workers );
+      for( auto& pic : pics )
+        pb.setPicture( pic.name(), pic );
+    }
+    return;
+  }
+
+  const vfs::Entries::Items& files = archive->entries()->items();
+
   std::string basename;
   basename.reserve( 256 );
   for( auto& entry : files )
@@ -131,4 +150,46 @@ void ResourceLoader::loadFiles(ArchivePtr archive)
   }
 }
 
+bool ResourceLoader::useAtlasCache(const Directory& dir)
+{
+  FileSystem& fs = FileSystem::instance();
+
+  // cache is rebuilt when any of source archives changes
+  std::vector<Sg2ArchiveReader*> sources;
+  std::string signature;
+  for( unsigned int k=0; k < fs.archiveCount(); k++ )
+  {
+    Sg2ArchiveReader* sg2 = dynamic_cast<Sg2ArchiveReader*>( fs.getFileArchive( k ).object() );
+    if( !sg2 )
+      continue;
+
+    NFile file = NFile::open( sg2->path() );
+    signature += fmt::format( "{}:{}:{};", sg2->path().toString(), file.size(), file.lastModify() );
+    sources.push_back( sg2 );
+  }
+
+  if( sources.empty() )
+    return false;
+
+  gfx::PictureBank& pb = gfx::PictureBank::instance();
+  if( pb.openAtlasCache( dir, signature ) )
+    return true;
+
+  Logger::info( "ResourceLoader: bake atlases to " + dir.toString() );
+  gfx::AtlasCache::Baker baker( dir, signature );
+  int workers = std::max<int>( std::thread::hardware_concurrency(), 1 );
+  for( auto sg2 : sources )
+  {
+    for( auto& group : sg2->groups() )
+    {
+      sg2->decodeGroup( group, workers, [&baker]( const std::string& name, const Size& size, const unsigned int* pixels )
+      {
+        baker.add( name, size, pixels );
+      });
+    }
+  }
+
+  return baker.finish() && pb.openAtlasCache( dir, signature );
+}
+
 Signal1<std::string> &ResourceLoader::onStartLoading() { return _d->onStartLoadingSignal;}
@@ -36,6 +36,10 @@ public:
   void loadFiles( vfs::ArchivePtr archive );
   void loadFiles( vfs::Path path );
 
+  //! pictures of mounted sg2 archives are baked to atlases in dir once,
+  //! later starts load them from there, false when cache can't be used
+  bool useAtlasCache( const vfs::Directory& dir );
+
 public signals:
   Signal1<std::string> &onStartLoading();
 
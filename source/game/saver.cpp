@@ -30,6 +30,7 @@
 #include "events/dispatcher.hpp"
 #include "gui/minimap_window.hpp"
 #include "gui/widget_helper.hpp"
+#include "binary_save.hpp"
 
 namespace game
 {
@@ -37,7 +38,7 @@ namespace game
 const char* SaverOptions::restartFile = "restartFile";
 const char* SaverOptions::version = "version";
 
-void Saver::save(const vfs::Path& filename, const Game& game )
+bool Saver::save(const vfs::Path& filename, const Game& game )
 {
   VariantMap vm;
   vm[ SaverOptions::version ] = 1;
@@ -52,6 +53,18 @@ void Saver::save(const vfs::Path& filename, const Game& game )
   vm[ "scenario" ] = vm_scenario;
   vm[ SaverOptions::restartFile ] = Variant( _restartFile );
 
+  gui::Minimap* minimap = gui::findChildA<gui::Minimap*>( true, game.gui()->rootWidget() );
+  if( minimap )
+  {
+    vfs::Path imgPath = filename.changeExtension( "png" );
+    minimap->saveImage( imgPath.toString() );
+  }
+
+  if( filename.isMyExtension( binsave::extension ) )
+  {
+    return binsave::save( filename, vm, game );
+  }
+
   VariantMap vm_empire;
   game.empire()->save( vm_empire );
   vm[ "empire" ] = vm_empire;
@@ -68,14 +81,7 @@ void Saver::save(const vfs::Path& filename, const Game& game )
   religion::rome::Pantheon::instance().save( vm_pantheon );
   vm[ "pantheon" ] = vm_pantheon;
 
-  gui::Minimap* minimap = gui::findChildA<gui::Minimap*>( true, game.gui()->rootWidget() );
-  if( minimap )
-  {
-    vfs::Path imgPath = filename.changeExtension( "png" );
-    minimap->saveImage( imgPath.toString() );
-  }
-
-  config::save( vm, filename );
+  return config::save( vm, filename );
 }
 
 void Saver::setRestartFile(const std::string& filename) { _restartFile = filename; }
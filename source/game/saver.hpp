@@ -37,7 +37,7 @@ public:
 class Saver
 {
 public:   
-  void save( const vfs::Path& filename, const Game& game );
+  bool save( const vfs::Path& filename, const Game& game );
   void setRestartFile( const std::string& filename );
 
 private:
@@ -91,8 +91,10 @@ __REG_PROPERTY(playerName)
 __REG_PROPERTY(lastGame)
 __REG_PROPERTY(tooltipEnabled)
 __REG_PROPERTY(screenshotDir)
+__REG_PROPERTY(cacheDir)
 __REG_PROPERTY(showTabletMenu)
 __REG_PROPERTY(batchTextures)
+__REG_PROPERTY(phasedUpdates)
 __REG_PROPERTY(ccUseAI)
 __REG_PROPERTY(metricSystem)
 __REG_PROPERTY(defaultFont)
@@ -112,6 +114,7 @@ __REG_PROPERTY(buildNumber)
 #undef __REG_PROPERTY
 
 const vfs::Path defaultSaveDir = "saves";
+const vfs::Path defaultCacheDir = "cache";
 const vfs::Path defaultResDir = "resources";
 const vfs::Path defaultLocaleDir = "resources/locale";
 
@@ -167,6 +170,7 @@ Settings::Settings() : _d( new Impl )
   _d->options[ ambientsounds       ] = std::string( "ambientsounds.model" );
   _d->options[ screenshotDir       ] = vfs::Directory::userDir().toString();
   _d->options[ batchTextures       ] = true;
+  _d->options[ phasedUpdates       ] = true;
   _d->options[ verbose             ] = false;
   _d->options[ rightMenu           ] = true;
   _d->options[ experimental        ] = false;
@@ -239,14 +243,18 @@ void Settings::setwdir(const std::string& wdirstr)
   _d->options[ savedir      ] = Variant( (wdir/defaultSaveDir).toString() );
 
   vfs::Directory saveDir;
+  vfs::Directory cacheFolder;
   vfs::Path dirName;
   if( OSystem::isLinux() ) {
     dirName = ".caesaria/" + defaultSaveDir;
     saveDir = vfs::Directory::userDir()/dirName;
+    cacheFolder = vfs::Directory::userDir()/vfs::Path( ".caesaria/" + defaultCacheDir );
   } else {
     saveDir = wdir/defaultSaveDir;
+    cacheFolder = wdir/defaultCacheDir;
   }
   _d->options[ savedir ] = Variant(saveDir.toString());
+  _d->options[ cacheDir ] = Variant(cacheFolder.toString());
 }
 
 void Settings::resetIfNeed(char* argv[], int argc)
@@ -90,8 +90,10 @@ public:
   __GS_PROPERTY(lastGame)
   __GS_PROPERTY(tooltipEnabled)
   __GS_PROPERTY(screenshotDir)
+  __GS_PROPERTY(cacheDir)
   __GS_PROPERTY(showTabletMenu)
   __GS_PROPERTY(batchTextures)
+  __GS_PROPERTY(phasedUpdates)
   __GS_PROPERTY(ccUseAI)
   __GS_PROPERTY(metricSystem)
   __GS_PROPERTY(defaultFont)
@@ -20,6 +20,7 @@
 #include "core/variant_map.hpp"
 #include "core/utils.hpp"
 #include "animation_bank.hpp"
+#include "picture_bank.hpp"
 #include "core/logger.hpp"
 
 namespace gfx
@@ -120,9 +121,19 @@ bool Animation::isLoop() const { return _dfunc()->loop; }
 void Animation::load( const std::string &prefix, const int start, const int number, 
                       bool reverse /*= false*/, const int step /*= 1*/ )
 {
+  // group is resolved once, frames are taken by handles
+  int last = reverse ? start : start + ( number - 1 ) * step;
+  load( PictureBank::instance().range( prefix, std::max( last + 1, 0 ) ),
+        start, number, reverse, step );
+}
+
+void Animation::load( const PictureRange& frames, const int start, const int number,
+                      bool reverse /*= false*/, const int step /*= 1*/ )
+{
+  PictureBank& bank = PictureBank::instance();
   int revMul = reverse ? -1 : 1;
   for( int i = 0; i < number; ++i)
-    _pictures.append( prefix, start + revMul*i*step );
+    _pictures.push_back( bank.get( frames[ start + revMul*i*step ] ) );
 }
 
 void Animation::load(const std::string& alias)
@@ -157,8 +168,7 @@ void Animation::load(const VariantMap& stream)
     std::string rc = range.get( "rc" ).toString();
     int start = range.get( "start" );
     int number = range.get( "number" );
-    for( int k=0; k < number; k++ )
-      _pictures.append( rc, start + k  );
+    load( rc, start, number );
   }
 
   _pictures.load( stream.get( "pictures" ).toStringArray() );
@@ -19,6 +19,7 @@
 #define __CAESARIA_ANIMATION_H_INCLUDE_
 
 #include "picturesarray.hpp"
+#include "predefinitions.hpp"
 #include "core/variant_map.hpp"
 #include "core/scopedptr.hpp"
 
@@ -75,6 +76,9 @@ public:
   void load( const std::string &prefix,
              const int start, const int number,
              bool reverse = false, const int step = 1);
+  void load( const PictureRange& frames,
+             const int start, const int number,
+             bool reverse = false, const int step = 1);
   void load( const std::string& alias );
   void load( const VariantMap& stream );
   void simple( const VariantMap& stream );
@@ -21,6 +21,7 @@
 #include "core/position.hpp"
 #include "game/resourcegroup.hpp"
 #include "gfx/picture.hpp"
+#include "gfx/picture_bank.hpp"
 #include "core/logger.hpp"
 #include "core/saveadapter.hpp"
 #include "good/helper.hpp"
@@ -176,20 +177,24 @@ void AnimationBank::Impl::loadStage(DirectedAnimations& refMap , unsigned int wh
   MovementAnimation& ioMap = refMap[ who ].actions;
   DirectedAction action( wa, direction::none );
 
+  // all directions take frames from one group, it is resolved once
+  int last = start + 7 + std::max( size - 1, 0 ) * std::max( step, 1 );
+  PictureRange frames = PictureBank::instance().range( prefix, std::max( last + 1, 0 ) );
+
   if( step == 0 )
   {
-    action.direction = north;      ioMap[action].load( prefix, start,   size, Animation::straight, 1 );
+    action.direction = north;      ioMap[action].load( frames, start,   size, Animation::straight, 1 );
   }
   else
   {
-    action.direction = north;      ioMap[action].load( prefix, start,   size, Animation::straight, step); ioMap[action].setDelay( delay );
-    action.direction = northEast;  ioMap[action].load( prefix, start+1, size, Animation::straight, step); ioMap[action].setDelay( delay );
-    action.direction = east;       ioMap[action].load( prefix, start+2, size, Animation::straight, step); ioMap[action].setDelay( delay );
-    action.direction = southEast;  ioMap[action].load( prefix, start+3, size, Animation::straight, step); ioMap[action].setDelay( delay );
-    action.direction = south;      ioMap[action].load( prefix, start+4, size, Animation::straight, step); ioMap[action].setDelay( delay );
-    action.direction = southWest;  ioMap[action].load( prefix, start+5, size, Animation::straight, step); ioMap[action].setDelay( delay );
-    action.direction = west;       ioMap[action].load( prefix, start+6, size, Animation::straight, step); ioMap[action].setDelay( delay );
-    action.direction = northWest;  ioMap[action].load( prefix, start+7, size, Animation::straight, step); ioMap[action].setDelay( delay );
+    action.direction = north;      ioMap[action].load( frames, start,   size, Animation::straight, step); ioMap[action].setDelay( delay );
+    action.direction = northEast;  ioMap[action].load( frames, start+1, size, Animation::straight, step); ioMap[action].setDelay( delay );
+    action.direction = east;       ioMap[action].load( frames, start+2, size, Animation::straight, step); ioMap[action].setDelay( delay );
+    action.direction = southEast;  ioMap[action].load( frames, start+3, size, Animation::straight, step); ioMap[action].setDelay( delay );
+    action.direction = south;      ioMap[action].load( frames, start+4, size, Animation::straight, step); ioMap[action].setDelay( delay );
+    action.direction = southWest;  ioMap[action].load( frames, start+5, size, Animation::straight, step); ioMap[action].setDelay( delay );
+    action.direction = west;       ioMap[action].load( frames, start+6, size, Animation::straight, step); ioMap[action].setDelay( delay );
+    action.direction = northWest;  ioMap[action].load( frames, start+7, size, Animation::straight, step); ioMap[action].setDelay( delay );
   }
 }
 
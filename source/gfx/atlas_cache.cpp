@@ -0,0 +1,286 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "atlas_cache.hpp"
+#include "IMG_savepng.h"
+#include "core/chunk_stream.hpp"
+#include "core/hash.hpp"
+#include "core/utils.hpp"
+#include "core/logger.hpp"
+#include "core/debug_timer.hpp"
+#include "vfs/file.hpp"
+
+#include <SDL.h>
+#include <algorithm>
+#include <cstring>
+#include <set>
+
+namespace gfx
+{
+
+namespace {
+enum { indexFormat=1, padding=1 };
+
+static const char* indexFilename = "atlas.index";
+static const uint32_t infoTag = chunkTag( 'A', 'I', 'N', 'F' );    // signature, atlas count
+static const uint32_t framesTag = chunkTag( 'A', 'F', 'R', 'M' );  // frames sorted by hash
+
+inline std::string atlasFilename( unsigned int index )
+{
+  return utils::format( 0xff, "atlas_%02d.png", index );
+}
+
+inline bool lessHash( const AtlasCache::Frame& a, const AtlasCache::Frame& b )
+{
+  return a.hash < b.hash;
+}
+}
+
+class AtlasCache::Baker::Impl
+{
+public:
+  vfs::Directory dir;
+  std::string signature;
+  int atlasSize;
+
+  std::vector<unsigned int> pixels;
+  unsigned int atlas;
+  Frames frames;
+  std::set<unsigned int> hashes;
+  unsigned int startTime;
+
+  // shelf packer: images go left to right, new shelf starts under highest one
+  struct {
+    int x;
+    int y;
+    int height;
+  } shelf;
+
+  void resetShelf() { shelf.x = shelf.y = shelf.height = 0; }
+  bool flush();
+};
+
+bool AtlasCache::Baker::Impl::flush()
+{
+  int usedHeight = shelf.y + shelf.height;
+  if( usedHeight == 0 )
+    return true;
+
+  // atlas is cut to used rows, last one is usually half empty
+  SDL_Surface* srf = SDL_CreateRGBSurfaceFrom( pixels.data(), atlasSize, usedHeight, 32, atlasSize * 4,
+                                               0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000 );
+  vfs::Path filename = dir/atlasFilename( atlas );
+  int rc = srf ? IMG_SavePNG( filename.toString().c_str(), srf, -1 ) : -1;
+  SDL_FreeSurface( srf );
+
+  if( rc < 0 )
+  {
+    Logger::warning( "AtlasCache: can't write atlas " + filename.toString() );
+    return false;
+  }
+
+  atlas++;
+  std::fill( pixels.begin(), pixels.end(), 0 );
+  resetShelf();
+  return true;
+}
+
+AtlasCache::Baker::Baker( const vfs::Directory& dir, const std::string& signature, int atlasSize )
+  : _d( new Impl )
+{
+  _d->dir = dir;
+  _d->signature = signature;
+  _d->atlasSize = atlasSize;
+  _d->atlas = 0;
+  _d->startTime = DebugTimer::ticks();
+  _d->resetShelf();
+
+  if( !dir.exist() )
+    vfs::Directory::createByPath( dir );
+
+  // old index must not point to new textures while bake is running
+  vfs::NFile::remove( dir/indexFilename );
+}
+
+AtlasCache::Baker::~Baker() {}
+
+bool AtlasCache::Baker::add( const std::string& name, const Size& size, const unsigned int* pixels )
+{
+  int w = size.width();
+  int h = size.height();
+  if( w <= 0 || h <= 0 || w > _d->atlasSize || h > _d->atlasSize )
+    return false;
+
+  // first archive wins, like in file system lookup
+  unsigned int hash = Hash( name );
+  if( !_d->hashes.insert( hash ).second )
+    return false;
+
+  if( _d->pixels.empty() )
+    _d->pixels.resize( _d->atlasSize * _d->atlasSize, 0 );
+
+  if( _d->shelf.x + w > _d->atlasSize )
+  {
+    _d->shelf.y += _d->shelf.height + padding;
+    _d->shelf.x = 0;
+    _d->shelf.height = 0;
+  }
+
+  if( _d->shelf.y + h > _d->atlasSize )
+  {
+    if( !_d->flush() )
+      return false;
+  }
+
+  for( int y=0; y < h; y++ )
+  {
+    memcpy( &_d->pixels[ (_d->shelf.y + y) * _d->atlasSize + _d->shelf.x ],
+            pixels + y * w, w * sizeof(unsigned int) );
+  }
+
+  Frame frame;
+  frame.hash = hash;
+  frame.atlas = _d->atlas;
+  frame.rect = Rect( Point( _d->shelf.x, _d->shelf.y ), size );
+  frame.name = name;
+  _d->frames.push_back( frame );
+
+  _d->shelf.x += w + padding;
+  _d->shelf.height = std::max( _d->shelf.height, h );
+  return true;
+}
+
+bool AtlasCache::Baker::finish()
+{
+  if( !_d->flush() )
+    return false;
+
+  std::stable_sort( _d->frames.begin(), _d->frames.end(), lessHash );
+
+  ChunkWriter writer( _d->dir/indexFilename, indexFormat );
+  if( !writer.isOpen() )
+    return false;
+
+  writer.begin( infoTag );
+  writer.writeString( _d->signature );
+  writer.writeU32( _d->atlas );
+  writer.writeU32( _d->frames.size() );
+  writer.end();
+
+  writer.begin( framesTag );
+  for( auto& frame : _d->frames )
+  {
+    writer.writeU32( frame.hash );
+    writer.writeVarint( frame.atlas );
+    writer.writeVarint( frame.rect.left() );
+    writer.writeVarint( frame.rect.top() );
+    writer.writeVarint( frame.rect.width() );
+    writer.writeVarint( frame.rect.height() );
+    writer.writeString( frame.name );
+  }
+  writer.end();
+
+  Logger::info( "AtlasCache: {} frames baked to {} atlases in {} ms", _d->frames.size(), _d->atlas,
+                DebugTimer::ticks() - _d->startTime );
+  _d->pixels.clear();
+  return true;
+}
+
+class AtlasCache::Impl
+{
+public:
+  vfs::Directory dir;
+  unsigned int atlasCount;
+  Frames frames;
+};
+
+AtlasCache::AtlasCache() : _d( new Impl )
+{
+  _d->atlasCount = 0;
+}
+
+AtlasCache::~AtlasCache() {}
+
+bool AtlasCache::open( const vfs::Directory& dir, const std::string& signature )
+{
+  _d->frames.clear();
+  _d->atlasCount = 0;
+
+  vfs::Path filename = dir/indexFilename;
+  if( !filename.exist() )
+    return false;
+
+  ChunkReader reader( filename );
+  if( !reader.isOpen() || reader.format() != indexFormat )
+    return false;
+
+  Chunk info = reader.read( infoTag );
+  if( info.readString() != signature )
+  {
+    Logger::debug( "AtlasCache: index in {} is outdated", dir.toString() );
+    return false;
+  }
+
+  unsigned int atlasCount = info.readU32();
+  unsigned int frameCount = info.readU32();
+
+  Chunk data = reader.read( framesTag );
+  if( frameCount > data.size() )
+    return false;
+
+  Frames frames( frameCount );
+  for( auto& frame : frames )
+  {
+    frame.hash = data.readU32();
+    frame.atlas = data.readVarint();
+    // one read per statement, argument evaluation order is unspecified
+    int x = data.readVarint();
+    int y = data.readVarint();
+    int w = data.readVarint();
+    int h = data.readVarint();
+    frame.rect = Rect( Point( x, y ), Size( w, h ) );
+    frame.name = data.readString();
+
+    if( frame.atlas >= atlasCount )
+      return false;
+  }
+
+  for( unsigned int k=0; k < atlasCount; k++ )
+  {
+    if( !(dir/atlasFilename( k )).exist() )
+      return false;
+  }
+
+  _d->dir = dir;
+  _d->atlasCount = atlasCount;
+  _d->frames.swap( frames );
+  return true;
+}
+
+bool AtlasCache::isOpen() const { return _d->atlasCount > 0; }
+
+const AtlasCache::Frame* AtlasCache::find( unsigned int hash ) const
+{
+  Frame key;
+  key.hash = hash;
+  Frames::const_iterator it = std::lower_bound( _d->frames.begin(), _d->frames.end(), key, lessHash );
+  return ( it != _d->frames.end() && it->hash == hash ) ? &(*it) : 0;
+}
+
+const AtlasCache::Frames& AtlasCache::frames() const { return _d->frames; }
+unsigned int AtlasCache::atlasCount() const { return _d->atlasCount; }
+vfs::Path AtlasCache::texture( unsigned int atlas ) const { return _d->dir/atlasFilename( atlas ); }
+
+}//end namespace gfx
@@ -0,0 +1,78 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __CAESARIA_ATLAS_CACHE_H_INCLUDED__
+#define __CAESARIA_ATLAS_CACHE_H_INCLUDED__
+
+#include "core/scopedptr.hpp"
+#include "core/rectangle.hpp"
+#include "vfs/directory.hpp"
+#include <vector>
+
+namespace gfx
+{
+
+// Prebaked atlases for pictures which otherwise are decoded one by one
+// on every start. Cache directory keeps few atlas textures and binary
+// index, where frames are sorted by Hash(name).
+class AtlasCache
+{
+public:
+  struct Frame
+  {
+    unsigned int hash;
+    unsigned int atlas;
+    Rect rect;
+    std::string name;
+  };
+
+  typedef std::vector<Frame> Frames;
+
+  //! packs images to atlases, index is written last so interrupted bake isn't used
+  class Baker
+  {
+  public:
+    Baker( const vfs::Directory& dir, const std::string& signature, int atlasSize=2048 );
+    ~Baker();
+
+    //! pixels in A8R8G8B8, returns false when image is bigger than atlas
+    bool add( const std::string& name, const Size& size, const unsigned int* pixels );
+    bool finish();
+
+  private:
+    class Impl;
+    ScopedPtr<Impl> _d;
+  };
+
+  AtlasCache();
+  ~AtlasCache();
+
+  //! fails when cache is missing or was baked for other signature
+  bool open( const vfs::Directory& dir, const std::string& signature );
+  bool isOpen() const;
+
+  const Frame* find( unsigned int hash ) const;
+  const Frames& frames() const;
+  unsigned int atlasCount() const;
+  vfs::Path texture( unsigned int atlas ) const;
+
+private:
+  class Impl;
+  ScopedPtr<Impl> _d;
+};
+
+}//end namespace gfx
+
+#endif //__CAESARIA_ATLAS_CACHE_H_INCLUDED__
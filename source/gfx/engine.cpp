@@ -48,6 +48,8 @@ void Engine::setFullscreen(bool enabled){ setFlag( fullscreen, enabled ? 1 : 0 )
 const Size& Engine::screenSize() const  { return _srcSize; }
 void Engine::setTitle( const std::string& title ) {}
 void Engine::setFlag( int flag, int value ) { _flags[ flag ] = value;}
+Picture Engine::createTarget( const Size& size ) { return Picture(); }
+void Engine::setTarget( const Picture* target, const Point& origin ) {}
 
 int Engine::getFlag(int flag) const
 {
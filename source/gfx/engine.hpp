@@ -70,6 +70,12 @@ public:
   virtual void loadPicture( Picture& ioPicture, bool streaming ) = 0;
   virtual void unloadPicture( Picture& ioPicture) = 0;
 
+  //! offscreen picture which may be drawn to, invalid when engine can't do it
+  virtual Picture createTarget( const Size& size );
+  //! redirects drawing to target, screen point origin goes to its left top corner
+  //! null target returns drawing to screen
+  virtual void setTarget( const Picture* target, const Point& origin=Point() );
+
   virtual Batch loadBatch(const Picture& pic, const Rects& srcRects, const Rects& dstRects, const Rect* clipRect=0) = 0;
   virtual void updateBatch(Batch& batch, const Point& newpos) = 0;
   virtual void unloadBatch(const Batch& batch) = 0;
@@ -102,8 +102,35 @@ int fromResource( const std::string& pic_name )
 
 Picture toPicture(const unsigned int imgId)
 {
-  std::string picname = toResource( imgId );
-  return Picture( picname );
+  return PictureBank::instance().get( toPictureId( imgId ) );
+}
+
+PictureId toPictureId(const unsigned int imgId)
+{
+  // groups are resolved once, tiles don't format and hash names
+  static struct Ranges
+  {
+    PictureRange plateau, land1a, land2a, land3a, housing;
+
+    Ranges()
+    {
+      PictureBank& bank = PictureBank::instance();
+      plateau = bank.range( ResourceGroup::plateau, 245 - 200 );
+      land1a  = bank.range( config::rc.land1a, 548 - 244 );
+      land2a  = bank.range( config::rc.land2a, 779 - 547 );
+      land3a  = bank.range( config::rc.land3a, 871 - 778 );
+      housing = bank.range( ResourceGroup::housing, 52 );
+    }
+  } ranges;
+
+  if( imgId < 245 ) return ranges.plateau[ imgId - 200 ];
+  if( imgId < 548 ) return ranges.land1a[ imgId - 244 ];
+  if( imgId < 779 ) return ranges.land2a[ imgId - 547 ];
+  if( imgId < 871 ) return ranges.land3a[ imgId - 778 ];
+
+  Logger::warning( "!!! TileHelper unknown image Id={} ", imgId );
+  // TERRIBLE HACK!, same as in toResource()
+  return ( imgId == 0xb10 || imgId == 0xb0d ) ? ranges.housing[ 51 ] : ranges.land1a[ 0 ];
 }
 
 }//end namespace imgid
@@ -19,6 +19,7 @@
 #define __CAESARIA_IMGID_HELPER_H_INCLUDED__
 
 #include "tile.hpp"
+#include "picture_bank.hpp"
 
 namespace gfx
 {
@@ -30,6 +31,7 @@ namespace imgid
   std::string toResource( const unsigned int imgId );
   int fromResource( const std::string &pic_name);
   Picture toPicture( const unsigned int imgId );
+  PictureId toPictureId( const unsigned int imgId );
 }
 
 }//end namespace gfx
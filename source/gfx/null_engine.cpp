@@ -0,0 +1,126 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "null_engine.hpp"
+
+#include <SDL.h>
+#include <SDL_ttf.h>
+
+#include "core/logger.hpp"
+#include "core/exception.hpp"
+
+namespace gfx
+{
+
+namespace {
+struct NullFrame : public Frame
+{
+  virtual void start() {}
+  virtual void finish() {}
+  virtual void drawMetrics() {}
+};
+}
+
+class NullEngine::Impl
+{
+public:
+  NullFrame frame;
+  Picture screen;
+  unsigned int lastHandle;
+};
+
+NullEngine::NullEngine() : Engine(), _d( new Impl )
+{
+  _d->lastHandle = 0;
+}
+
+NullEngine::~NullEngine() {}
+
+void NullEngine::init()
+{
+  Logger::debug( "NullEngine: init" );
+
+  // fonts still render text into surfaces for gui metrics
+  int rc = TTF_Init();
+  if( rc != 0 )
+  {
+    Logger::debug( "!!! Unable to initialize ttf: {}", SDL_GetError() );
+    THROW("NullEngine: Unable to initialize ttf: " << SDL_GetError());
+  }
+}
+
+void NullEngine::exit()
+{
+  TTF_Quit();
+  SDL_Quit();
+}
+
+void NullEngine::delay( const unsigned int msec ) {}
+bool NullEngine::haveEvent( NEvent& event ) { return false; }
+Frame& NullEngine::frame() { return _d->frame; }
+void NullEngine::setVirtualSize( const Size& size ) {}
+void NullEngine::setScale( float scale ) {}
+
+void NullEngine::loadPicture( Picture& ioPicture, bool streaming )
+{
+  // surface stays owned by picture, only handle is faked
+  ioPicture.init( 0, ioPicture.surface(), ++_d->lastHandle );
+}
+
+void NullEngine::unloadPicture( Picture& ioPicture )
+{
+  if( ioPicture.surface() )
+    SDL_FreeSurface( ioPicture.surface() );
+
+  ioPicture = Picture();
+}
+
+Batch NullEngine::loadBatch( const Picture& pic, const Rects& srcRects, const Rects& dstRects, const Rect* clipRect )
+{
+  return Batch();
+}
+
+void NullEngine::updateBatch( Batch& batch, const Point& newpos ) {}
+void NullEngine::unloadBatch( const Batch& batch ) {}
+
+void NullEngine::draw( const Picture& picture, const int dx, const int dy, Rect* clipRect ) {}
+void NullEngine::draw( const Picture& picture, const Point& pos, Rect* clipRect ) {}
+void NullEngine::draw( const Pictures& pictures, const Point& pos, Rect* clipRect ) {}
+void NullEngine::draw( const Picture& pic, const Rect& dstRect, Rect* clipRect ) {}
+void NullEngine::draw( const Picture& pic, const Rect& srcRect, const Rect& dstRect, Rect* clipRect ) {}
+void NullEngine::draw( const Picture& pic, const Rects& srcRects, const Rects& dstRects, Rect* clipRect ) {}
+void NullEngine::draw( const Batch& batch, Rect* clipRect ) {}
+
+void NullEngine::drawLine( const NColor& color, const Point& p1, const Point& p2 ) {}
+void NullEngine::drawLines( const NColor& color, const PointsArray& points ) {}
+void NullEngine::fillRect( const NColor& color, const Rect& rect ) {}
+
+void NullEngine::setColorMask( int rmask, int gmask, int bmask, int amask ) {}
+void NullEngine::resetColorMask() {}
+
+void NullEngine::createScreenshot( const std::string& filename ) {}
+unsigned int NullEngine::fps() const { return 0; }
+
+Engine::Modes NullEngine::modes() const
+{
+  Modes ret;
+  ret.push_back( screenSize() );
+  return ret;
+}
+
+Point NullEngine::cursorPos() const { return Point(); }
+Picture& NullEngine::screen() { return _d->screen; }
+
+}//end namespace gfx
@@ -0,0 +1,79 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef _CAESARIA_NULL_ENGINE_H_INCLUDE_
+#define _CAESARIA_NULL_ENGINE_H_INCLUDE_
+
+#include "engine.hpp"
+#include "picture.hpp"
+#include "core/scopedptr.hpp"
+
+// Engine without window and renderer, used to run simulation headless.
+// Pictures get a fake texture handle so isValid() works like in the game.
+namespace gfx
+{
+
+class NullEngine : public Engine
+{
+public:
+  NullEngine();
+  virtual ~NullEngine();
+
+  virtual void init();
+  virtual void exit();
+  virtual void delay( const unsigned int msec );
+  virtual bool haveEvent( NEvent& event );
+
+  virtual Frame& frame();
+
+  virtual void setVirtualSize( const Size& size );
+  virtual void setScale( float scale );
+
+  virtual void loadPicture( Picture& ioPicture, bool streaming );
+  virtual void unloadPicture( Picture& ioPicture );
+
+  virtual Batch loadBatch( const Picture& pic, const Rects& srcRects, const Rects& dstRects, const Rect* clipRect );
+  virtual void updateBatch( Batch& batch, const Point& newpos );
+  virtual void unloadBatch( const Batch& batch );
+
+  virtual void draw( const Picture& picture, const int dx, const int dy, Rect* clipRect );
+  virtual void draw( const Picture& picture, const Point& pos, Rect* clipRect );
+  virtual void draw( const Pictures& pictures, const Point& pos, Rect* clipRect );
+  virtual void draw( const Picture& pic, const Rect& dstRect, Rect* clipRect );
+  virtual void draw( const Picture& pic, const Rect& srcRect, const Rect& dstRect, Rect* clipRect );
+  virtual void draw( const Picture& pic, const Rects& srcRects, const Rects& dstRects, Rect* clipRect );
+  virtual void draw( const Batch& batch, Rect* clipRect );
+
+  virtual void drawLine( const NColor& color, const Point& p1, const Point& p2 );
+  virtual void drawLines( const NColor& color, const PointsArray& points );
+  virtual void fillRect( const NColor& color, const Rect& rect );
+
+  virtual void setColorMask( int rmask, int gmask, int bmask, int amask );
+  virtual void resetColorMask();
+
+  virtual void createScreenshot( const std::string& filename );
+  virtual unsigned int fps() const;
+  virtual Modes modes() const;
+  virtual Point cursorPos() const;
+  virtual Picture& screen();
+
+private:
+  class Impl;
+  ScopedPtr< Impl > _d;
+};
+
+}//end namespace gfx
+
+#endif //_CAESARIA_NULL_ENGINE_H_INCLUDE_
@@ -22,6 +22,7 @@
 #include <memory>
 #include <sys/stat.h>
 #include <set>
+#include <unordered_map>
 #include <SDL.h>
 
 #include "core/variant_map.hpp"
@@ -39,6 +40,7 @@
 #include "gfx/tilemap_config.hpp"
 #include "core/color.hpp"
 #include "core/variant_list.hpp"
+#include "atlas_cache.hpp"
 
 namespace gfx
 {
@@ -63,10 +65,42 @@ public:
   typedef std::map<SDL_Texture*, int> TextureCounter;
   typedef CachedPictures::iterator ItPicture;
 
+  enum { indexBits=20, indexMask=(1<<indexBits)-1 };
+
+  // picture pointers are taken from resources, map nodes don't move
+  // and setPicture() assigns into existing node
+  struct Handle
+  {
+    std::string name;  // empty in prefix groups, made from prefix on first use
+    Picture* picture;
+  };
+
+  typedef std::vector<Handle> Handles;
+
+  // every group has own table, so it grows in place without dead blocks;
+  // group 0 keeps single names given by id(name)
+  struct Group
+  {
+    std::string prefix;
+    Handles handles;
+  };
+
+  typedef std::vector<Group> Groups;
+  typedef std::unordered_map<unsigned int, PictureId> HandleIds;
+  typedef std::unordered_map<std::string, unsigned int> GroupIds;
+  typedef std::unordered_map<std::string, unsigned int> GroupSizes;
+
   AtlasPreviews atlases;
+  AtlasCache baked;
+  std::vector<bool> bakedLoaded;
   StringArray picExentions;
   TextureCounter txCounters;
   CachedPictures resources;  // key=image name, value=picture
+  Groups groups;
+  Picture invalid;
+  HandleIds handleIds;  // key=hash of name, only for id(name)
+  GroupIds groupIds;    // key=prefix, value=index in groups
+  GroupSizes indexed;   // key=prefix, value=pictures of group found in atlas indexes
 
   struct {
     std::string rc;
@@ -75,10 +109,32 @@ public:
 public:
   Picture tryLoadPicture( const std::string& name );
   void loadAtlas(const vfs::Path& filename );
+  void loadBakedAtlas( unsigned int index );
   void setPicture( const std::string &name, const Picture& pic );
   void destroyUnusableTextures();
+  void addIndexed( const std::string& name );
 };
 
+void PictureBank::Impl::addIndexed( const std::string& name )
+{
+  // name looks like prefix_00042 and may have extension
+  std::string::size_type pos = name.find_last_of( '_' );
+  if( pos == std::string::npos || pos + 1 >= name.size() )
+    return;
+
+  unsigned int index = 0;
+  for( std::string::size_type k = pos + 1; k < name.size() && name[ k ] != '.'; k++ )
+  {
+    if( name[ k ] < '0' || name[ k ] > '9' || index > indexMask )
+      return;
+
+    index = index * 10 + ( name[ k ] - '0' );
+  }
+
+  unsigned int& size = indexed[ name.substr( 0, pos ) ];
+  size = std::max( size, index + 1 );
+}
+
 void PictureBank::Impl::setPicture( const std::string &name, const Picture& pic )
 {
   int dot_pos = name.find_last_of('.');
@@ -167,6 +223,7 @@ void PictureBank::addAtlas( const std::string& filename )
     {
       unsigned int hash = Hash( i.first );
       atlas.images.insert( hash );
+      _d->addIndexed( i.first );
     }
 
     _d->atlases.push_back( atlas );
@@ -198,11 +255,79 @@ Picture& PictureBank::getPicture(const std::string &name)
 
 Picture& PictureBank::getPicture(const std::string& prefix, const int idx)
 {
-  _d->cache.rc = utils::format( 0xff, "%s_%05d", prefix.c_str(), idx );
+  if( idx < 0 )
+  {
+    _d->cache.rc = utils::format( 0xff, "%s_%05d", prefix.c_str(), idx );
+    return getPicture( _d->cache.rc );
+  }
+
+  // group table grows in place, so names are formatted once per group index
+  if( idx <= (int)Impl::indexMask )
+    return get( range( prefix, idx + 1 )[ idx ] );
 
+  _d->cache.rc = utils::format( 0xff, "%s_%05d", prefix.c_str(), idx );
   return getPicture( _d->cache.rc );
 }
 
+PictureId PictureBank::id(const std::string& name)
+{
+  unsigned int hash = Hash( name );
+  Impl::HandleIds::iterator it = _d->handleIds.find( hash );
+  if( it != _d->handleIds.end() )
+    return it->second;
+
+  Impl::Handles& names = _d->groups.front().handles;
+  PictureId ret = names.size();
+  names.push_back( Impl::Handle{ name, 0 } );
+  _d->handleIds[ hash ] = ret;
+  return ret;
+}
+
+PictureRange PictureBank::range(const std::string& prefix, unsigned int count)
+{
+  unsigned int& groupId = _d->groupIds[ prefix ];
+  if( groupId == 0 )
+  {
+    groupId = _d->groups.size();
+    _d->groups.push_back( Impl::Group{ prefix, Impl::Handles() } );
+
+    // whole group from atlases is reserved at once, so it seldom grows later
+    Impl::GroupSizes::iterator it = _d->indexed.find( prefix );
+    if( it != _d->indexed.end() )
+      count = std::max( count, it->second );
+  }
+
+  Impl::Handles& handles = _d->groups[ groupId ].handles;
+  count = std::min<unsigned int>( count, Impl::indexMask + 1 );
+  if( handles.size() < count )
+    handles.resize( count, Impl::Handle{ std::string(), 0 } );
+
+  return PictureRange{ groupId << Impl::indexBits, (unsigned int)handles.size() };
+}
+
+Picture& PictureBank::get(PictureId id)
+{
+  unsigned int groupId = id >> Impl::indexBits;
+  unsigned int index = id & Impl::indexMask;
+  if( id == 0 || groupId >= _d->groups.size() )
+    return _d->invalid;
+
+  Impl::Group& group = _d->groups[ groupId ];
+  if( index >= group.handles.size() )
+    return _d->invalid;
+
+  Impl::Handle& handle = group.handles[ index ];
+  if( !handle.picture )
+  {
+    if( handle.name.empty() )
+      handle.name = utils::format( 0xff, "%s_%05d", group.prefix.c_str(), index );
+
+    handle.picture = &getPicture( handle.name );
+  }
+
+  return *handle.picture;
+}
+
 bool PictureBank::present(const std::string& prefix, const int idx) const
 {
   return false;
@@ -213,13 +338,60 @@ PictureBank::PictureBank() : _d( new Impl )
   _d->picExentions << ".png";
   _d->picExentions << ".bmp";
   _d->cache.rc.reserve( 128 );
+  // group of single names, its first handle is invalid picture
+  _d->groups.push_back( Impl::Group{ std::string(), Impl::Handles( 1, Impl::Handle{ std::string(), 0 } ) } );
 }
 
 PictureBank::~PictureBank(){}
 
 
+bool PictureBank::openAtlasCache( const vfs::Directory& dir, const std::string& signature )
+{
+  bool opened = _d->baked.open( dir, signature );
+  _d->bakedLoaded.assign( _d->baked.atlasCount(), false );
+  for( auto& frame : _d->baked.frames() )
+    _d->addIndexed( frame.name );
+  return opened;
+}
+
+void PictureBank::Impl::loadBakedAtlas( unsigned int index )
+{
+  bakedLoaded[ index ] = true;
+
+  vfs::NFile file = vfs::NFile::open( baked.texture( index ) );
+  Picture mainTexture = file.isOpen()
+                          ? PictureLoader::instance().load( file )
+                          : Picture::getInvalid();
+  if( !mainTexture.isValid() )
+  {
+    Logger::warning( "PictureBank: can't load baked atlas " + baked.texture( index ).toString() );
+    return;
+  }
+
+  // pictures which were set before have priority over baked ones
+  for( auto& frame : baked.frames() )
+  {
+    if( frame.atlas != index || resources.count( frame.hash ) )
+      continue;
+
+    Picture pic = mainTexture;
+    pic.setOriginRect( frame.rect );
+    setPicture( frame.name, pic );
+  }
+}
+
 Picture PictureBank::Impl::tryLoadPicture(const std::string& name)
 {
+  const AtlasCache::Frame* frame = baked.find( Hash( name ) );
+  if( frame && !bakedLoaded[ frame->atlas ] )
+  {
+    loadBakedAtlas( frame->atlas );
+
+    CachedPictures::iterator it = resources.find( frame->hash );
+    if( it != resources.end() )
+      return it->second;
+  }
+
   vfs::Path realPath( name );
 
   bool fileExist = false;
@@ -19,13 +19,25 @@
 #define __CAESARIA_PICTURE_BANK_H_INCLUDED__
 
 #include "picture.hpp"
+#include "predefinitions.hpp"
 #include "core/scopedptr.hpp"
 #include "core/singleton.hpp"
+#include "vfs/directory.hpp"
 
 // loads pictures from files
 namespace gfx
 {
 
+//! handles of one resource group, picture prefix_N has handle first+N
+//! while N is less than count, group may grow later but handles stay the same
+struct PictureRange
+{
+  PictureId first;
+  unsigned int count;
+
+  PictureId operator[]( int index ) const { return ( index >= 0 && index < (int)count ) ? first + index : 0; }
+};
+
 class PictureBank : public StaticSingleton<PictureBank>
 {
   SET_STATICSINGLETON_FRIEND_FOR(PictureBank)
@@ -38,11 +50,24 @@ public:
   void addAtlas(const std::string& filename);
   void loadAtlas(const std::string& filename);
 
+  //! pictures found in baked atlases are taken from there before disk lookup
+  bool openAtlasCache( const vfs::Directory& dir, const std::string& signature );
+
   // show resource
   Picture& getPicture(const std::string &name);
 
   // show resource
   Picture& getPicture(const std::string &prefix, const int idx);
+
+  //! name is resolved once, handle stays valid for whole session
+  PictureId id( const std::string& name );
+
+  //! handles for prefix_00000 .. prefix_{count-1} and at least every picture of group
+  //! which atlases know about, resolve it once and keep
+  PictureRange range( const std::string& prefix, unsigned int count );
+
+  //! array lookup, picture is taken from bank on first use of handle
+  Picture& get( PictureId id );
   bool present( const std::string& prefix,const int idx ) const;
 
   ~PictureBank();
@@ -29,6 +29,10 @@ class TilesArray;
 class Renderer;
 typedef unsigned int ImgID;
 
+//! group of picture in high bits and its index in group in low bits, 0 is invalid picture
+typedef unsigned int PictureId;
+struct PictureRange;
+
 }
 
 #endif //__CAESARIA_GFX_PREDEFINITIONS_H_INCLUDED__
@@ -94,6 +94,7 @@ public:
   } metrics;
 
   Picture screen;
+  const Picture* target;
 
   SDL_Window* window;
   SDL_Renderer* renderer;
@@ -127,6 +128,7 @@ SdlEngine::SdlEngine() : Engine(), _d( new Impl )
 {
   resetColorMask();
 
+  _d->target = 0;
   _d->lastUpdateFps = DateTime::elapsedTime();
   _d->fps = 0;
 }
@@ -431,6 +433,50 @@ void SdlEngine::unloadPicture( Picture& ioPicture )
   ioPicture = Picture();
 }
 
+Picture SdlEngine::createTarget( const Size& size )
+{
+  // batches keep vertices scaled to screen, they can't be drawn 1:1 offscreen
+  if( _d->screenScale != 1.f || size.area() <= 0 )
+    return Picture();
+
+  SDL_Texture* tx = SDL_CreateTexture( _d->renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET,
+                                       size.width(), size.height() );
+  if( !tx )
+    return Picture();
+
+  SDL_SetTextureBlendMode( tx, SDL_BLENDMODE_BLEND );
+
+  Picture ret;
+  ret.init( tx, 0, 0 );
+  ret.setOriginRect( Rect( Point(), size ) );
+  return ret;
+}
+
+void SdlEngine::setTarget( const Picture* target, const Point& origin )
+{
+  // batched pictures belong to previous target
+  bool needDraw = _d->batcher.finish();
+  if( needDraw )
+    _d->renderState();
+
+  if( target && target->texture() )
+  {
+    SDL_SetRenderTarget( _d->renderer, target->texture() );
+    SDL_SetRenderDrawColor( _d->renderer, 0, 0, 0, 0 );
+    SDL_RenderClear( _d->renderer );
+
+    // viewport is moved so widgets keep drawing in screen coordinates
+    SDL_Rect viewport = { -origin.x(), -origin.y(), target->width() + origin.x(), target->height() + origin.y() };
+    SDL_RenderSetViewport( _d->renderer, &viewport );
+    _d->target = target;
+  }
+  else
+  {
+    SDL_SetRenderTarget( _d->renderer, 0 );
+    _d->target = 0;
+  }
+}
+
 void SdlEngine::Impl::renderStart()
 {
   SDL_GetMouseState( &mousepos.rx(), &mousepos.ry() );
@@ -850,7 +896,8 @@ void SdlEngine::Impl::setClip(const Rect& clip)
   static SDL_Rect r;
 
   r.x = clip.left();
-  r.y = sheigth - clip.top() - clip.height();
+  // screen scissor counts rows from bottom, target rows go as is
+  r.y = target ? clip.top() : sheigth - clip.top() - clip.height();
   r.w = clip.width();
   r.h = clip.height();
 
@@ -55,6 +55,8 @@ public:
   virtual void loadPicture(Picture& ioPicture, bool streaming);
   virtual void updateBatch(Batch &batch, const Point &newpos);
   virtual void unloadPicture(Picture& ioPicture);
+  virtual Picture createTarget( const Size& size );
+  virtual void setTarget( const Picture* target, const Point& origin );
 
   virtual void draw(const Picture& picture, const int dx, const int dy, Rect* clipRect);
   virtual void draw(const Picture& picture, const Point& pos, Rect* clipRect );
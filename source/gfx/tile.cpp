@@ -23,8 +23,11 @@
 #include "core/utils.hpp"
 #include "core/logger.hpp"
 #include "imgid.hpp"
+#include "picture_bank.hpp"
 #include "gfx/tilemap_config.hpp"
 #include "gfx/tile_config.hpp"
+#include "gfx/tilemasks.hpp"
+#include "gfx/tileparams.hpp"
 #include "game/gamedate.hpp"
 
 namespace gfx
@@ -50,21 +53,54 @@ void Tile::Terrain::clear()
   deepWater  = false;
 }
 
-Tile::Tile( const TilePos& pos) //: _terrain( 0, 0, 0, 0, 0, 0 )
+Tile::RenderState::RenderState() : animation( 0 ), rendered( false ) {}
+Tile::RenderState::~RenderState() { delete animation; }
+
+Tile::Tile( const TilePos& pos, RenderState* render ) //: _terrain( 0, 0, 0, 0, 0, 0 )
+{
+  _pos = pos;
+  _master = NULL;
+  _ownRender = (render == NULL);
+  _render = _ownRender ? new RenderState() : render;
+  _overlay = NULL;
+  _masks = NULL;
+  _params = NULL;
+  _terrain.clear();
+  _terrain.imgid = 0;
+  _terrain.terraininfo = 0;
+  _height = 0;
+  setEPos( pos );
+}
+
+Tile::~Tile()
+{
+  if( _ownRender )
+    delete _render;
+}
+
+void Tile::reset(const TilePos& pos)
 {
   _pos = pos;
   _master = NULL;
-  _rendered = false;
+  if( _ownRender )
+  {
+    delete _render;
+    _render = new RenderState();
+  }
   _overlay = NULL;
+  _masks = NULL;
+  _params = NULL;
   _terrain.clear();
   _terrain.imgid = 0;
+  _terrain.terraininfo = 0;
   _height = 0;
   setEPos( pos );
 }
 
-void Tile::setPicture(const Picture& picture) {  _picture = picture; }
-void Tile::setPicture(const std::string& group, const int index){ _picture.load( group, index );}
-void Tile::setPicture(const std::string& name){ _picture.load( name );}
+void Tile::setPicture(const Picture& picture) {  _render->picture = picture; }
+void Tile::setPicture(const std::string& group, const int index){ _render->picture.load( group, index );}
+void Tile::setPicture(const std::string& name){ _render->picture.load( name );}
+void Tile::setPicture(PictureId id){ _render->picture = PictureBank::instance().get( id ); }
 void Tile::setMaster(Tile* master){  _master = master; }
 
 bool Tile::isFlat() const
@@ -85,7 +121,7 @@ bool Tile::isMaster() const{  return (_master == this);}
 void Tile::setEPos(const TilePos& epos)
 {
   _epos = epos;
-  _mappos = Point( config::tilemap.cell.size().width() * ( _epos.i() + _epos.j() ),
+  _render->mappos = Point( config::tilemap.cell.size().width() * ( _epos.i() + _epos.j() ),
                    config::tilemap.cell.size().height() * ( _epos.i() - _epos.j() ) - _height * config::tilemap.cell.size().height() );
 }
 
@@ -100,23 +136,39 @@ void Tile::changeDirection(Tile *masterTile, Direction newDirection)
   {
     int iid = tile::turnCoastTile( _terrain.imgid, newDirection );
 
-    _picture = iid == -1
-                ? Picture::getInvalid()
-                : imgid::toPicture( iid );
+    if( iid == -1 ) setPicture( Picture::getInvalid() );
+    else setPicture( imgid::toPictureId( iid ) );
   }
 }
 
 
 void Tile::animate(unsigned int time)
 {
-  if( _overlay.isNull() && _animation.isValid() )
+  Animation* animation = _render->animation;
+  if( _overlay.isNull() && animation && animation->isValid() )
   {
-    _animation.update( time );
+    animation->update( time );
   }
 }
 
-const Animation& Tile::animation() const{ return _animation; }
-void Tile::setAnimation(const Animation& animation){ _animation = animation; }
+const Animation& Tile::animation() const
+{
+  return _render->animation ? *_render->animation : invalidAnimation;
+}
+
+void Tile::setAnimation(const Animation& animation)
+{
+  if( animation.isValid() )
+  {
+    if( _render->animation ) *_render->animation = animation;
+    else _render->animation = new Animation( animation );
+  }
+  else
+  {
+    delete _render->animation;
+    _render->animation = NULL;
+  }
+}
 
 bool Tile::isWalkable( bool alllands ) const
 {
@@ -156,7 +208,7 @@ bool Tile::getFlag(Tile::Type type) const
   case tlGarden: return _terrain.garden;
   case tlElevation: return _terrain.elevation;
   case tlWall: return _terrain.wall;
-  case isRendered: return _rendered;
+  case isRendered: return _render->rendered;
   case tlDeepWater: return _terrain.deepWater;
   default: break;
   }
@@ -180,26 +232,56 @@ void Tile::setFlag(Tile::Type type, bool value)
   case clearAll:
   {
     _terrain.clear();
-    _params.clear();
+    if( _params )
+      _params->clear( _pos.i(), _pos.j() );
   }
   break;
   case tlWall: _terrain.wall = value; break;
-  case isRendered: _rendered = value; break;
+  case isRendered: _render->rendered = value; break;
   case tlDeepWater: _terrain.deepWater = value; break;
   default: break;
   }
+
+  if( type != isRendered )
+    updateMask();
 }
 
 OverlayPtr Tile::overlay() const  { return _overlay;}
-void Tile::setOverlay(OverlayPtr overlay){  _overlay = overlay;}
+void Tile::setOverlay(OverlayPtr overlay)
+{
+  _overlay = overlay;
+  updateMask();
+
+  if( _masks )
+    _masks->overlayChanged( i(), j() );
+}
+
+void Tile::setMasks(TileMasks* masks) { _masks = masks; updateMask(); }
+void Tile::setParamsStorage(TileParams* params) { _params = params; }
+
+void Tile::updateMask()
+{
+  if( _masks )
+    _masks->update( *this );
+}
+
 void Tile::setImgId(ImgID id){  _terrain.imgid = id;}
-void Tile::setParam(Param param, int value) { _params[ param ] = value; }
-void Tile::changeParam(Param param, int value) { _params[ param ] += value; }
+
+void Tile::setParam(Param param, int value)
+{
+  if( _params )
+    _params->set( param, _pos.i(), _pos.j(), value );
+}
+
+void Tile::changeParam(Param param, int value)
+{
+  if( _params )
+    _params->change( param, _pos.i(), _pos.j(), value );
+}
 
 int Tile::param( Param param) const
 {
-  auto it = _params.find( param );
-  return it != _params.end() ? it->second : 0;
+  return _params ? _params->get( param, _pos.i(), _pos.j() ) : 0;
 }
 
 }//end namespace gfx
@@ -28,6 +28,9 @@
 namespace gfx
 {
 
+class TileMasks;
+class TileParams;
+
 // a Tile in the Tilemap
 class Tile
 {
@@ -39,37 +42,61 @@ public:
                  isRendered, tlUnknown } Type;
 
 public:
+  // terrain flags are packed into one word, decode()/encode() keep
+  // the save format, so bit order here is free to change
   struct Terrain
   {
-    bool water;
-    bool rock;
-    bool tree;
-    bool road;
-    bool garden;
-    bool meadow;
-    bool elevation;
-    bool rubble;
-    bool wall;
-    bool coast;
-    bool deepWater;
+    bool water : 1;
+    bool rock : 1;
+    bool tree : 1;
+    bool road : 1;
+    bool garden : 1;
+    bool meadow : 1;
+    bool elevation : 1;
+    bool rubble : 1;
+    bool wall : 1;
+    bool coast : 1;
+    bool deepWater : 1;
 
     /*
      * original tile information
      */
-    ImgID imgid;
     unsigned short int terraininfo;
+    ImgID imgid;
 
     void clear();
   };
 
-  explicit Tile(const TilePos& pos);
+  // picture and animation are needed for drawing only,
+  // the tilemap keeps them in own array parallel to tiles
+  struct RenderState
+  {
+    Picture picture;
+    Point mappos;
+    Animation* animation;  // created for animated tiles only
+    bool rendered;
+
+    RenderState();
+    ~RenderState();
+
+  private:
+    RenderState( const RenderState& );
+    RenderState& operator=( const RenderState& );
+  };
+
+  // tile without external render state creates own one
+  explicit Tile(const TilePos& pos, RenderState* render=0 );
+  ~Tile();
+
+  // returns tile to the state it had after construction at given position
+  void reset( const TilePos& pos );
 
   // tile coordinates
   inline int i() const { return _pos.i(); }
   inline int j() const { return _pos.j(); }
   inline const TilePos& pos() const{ return _pos; }
   inline const TilePos& epos() const { return _epos; }
-  inline const Point& mappos() const { return _mappos; }
+  inline const Point& mappos() const { return _render->mappos; }
 
   inline const OverlayPtr& rov() const { return _overlay; }
   void setEPos( const TilePos& epos );
@@ -80,7 +107,8 @@ public:
   void setPicture( const Picture& picture );
   void setPicture( const std::string& name );
   void setPicture( const std::string& group, const int index );
-  inline const Picture& picture() const { return _picture; }
+  void setPicture( PictureId id );
+  inline const Picture& picture() const { return _render->picture; }
 
   // used for multi-tile graphics: current displayed picture
   // background of constructible tiles is 1x1 => master used for foreground
@@ -93,9 +121,9 @@ public:
 
   bool isFlat() const;  // returns true if the tile is walkable/boatable (for display purpose)
 
-  inline void resetRendered()  { _rendered = false; }
-  inline void setRendered()    { _rendered = true;  }
-  inline bool rendered() const { return _rendered; }
+  inline void resetRendered()  { _render->rendered = false; }
+  inline void setRendered()    { _render->rendered = true;  }
+  inline bool rendered() const { return _render->rendered; }
 
   void animate( unsigned int time );
 
@@ -110,6 +138,16 @@ public:
   const Terrain& terrain() const { return _terrain; }
 
   void setOverlay( OverlayPtr overlay );
+
+  // walkability bits are cached by the owning tilemap,
+  // overlays which change isWalkable() on the fly must call updateMask()
+  void setMasks( TileMasks* masks );
+  void updateMask();
+
+  // parameters live in planes of the owning tilemap,
+  // tile without storage reads zeros and ignores changes
+  void setParamsStorage( TileParams* params );
+
   inline ImgID imgId() const { return _terrain.imgid;}
   void setImgId( ImgID id );
 
@@ -125,20 +163,20 @@ public:
   OverlayPtr overlay() const;
 
 private:
-  std::map<Param, int> _params;
   TilePos _pos; // absolute coordinates
   TilePos _epos; // effective coordinates
-  Point _mappos;
   Tile* _master;  // left-most tile if multi-tile, or "this" if single-tile
   Terrain _terrain; // infos about the tile (building, tree, road, water, rock...)
-  Picture _picture; // main picture
-  bool _rendered;
   int _height;
-  Animation _animation;
+  bool _ownRender;
+  RenderState* _render;
   OverlayPtr _overlay;
+  TileMasks* _masks;
+  TileParams* _params;
 
 private:
   Tile( const Tile& base );
+  Tile& operator=( const Tile& base );
 };
 
 }//end namespace gfx
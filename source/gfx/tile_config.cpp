@@ -165,7 +165,7 @@ Tile& getInvalidSafe()
   static Tile invalidTileSafe( TilePos::invalid() );
   if( config::tilemap.isValidLocation( invalidTileSafe.pos() ) )
   {
-    invalidTileSafe = Tile( TilePos::invalid() );
+    invalidTileSafe.reset( TilePos::invalid() );
     Logger::warning( "!!! Function getInvalidSafe call" );
   }
 
@@ -21,6 +21,8 @@
 #include "imgid.hpp"
 #include "gfx/tile_config.hpp"
 #include "gfx/tilemap_config.hpp"
+#include "gfx/tilemasks.hpp"
+#include "gfx/tileparams.hpp"
 #include "objects/building.hpp"
 #include "core/exception.hpp"
 #include "core/position.hpp"
@@ -29,6 +31,8 @@
 #include "core/variant_map.hpp"
 #include "core/utils.hpp"
 #include "core/logger.hpp"
+#include <new>
+#include <type_traits>
 
 using namespace direction;
 
@@ -65,12 +69,53 @@ public:
 
 class TileRow : public TilesArray
 {
+};
+
+// map tiles are placed in one block, their render states
+// in another one with same order, rows keep pointers only
+class TileStorage
+{
 public:
-  ~TileRow()
+  TileStorage() : _count( 0 ), _capacity( 0 ) {}
+  ~TileStorage() { clear(); }
+
+  void reserve( unsigned int capacity )
+  {
+    clear();
+    _capacity = capacity;
+    _tiles.reset( capacity > 0 ? new Slot[ capacity ] : 0 );
+    _render.reset( capacity > 0 ? new Tile::RenderState[ capacity ] : 0 );
+  }
+
+  Tile* append( const TilePos& pos )
   {
-    for( auto&& tile : *this )
-      delete tile;
+    _GAME_DEBUG_BREAK_IF( _count >= _capacity );
+    Tile* tile = new (&_tiles[ _count ]) Tile( pos, &_render[ _count ] );
+    _count++;
+    return tile;
   }
+
+  void clear()
+  {
+    for( unsigned int index=0; index < _count; index++ )
+      reinterpret_cast<Tile*>( &_tiles[ index ] )->~Tile();
+
+    _tiles.reset();
+    _render.reset();
+    _count = 0;
+    _capacity = 0;
+  }
+
+  unsigned int coreBytes() const { return _capacity * sizeof(Slot); }
+  unsigned int renderBytes() const { return _capacity * sizeof(Tile::RenderState); }
+
+private:
+  typedef std::aligned_storage<sizeof(Tile), alignof(Tile)>::type Slot;
+
+  ScopedArrayPtr<Slot> _tiles;
+  ScopedArrayPtr<Tile::RenderState> _render;
+  unsigned int _count;
+  unsigned int _capacity;
 };
 
 class TileGrid : public Array<TileRow>
@@ -89,6 +134,9 @@ public:
   typedef std::map<Tile*, TurnInfo> MasterTiles;
   TilesArray mapBorder;
   ClimateType climate;
+  TileMasks masks;
+  TileParams params;
+  TileStorage storage;
 
   struct {
     std::map<int,Tile*> tiles;
@@ -113,6 +161,7 @@ public:
   void set( int i, int j, Tile* v );
   void saveMasterTiles( MasterTiles& mtiles );
   void checkCoastAfterTurn();
+  void restoreTile( Tile& tile, int bitset, int desirability, int imgId );
 };
 
 Tilemap::Tilemap() : _d( new Impl )
@@ -435,36 +484,71 @@ void Tilemap::load( const VariantMap& stream )
   int index = 0;
   for( auto tile : tiles )
   {
-    tile::decode( *tile, bitsetAr[index] );
-    tile->setParam( Tile::pDesirability, desAr[index] );
+    _d->restoreTile( *tile, bitsetAr[index], desAr[index], imgIdAr[index] );
+    index++;
+  }
+}
 
-    int imgId = imgIdAr[index];
-    if( !tile->master() && imgId != 0 )
-    {
-      Picture pic = imgid::toPicture( imgId );
+void Tilemap::savePlanes( std::vector<int32_t>& bitset, std::vector<int16_t>& desirability,
+                          std::vector<int16_t>& imgId ) const
+{
+  const TilesArray& tiles = allTiles();
+  bitset.resize( tiles.size() );
+  desirability.resize( tiles.size() );
+  imgId.resize( tiles.size() );
 
-      tile->setImgId( imgId );
+  int index = 0;
+  for( const auto& tile : tiles )
+  {
+    bitset[ index ] = tile::encode( *tile );
+    desirability[ index ] = tile->param( Tile::pDesirability );
+    imgId[ index ] = tile->imgId();
+    index++;
+  }
+}
+
+void Tilemap::loadPlanes( int size, const int32_t* bitset, const int16_t* desirability, const int16_t* imgId )
+{
+  resize( size );
+
+  TilesArray tiles = allTiles();
+  int index = 0;
+  for( auto tile : tiles )
+  {
+    _d->restoreTile( *tile, bitset[index], desirability[index], imgId[index] );
+    index++;
+  }
+}
 
-      int tile_size = (pic.width()+2) / _d->virtWidth;  // size of the multi-tile. the multi-tile is a square.
+void Tilemap::Impl::restoreTile( Tile& tile, int bitset, int desirability, int imgId )
+{
+  tile::decode( tile, bitset );
+  tile.setParam( Tile::pDesirability, desirability );
+
+  if( !tile.master() && imgId != 0 )
+  {
+    Picture pic = imgid::toPicture( imgId );
 
-      tile_size = math::clamp<int>( tile_size, 1, 10 );
+    tile.setImgId( imgId );
 
-      // master is the left-most subtile
-      Tile* master = (tile_size == 1) ? NULL : tile;
+    int tile_size = (pic.width()+2) / virtWidth;  // size of the multi-tile. the multi-tile is a square.
 
-      for ( int di = 0; di<tile_size; ++di )
+    tile_size = math::clamp<int>( tile_size, 1, 10 );
+
+    // master is the left-most subtile
+    Tile* master = (tile_size == 1) ? NULL : &tile;
+
+    for ( int di = 0; di<tile_size; ++di )
+    {
+      // for each subrow of the multi-tile
+      for (int dj = 0; dj<tile_size; ++dj)
       {
-        // for each subrow of the multi-tile
-        for (int dj = 0; dj<tile_size; ++dj)
-        {
-          // for each subcol of the multi-tile
-          Tile &sub_tile = at( tile->pos() + TilePos( di, dj ) );
-          sub_tile.setMaster( master );
-          sub_tile.setPicture( pic );
-        }
+        // for each subcol of the multi-tile
+        Tile &sub_tile = at( tile.pos() + TilePos( di, dj ) );
+        sub_tile.setMaster( master );
+        sub_tile.setPicture( pic );
       }
     }
-    index++;
   }
 }
 
@@ -601,6 +685,9 @@ void Tilemap::setFlag(Flag flag, bool enabled)
 }
 
 Direction Tilemap::direction() const { return _d->direction; }
+const TileMasks& Tilemap::masks() const { return _d->masks; }
+TileParams& Tilemap::params() { return _d->params; }
+const TileParams& Tilemap::params() const { return _d->params; }
 
 Tilemap::~Tilemap(){}
 
@@ -633,8 +720,12 @@ void Tilemap::Impl::resize(const int s)
   size = s;
 
   // resize the tile array
+  TileGrid::clear();
   TileGrid::resize( size );
+  storage.reserve( size * size );
   SvkBorderConfig::instance().init();
+  masks.resize( size );
+  params.resize( size );
 
   for( int i = 0; i < size; ++i )
   {
@@ -642,9 +733,18 @@ void Tilemap::Impl::resize(const int s)
 
     for (int j = 0; j < size; ++j)
     {
-      (*this)[i].push_back( new Tile( TilePos( i, j ) ));
+      Tile* tile = storage.append( TilePos( i, j ) );
+      tile->setMasks( &masks );
+      tile->setParamsStorage( &params );
+      (*this)[i].push_back( tile );
     }
   }
+
+  if( size > 0 )
+  {
+    Logger::debug( "Tilemap: {0} tiles use {1} KB for core and {2} KB for render state",
+                   size * size, storage.coreBytes() / 1024, storage.renderBytes() / 1024 );
+  }
 }
 
 void Tilemap::Impl::set(int i, int j, Tile* v)
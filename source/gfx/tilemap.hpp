@@ -25,10 +25,15 @@
 #include "core/scopedptr.hpp"
 #include "core/direction.hpp"
 #include "game/climate.hpp"
+#include <stdint.h>
+#include <vector>
 
 namespace gfx
 {
 
+class TileMasks;
+class TileParams;
+
 // Square Map of the Tiles.
 class Tilemap : public Serializable
 {
@@ -91,12 +96,20 @@ public:
   void save( VariantMap& stream) const;
   void load( const VariantMap& stream);
 
+  // raw planes in allTiles() order, used by binary saves
+  void savePlanes( std::vector<int32_t>& bitset, std::vector<int16_t>& desirability,
+                   std::vector<int16_t>& imgId ) const;
+  void loadPlanes( int size, const int32_t* bitset, const int16_t* desirability, const int16_t* imgId );
+
   void turnRight();
   void turnLeft();
 
   void setFlag(Flag flag, bool enabled);
 
   Direction direction() const;
+  const TileMasks& masks() const;
+  TileParams& params();
+  const TileParams& params() const;
 
   TilePos fit( const TilePos& pos ) const;
 
@@ -0,0 +1,121 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "tilemasks.hpp"
+#include "tile.hpp"
+#include "tilemap.hpp"
+#include "tilesarray.hpp"
+#include "core/math.hpp"
+#include <algorithm>
+
+namespace gfx
+{
+
+namespace {
+// side of square area which shares one overlays revision
+static const int chunkSize = 16;
+}
+
+TileMasks::TileMasks() : _size( 0 ), _chunks( 0 ), _roadRevision( 0 ), _overlaysRevision( 0 ) {}
+
+void TileMasks::resize(int size)
+{
+  _size = size;
+  _chunks = ( size + chunkSize - 1 ) / chunkSize;
+  _data.assign( size * size, 0 );
+  // old areas must not look actual on new map
+  _chunkRevisions.assign( _chunks * _chunks, _overlaysRevision + 1 );
+  _roadRevision++;
+  _overlaysRevision++;
+}
+
+void TileMasks::overlayChanged( int i, int j )
+{
+  _overlaysRevision++;
+  if( isInside( i, j ) )
+    _chunkRevisions[ ( j / chunkSize ) * _chunks + i / chunkSize ]++;
+}
+
+unsigned int TileMasks::overlaysRevision( const TilePos& start, const TilePos& stop ) const
+{
+  if( _size == 0 )
+    return _overlaysRevision;
+
+  int ci0 = math::clamp( std::min( start.i(), stop.i() ), 0, _size - 1 ) / chunkSize;
+  int cj0 = math::clamp( std::min( start.j(), stop.j() ), 0, _size - 1 ) / chunkSize;
+  int ci1 = math::clamp( std::max( start.i(), stop.i() ), 0, _size - 1 ) / chunkSize;
+  int cj1 = math::clamp( std::max( start.j(), stop.j() ), 0, _size - 1 ) / chunkSize;
+
+  // counters only grow, so sum changes whenever one of them does
+  unsigned int ret = 0;
+  for( int cj = cj0; cj <= cj1; cj++ )
+    for( int ci = ci0; ci <= ci1; ci++ )
+      ret += _chunkRevisions[ cj * _chunks + ci ];
+
+  return ret;
+}
+
+void TileMasks::update(const Tile& tile)
+{
+  const int i = tile.i();
+  const int j = tile.j();
+  if( !isInside( i, j ) )
+    return;
+
+  unsigned char mask = 0;
+  if( tile.isWalkable( false ) ) mask |= road;
+  if( tile.isWalkable( true ) )  mask |= terrain;
+  if( tile.getFlag( Tile::tlWater ) ) mask |= water;
+  if( tile.getFlag( Tile::tlDeepWater ) ) mask |= deepWater;
+
+  unsigned int idx = index( i, j );
+  if( (_data[ idx ] ^ mask) & road )
+    _roadRevision++;
+
+  _data[ idx ] = mask;
+
+  _link( idx, i, j+1, linkNorth, linkSouth );
+  _link( idx, i+1, j, linkEast, linkWest );
+  _link( idx, i, j-1, linkSouth, linkNorth );
+  _link( idx, i-1, j, linkWest, linkEast );
+}
+
+void TileMasks::update(const Tilemap& tilemap)
+{
+  resize( tilemap.size() );
+
+  TilesArray tiles = tilemap.allTiles();
+  for( auto tile : tiles )
+    update( *tile );
+}
+
+void TileMasks::_link(unsigned int idx, int ni, int nj, int bit, int nbit)
+{
+  if( !isInside( ni, nj ) )
+    return;
+
+  unsigned char& nmask = _data[ index( ni, nj ) ];
+  if( (_data[ idx ] & road) && (nmask & road) )
+  {
+    _data[ idx ] |= bit;
+    nmask |= nbit;
+  }
+  else
+  {
+    nmask &= ~nbit;
+  }
+}
+
+}//end namespace gfx
@@ -0,0 +1,73 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __CAESARIA_TILEMASKS_H_INCLUDED__
+#define __CAESARIA_TILEMASKS_H_INCLUDED__
+
+#include "tilepos.hpp"
+#include "predefinitions.hpp"
+#include <vector>
+
+namespace gfx
+{
+
+// Packed per-tile walkability bits, row-major (j * size + i).
+// Tiles created by the tilemap keep their own byte up to date
+// whenever terrain flags or overlay change.
+class TileMasks
+{
+public:
+  typedef enum { road=0x1, terrain=0x2, water=0x4, deepWater=0x8,
+                 linkNorth=0x10, linkEast=0x20, linkSouth=0x40, linkWest=0x80,
+                 links=0xf0 } Flag;
+
+  TileMasks();
+
+  void resize( int size );
+  void update( const Tile& tile );
+  void update( const Tilemap& tilemap );
+
+  inline int size() const { return _size; }
+  inline bool isInside( int i, int j ) const { return i >= 0 && j >= 0 && i < _size && j < _size; }
+  inline unsigned int index( int i, int j ) const { return j * _size + i; }
+  inline unsigned char at( unsigned int index ) const { return _data[ index ]; }
+  inline unsigned char at( int i, int j ) const { return isInside( i, j ) ? _data[ index( i, j ) ] : 0; }
+  inline bool is( int i, int j, Flag flag ) const { return (at( i, j ) & flag) != 0; }
+  inline bool is( const TilePos& pos, Flag flag ) const { return is( pos.i(), pos.j(), flag ); }
+
+  /** Grows every time some tile gains or loses the road bit */
+  inline unsigned int roadRevision() const { return _roadRevision; }
+
+  /** Grows every time some tile gets another overlay */
+  inline unsigned int overlaysRevision() const { return _overlaysRevision; }
+
+  /** Changes only when some tile of area between start and stop gets another overlay */
+  unsigned int overlaysRevision( const TilePos& start, const TilePos& stop ) const;
+  void overlayChanged( int i, int j );
+
+private:
+  void _link( unsigned int index, int ni, int nj, int bit, int nbit );
+
+  int _size;
+  int _chunks;  // chunks in row
+  unsigned int _roadRevision;
+  unsigned int _overlaysRevision;
+  std::vector<unsigned char> _data;
+  std::vector<unsigned int> _chunkRevisions;
+};
+
+}//end namespace gfx
+
+#endif //__CAESARIA_TILEMASKS_H_INCLUDED__
@@ -0,0 +1,73 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "tileparams.hpp"
+
+namespace gfx
+{
+
+namespace {
+static const unsigned int cacheLine = 64;
+static const unsigned int valuesInLine = cacheLine / sizeof(TileParams::Value);
+}
+
+TileParams::TileParams() : _size( 0 ), _stride( 0 ), _offset( 0 ) {}
+
+void TileParams::resize( int size )
+{
+  _size = size;
+  _stride = ( size * size + valuesInLine - 1 ) / valuesInLine * valuesInLine;
+  _data.assign( _stride * Tile::pBasicCount + valuesInLine, 0 );
+
+  size_t address = (size_t)_data.data();
+  _offset = ( ( cacheLine - address % cacheLine ) % cacheLine ) / sizeof(Value);
+}
+
+void TileParams::clear( int i, int j )
+{
+  if( !isInside( i, j ) )
+    return;
+
+  unsigned int idx = index( i, j );
+  for( int param=0; param < Tile::pBasicCount; param++ )
+    _plane( (Tile::Param)param )[ idx ] = 0;
+}
+
+void TileParams::set( Tile::Param param, int i, int j, int value )
+{
+  if( isInside( i, j ) )
+    _plane( param )[ index( i, j ) ] = fit( value );
+}
+
+void TileParams::change( Tile::Param param, int i, int j, int delta )
+{
+  if( isInside( i, j ) )
+  {
+    Value& value = _plane( param )[ index( i, j ) ];
+    value = fit( value + delta );
+  }
+}
+
+TileParams::Plane TileParams::plane( Tile::Param param )
+{
+  return Plane( _data.empty() ? 0 : _plane( param ), _size );
+}
+
+TileParams::ConstPlane TileParams::plane( Tile::Param param ) const
+{
+  return ConstPlane( _data.empty() ? 0 : _plane( param ), _size );
+}
+
+}//end namespace gfx
@@ -0,0 +1,95 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __CAESARIA_TILEPARAMS_H_INCLUDED__
+#define __CAESARIA_TILEPARAMS_H_INCLUDED__
+
+#include "tile.hpp"
+#include <vector>
+
+namespace gfx
+{
+
+// Tile parameters (water, desirability, dirt, iron) kept as dense
+// planes, one per Tile::Param, row-major (j * size + i).
+// Every plane starts on its own cache line.
+class TileParams
+{
+public:
+  typedef short Value;
+  enum { minValue=-32768, maxValue=32767 };
+
+  // linear view over one plane, rows go along i
+  template<class T>
+  class PlaneT
+  {
+  public:
+    PlaneT( T* data, int size ) : _data( data ), _size( size ) {}
+
+    inline int size() const { return _size; }
+    inline T* begin() const { return _data; }
+    inline T* end() const { return _data + _size * _size; }
+    inline T* row( int j ) const { return _data + j * _size; }
+    inline T& operator[]( unsigned int index ) const { return _data[ index ]; }
+
+  private:
+    T* _data;
+    int _size;
+  };
+
+  typedef PlaneT<Value> Plane;
+  typedef PlaneT<const Value> ConstPlane;
+
+  TileParams();
+
+  void resize( int size );
+
+  /** Reset all parameters of tile to zero */
+  void clear( int i, int j );
+
+  inline int size() const { return _size; }
+  inline bool isInside( int i, int j ) const { return i >= 0 && j >= 0 && i < _size && j < _size; }
+  inline unsigned int index( int i, int j ) const { return j * _size + i; }
+
+  inline int get( Tile::Param param, int i, int j ) const
+  {
+    return isInside( i, j ) ? _plane( param )[ index( i, j ) ] : 0;
+  }
+
+  /** Fit value into storage range */
+  static inline Value fit( int value )
+  {
+    return (Value)( value < minValue ? minValue : ( value > maxValue ? maxValue : value ) );
+  }
+
+  void set( Tile::Param param, int i, int j, int value );
+  void change( Tile::Param param, int i, int j, int delta );
+
+  Plane plane( Tile::Param param );
+  ConstPlane plane( Tile::Param param ) const;
+
+private:
+  inline Value* _plane( Tile::Param param ) { return &_data[ _offset + param * _stride ]; }
+  inline const Value* _plane( Tile::Param param ) const { return &_data[ _offset + param * _stride ]; }
+
+  int _size;
+  unsigned int _stride;  // plane length rounded up to cache line
+  unsigned int _offset;  // first element on cache line boundary
+  std::vector<Value> _data;
+};
+
+}//end namespace gfx
+
+#endif //__CAESARIA_TILEPARAMS_H_INCLUDED__
@@ -65,7 +65,7 @@ Storage::Storage() : _gsd( new Impl )
   _gsd->reset();
 }
 
-void Storage::setCapacity(const int maxQty) { _gsd->capacity = maxQty;}
+void Storage::setCapacity(const int maxQty) { _gsd->capacity = maxQty; _changed(); }
 int Storage::capacity() const {  return _gsd->capacity; }
 
 int Storage::qty() const
@@ -77,7 +77,11 @@ int Storage::qty() const
   return qty;
 }
 
-good::Stock& Storage::getStock(const Product& goodType){  return *(_gsd->stocks[goodType].object());}
+good::Stock& Storage::getStock(const Product& goodType)
+{
+  _changed();
+  return *(_gsd->stocks[goodType].object());
+}
 
 ProductMap Storage::details() const
 {
@@ -104,9 +108,11 @@ void Storage::setCapacity(const good::Product& goodType, const int maxQty)
   {
     _gsd->stocks[goodType]->setCapacity( maxQty );
   }
+
+  _changed();
 }
 
-void Storage::setQty(const good::Product& goodType, const int currentQty){  _gsd->stocks[goodType]->setQty( currentQty );}
+void Storage::setQty(const good::Product& goodType, const int currentQty){  _gsd->stocks[goodType]->setQty( currentQty ); _changed(); }
 
 int Storage::getMaxStore(const good::Product goodType)
 {
@@ -152,6 +158,7 @@ bool Storage::applyStorageReservation(good::Stock &stock, const int reservationI
   int amount = reservedStock.qty();
   _gsd->stocks[ reservedStock.type() ]->push( amount );
   stock.pop( amount );
+  _changed();
   return true;
 }
 
@@ -175,6 +182,7 @@ bool Storage::applyRetrieveReservation(good::Stock& stock, const int reservation
   good::Stock& currentStock = getStock(reservedStock.type());
   currentStock.pop( amount );
   stock.push( amount );
+  _changed();
   return true;
 }
 
@@ -217,6 +225,8 @@ void Storage::load( const VariantMap& stream )
     stock->load( sotckInfo.toList() );
     _gsd->stocks[ stock->type() ] = stock;
   }
+
+  _changed();
 }
 
 Storage::~Storage(){}
@@ -39,6 +39,7 @@ public:
 
   void resize( const Store& other );
 
+  // drops store index, so don't keep returned stock between store queries
   good::Stock& getStock(const good::Product &goodType);
   virtual ProductMap details() const;
 
@@ -24,6 +24,8 @@
 #include "gfx/tilemap_config.hpp"
 #include "core/variant_map.hpp"
 #include "helper.hpp"
+#include <algorithm>
+#include <vector>
 
 namespace good
 {
@@ -39,11 +41,38 @@ public:
   Reservations storeReservations;  // key=reservationID, value=stock
   Reservations retrieveReservations;  // key=reservationID, value=stock
   Orders goodOrders;
+
+  struct
+  {
+    std::vector<int> available; // -1 until asked after last change
+    std::vector<int> freeRoom;
+    unsigned int ownerState;
+  } index;
+
+  void resetIndex()
+  {
+    std::fill( index.available.begin(), index.available.end(), -1 );
+    std::fill( index.freeRoom.begin(), index.freeRoom.end(), -1 );
+  }
+
+  void checkOwner( unsigned int state )
+  {
+    if( state != index.ownerState )
+    {
+      index.ownerState = state;
+      resetIndex();
+    }
+  }
 };
 
 Store::Store() : __INIT_IMPL(Store)
 {
-  _dfunc()->devastation = false;
+  __D_REF(d,Store)
+  d.devastation = false;
+  d.index.available.resize( good::all().size() + 1 );
+  d.index.freeRoom.resize( good::all().size() + 1 );
+  d.index.ownerState = 0;
+  d.resetIndex();
 }
 
 ConsumerDetails& Store::_consumers() { return _dfunc()->consumers; }
@@ -61,13 +90,38 @@ int Store::getMaxRetrieve(const good::Product goodType)
   return math::max(rqty, 0);
 }
 
+int Store::available(const good::Product goodType)
+{
+  __D_REF(d,Store)
+  d.checkOwner( _ownerState() );
+
+  int& value = d.index.available[ goodType ];
+  if( value < 0 )
+    value = math::max( getMaxRetrieve( goodType ), 0 );
+
+  return value;
+}
+
+int Store::freeRoom(const good::Product goodType)
+{
+  __D_REF(d,Store)
+  d.checkOwner( _ownerState() );
+
+  int& value = d.index.freeRoom[ goodType ];
+  if( value < 0 )
+    value = math::max( getMaxStore( goodType ), 0 );
+
+  return value;
+}
+
 
 int Store::reserveStorage(good::Stock &stock, DateTime time)
 {
-  if( getMaxStore(stock.type() ) < stock.qty() )   // current free capacity
+  if( freeRoom( stock.type() ) < stock.qty() )   // current free capacity
     return noId;
 
   // the stock can be stored!
+  _changed();
   return _dfunc()->storeReservations.push( stock, time );
 }
 
@@ -80,9 +134,10 @@ int Store::reserveStorage(good::Product what, unsigned int qty, DateTime time)
 int Store::reserveRetrieval(good::Stock &stock, DateTime time)
 {
   // current good quantity
-  if( getMaxRetrieve(stock.type()) < stock.qty())
+  if( available( stock.type() ) < stock.qty() )
     return noId;
 
+  _changed();
   return _dfunc()->retrieveReservations.push( stock, time );
 }
 
@@ -106,6 +161,7 @@ good::Stock Store::getStorageReservation(const int reservationID, const bool pop
   if( pop )
   {
     d.storeReservations.pop( reservationID );
+    _changed();
   }
 
   return info.stock;
@@ -126,6 +182,7 @@ good::Stock Store::getRetrieveReservation(const int reservationID, const bool po
   if( pop )
   {
     d.retrieveReservations.pop( reservationID );
+    _changed();
   }
 
   return info.stock;
@@ -135,6 +192,7 @@ void Store::cancelRetrieveReservation(int reservationID)
 {
   __D_REF(d,Store)
   d.retrieveReservations.cancel(reservationID);
+  _changed();
 }
 
 void Store::confirmDeliver(Product gtype, int qty, unsigned int tag, const DateTime& time)
@@ -257,6 +315,8 @@ void Store::load( const VariantMap& stream )
     setOrder( (good::Product)index, (Orders::Order)var.toInt() );
     index++;
   }
+
+  _changed();
 }
 
 const ConsumerDetails& Store::consumers() const
@@ -272,7 +332,7 @@ const ProviderDetails& Store::providers() const
 }
 
 bool Store::isDevastation() const{  return _dfunc()->devastation;}
-void Store::setDevastation( bool value ){  _dfunc()->devastation = value;}
+void Store::setDevastation( bool value ){  _dfunc()->devastation = value; _changed(); }
 
 Store::~Store() {}
 
@@ -302,15 +362,19 @@ ProductMap Store::amounts() const
   return ret;
 }
 
-void Store::setOrder( const good::Product type, const Orders::Order order ){  _dfunc()->goodOrders.set( type, order );}
+void Store::setOrder( const good::Product type, const Orders::Order order ){  _dfunc()->goodOrders.set( type, order ); _changed(); }
 Orders::Order Store::getOrder(const good::Product type) const{  return _dfunc()->goodOrders.get( type );}
 
 void Store::removeExpired(DateTime date)
 {
   _dfunc()->retrieveReservations.removeExpired( date, 2 );
   _dfunc()->storeReservations.removeExpired( date, 2 );
+  _changed();
 }
 
+void Store::_changed() { _dfunc()->resetIndex(); }
+unsigned int Store::_ownerState() const { return 0; }
+
 Reservations& Store::_getStoreReservations() {  return _dfunc()->storeReservations; }
 Reservations& Store::_getRetrieveReservations(){   return _dfunc()->retrieveReservations;}
 int Store::freeQty( const good::Product& goodType ) const{ return capacity( goodType ) - qty( goodType );}
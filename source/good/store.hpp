@@ -94,6 +94,11 @@ public:
   // returns the max quantity that can be retrieved now
   virtual int getMaxRetrieve(const good::Product goodType);
 
+  // per-product index of getMaxRetrieve()/getMaxStore() answers,
+  // rebuilt only after store, retrieve, reserve or owner changes
+  int available(const good::Product goodType);
+  int freeRoom(const good::Product goodType);
+
   // returns the reservationID if stock can be retrieved (else 0)
   virtual int reserveStorage(good::Stock& stock, DateTime time );
   virtual int reserveStorage(good::Product what, unsigned int qty, DateTime time);
@@ -141,6 +146,13 @@ public:
   virtual void removeExpired(DateTime date);
 
 protected:
+  // implementations must call it after every change of own stock
+  void _changed();
+
+  // owner state which getMaxStore()/getMaxRetrieve() depend on,
+  // like number of workers, index is dropped when it changes
+  virtual unsigned int _ownerState() const;
+
   Reservations& _getStoreReservations();
   Reservations& _getRetrieveReservations();
   ConsumerDetails& _consumers();
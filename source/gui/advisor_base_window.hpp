@@ -43,6 +43,7 @@ public:
     : Window( parent, rect, "", type ), _type( type )
   {
     _city = city;
+    setCached( true );
     if( rect.width() < 10)
       setPosition( Point( (parent->width() - Config::width ), (parent->height() - Config::height) )/2 );
   }
@@ -49,6 +49,7 @@ public:
   Font overrideFont;
   Font lastBreakFont;
   bool mouseMarking;
+  bool cursorShown;
   bool border;
   bool overrideColorEnabled;
   int markBegin;
@@ -77,6 +78,7 @@ public:
   {
     oldCursorPos = 0;
     mouseMarking = false;
+    cursorShown = false;
     overrideColorEnabled = false;
     markBegin = 0;
     markEnd = 0;
@@ -790,6 +792,14 @@ void EditBox::_drawHolderText( Font font, Rect* clip )
 
 void EditBox::beforeDraw(Engine& painter)
 {
+  // cursor blinks right in draw(), cached panels must see every blink
+  bool cursorShown = ui()->hasFocus( this ) && DateTime::elapsedTime() % 1000 < 500;
+  if( cursorShown != _d->cursorShown )
+  {
+    _d->cursorShown = cursorShown;
+    invalidate();
+  }
+
   int startPos = 0;
 
   bool needUpdateCursor = _d->needUpdateTexture;
@@ -1014,15 +1024,11 @@ void EditBox::draw( Engine& painter )
     painter.draw( _d->textPicture, _d->textOffset + absoluteRect().lefttop() );
   }
 
-  if( focus )
+  if( focus && _d->cursorShown )
   {
-    unsigned int t = DateTime::elapsedTime() % 1000;
-    if( t < 500 )
-    {
-      Point p = _d->textOffset + absoluteRect().lefttop();
-      painter.drawLine( ColorList::black, p + _d->cursorRect.lefttop() + Point( 0, 3),
-                                    p + _d->cursorRect.leftbottom() - Point( 0, 6 ) );
-    }
+    Point p = _d->textOffset + absoluteRect().lefttop();
+    painter.drawLine( ColorList::black, p + _d->cursorRect.lefttop() + Point( 0, 3),
+                                  p + _d->cursorRect.leftbottom() - Point( 0, 6 ) );
   }
 
   // draw children
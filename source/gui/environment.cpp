@@ -223,6 +223,12 @@ bool Ui::setFocus( Widget* element )
     }
   }
 
+  if( _d->focused.element.isValid() )
+    _d->focused.element->invalidate();
+
+  if( element )
+    element->invalidate();
+
   // element is the new focus so it doesn't have to be dropped
   _d->focused.element = element;
 
@@ -345,6 +351,12 @@ void Ui::_updateHovered( const Point& mousePos )
 
   if( _d->hovered.current != lastHovered )
   {
+    if( lastHovered.isValid() )
+      lastHovered->invalidate();
+
+    if( _d->hovered.current.isValid() )
+      _d->hovered.current->invalidate();
+
     if( lastHovered.isValid() )
     {
       lastHovered->onEvent( NEvent::ev_gui( lastHovered.object(), 0, event::gui::widget::left ) );
@@ -451,6 +463,8 @@ bool Ui::handleEvent( const NEvent& event )
             Widget* inFocus = getFocus();
             if( inFocus )
             {
+              // pressed widget changes look, cached panel must see it
+              inFocus->invalidate();
               bool eventResolved = getFocus()->onEvent(event);
               if( eventResolved )
               {
@@ -462,6 +476,7 @@ bool Ui::handleEvent( const NEvent& event )
             inFocus = getFocus();
             if( !inFocus && _d->hovered.current.isValid() )
             {
+              _d->hovered.current->invalidate();
               return _d->hovered.current->onEvent(event);
             }
         }
@@ -470,6 +485,7 @@ bool Ui::handleEvent( const NEvent& event )
         case NEvent::Mouse::mouseLbtnRelease:
           if( getFocus() )
           {
+            getFocus()->invalidate();
             return getFocus()->onEvent( event );
           }
         break;
@@ -477,7 +493,13 @@ bool Ui::handleEvent( const NEvent& event )
         default:
           if( _d->hovered.current.isValid() )
           {
-            return _d->hovered.current->onEvent( event );
+            // plain motion keeps cached panels, unless widget reacted on it
+            WidgetPtr target = _d->hovered.current;
+            bool resolved = target->onEvent( event );
+            if( resolved )
+              target->invalidate();
+
+            return resolved;
           }
         break;
         }
@@ -504,7 +526,11 @@ bool Ui::handleEvent( const NEvent& event )
           }
 
           if( getFocus() && getFocus()->onEvent(event))
+          {
+            if( getFocus() )
+              getFocus()->invalidate();
             return true;
+          }
 
           // For keys we handle the event before changing focus to give elements the chance for catching the TAB
           // Send focus changing event
@@ -147,6 +147,7 @@ Signal0<>& Image::onClicked(){  return _d->onClickedSignal;}
 void Image::setPicture(const Picture& picture)
 {
   _d->bgPicture = picture;
+  invalidate();
 
   if( _d->mode == image )
   {
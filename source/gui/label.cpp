@@ -636,6 +636,7 @@ void Label::beforeDraw(gfx::Engine& painter )
     _updateTexture( painter );
 
     _d->is.needUpdate = false;
+    invalidate();
   }
 
   Widget::beforeDraw( painter );
@@ -703,6 +703,7 @@ void ListBox::beforeDraw(gfx::Engine& painter)
     }
 
     _d->needItemsRepackTextures = false;
+    invalidate();
   }
 
   Widget::beforeDraw( painter );
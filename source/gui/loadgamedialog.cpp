@@ -41,7 +41,7 @@ LoadGame::LoadGame(Widget* parent)
 }
 
 LoadGame::LoadGame(Widget* parent, const vfs::Directory& dir )
-  : LoadFile( parent, Rect(), dir, ".oc3save", -1 )
+  : LoadFile( parent, Rect(), dir, ".oc3save,.oc3bin", -1 )
 {
   _sortMode = sortCount;
   Widget::setupUI( ":/gui/loadgame.gui" );
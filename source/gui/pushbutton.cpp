@@ -580,15 +580,22 @@ void PushButton::beforeDraw( gfx::Engine& painter )
   // Point spritePos = AbsoluteRect.getCenter();
   __D_REF(_d,PushButton);
 
-  _d.state.current = _state();
+  ElementState state = _state();
+  if (state != _d.state.current) {
+    _d.state.current = state;
+    invalidate();
+  }
+
   if (_d.bg.dirty) {
     _updateStyle();
     _d.bg.dirty = false;
+    invalidate();
   }
 
   if (_d.bg.textChanged) {
     _updateTexture();
     _d.bg.textChanged = false;
+    invalidate();
   }
 
   Widget::beforeDraw(painter);
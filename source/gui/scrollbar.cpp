@@ -371,7 +371,11 @@ int ScrollBar::_getPosFromMousePos(const Point& pos) const
 //! sets the position of the scrollbar
 void ScrollBar::setValue(int pos)
 {
-  _d->value = math::clamp( pos, _minValue, _maxVallue );
+  int value = math::clamp( pos, _minValue, _maxVallue );
+  if( value != _d->value )
+    invalidate();
+
+  _d->value = value;
 
   const Rect& borderMarginRect = Rect( 0, 0, 0, 0 );
   if( _horizontal )
@@ -122,6 +122,7 @@ TopMenu::TopMenu(Widget* parent, const int height , bool useIcon)
   setInternalName(TEXT(TopMenu));
 
   setDefaultStateFont(stHovered, Font::create("FONT_2_RED"));
+  setCached(true);
 }
 
 Signal1<int>& TopMenu::onShowExtentInfo() { return _d->signal.onShowExtentInfo; }
@@ -30,6 +30,8 @@
 #include "core/utils.hpp"
 #include "core/logger.hpp"
 #include "core/gettext.hpp"
+#include "core/time.hpp"
+#include "gfx/engine.hpp"
 #include "rect_calc.hpp"
 
 namespace gui
@@ -38,6 +40,17 @@ namespace gui
 static const Variant invalidVariant;
 GAME_LITERALCONST(vars)
 
+namespace {
+// area of cached widget which is being composed now
+static const Rect* composedArea = nullptr;
+
+inline bool contains( const Rect& area, const Rect& r )
+{
+  return r.left() >= area.left() && r.top() >= area.top()
+         && r.right() <= area.right() && r.bottom() <= area.bottom();
+}
+}
+
 void Widget::beforeDraw(gfx::Engine& painter )
 {
   __D_IMPL(d,Widget)
@@ -86,6 +99,8 @@ Widget::Widget( Widget* parent, int id, const Rect& rectangle )
   _d.noClip = false;
   _d.tabOrder = -1;
   _d.isTabGroup = false;
+  _d.cache.enabled = false;
+  _d.cache.dirty = true;
   _d.environment = parent ? parent->ui() : 0;
 
   Logger::warningIf( !parent, "Parent for widget is null" );
@@ -311,6 +326,7 @@ void Widget::removeChild( Widget* child )
       (*it)->setParent( 0 );
       (*it)->drop();
       _d.children.erase(it);
+      invalidate();
       return;
     }
   }
@@ -321,10 +337,90 @@ void Widget::draw(gfx::Engine& painter )
   if ( visible() )
   {
     for( auto child : _dfunc()->children )
+    {
+      if( composedArea )
+      {
+        // stuck out children are drawn over cached picture
+        if( contains( *composedArea, child->absoluteRect() ) )
+          child->draw( painter );
+      }
+      else if( child->_dfunc()->cache.enabled )
+      {
+        child->_drawCached( painter );
+      }
+      else
+      {
+        child->draw( painter );
+      }
+    }
+  }
+}
+
+void Widget::_drawCached( gfx::Engine& painter )
+{
+  __D_REF(d,Widget)
+  if( !visible() )
+    return;
+
+  const Rect& area = d.rect.absolute;
+  bool sizeChanged = d.cache.picture.size() != area.size();
+  if( d.cache.dirty || sizeChanged )
+  {
+    if( sizeChanged )
+      d.cache.picture = painter.createTarget( area.size() );
+
+    if( !d.cache.picture.isValid() )
+    {
+      // engine can't draw offscreen, element is drawn as usual from now
+      d.cache.enabled = false;
+      draw( painter );
+      return;
+    }
+
+    painter.setTarget( &d.cache.picture, area.lefttop() );
+    composedArea = &area;
+    draw( painter );
+    composedArea = nullptr;
+    painter.setTarget( nullptr );
+
+    d.cache.dirty = false;
+  }
+
+  painter.draw( d.cache.picture, area.lefttop(), &d.rect.clipping );
+  _drawOverflow( painter, area );
+}
+
+void Widget::_drawOverflow( gfx::Engine& painter, const Rect& area )
+{
+  for( auto child : _dfunc()->children )
+  {
+    if( !child->visible() )
+      continue;
+
+    if( contains( area, child->absoluteRect() ) )
+      child->_drawOverflow( painter, area );
+    else
       child->draw( painter );
   }
 }
 
+void Widget::setCached( bool enabled )
+{
+  __D_REF(d,Widget)
+  d.cache.enabled = enabled;
+  d.cache.dirty = true;
+  if( !enabled )
+    d.cache.picture = gfx::Picture();
+}
+
+bool Widget::isCached() const { return _dfunc()->cache.enabled; }
+
+void Widget::invalidate()
+{
+  for( Widget* w = this; w; w = w->parent() )
+    w->_dfunc()->cache.dirty = true;
+}
+
 void Widget::debugDraw(gfx::Engine& painter)
 {
   if ( visible() )
@@ -401,6 +497,7 @@ bool Widget::bringChildToFront( Widget* element )
     {
       children.erase(it);
       children.push_back(element);
+      invalidate();
       return true;
     }
   }
@@ -421,6 +518,7 @@ bool Widget::sendChildToBack( Widget* child )
     {
       children.erase(it);
       children.push_front(child);
+      invalidate();
       return true;
     }
   }
@@ -714,6 +812,7 @@ void Widget::_addChild( Widget* child )
     child->_dfunc()->rect.lastParent = absoluteRect();
     child->setParent( this );
     _dfunc()->children.push_back(child);
+    invalidate();
   }
 }
 
@@ -823,6 +922,7 @@ void Widget::_recalculateAbsolutePosition( bool recursive )
   }
 
   _finalizeResize();
+  invalidate();
 }
 
 void Widget::animate( unsigned int timeMs )
@@ -910,16 +1010,16 @@ void Widget::setHeight(unsigned int height)
   setGeometry( rectangle );
 }
 
-void Widget::setEnabled(bool enabled){  _dfunc()->flag.enabled = enabled;}
+void Widget::setEnabled(bool enabled){  _dfunc()->flag.enabled = enabled; invalidate(); }
 std::string Widget::internalName() const{    return _dfunc()->internalName;}
 void Widget::setInternalName( const std::string& name ){    _dfunc()->internalName = name;}
 Widget* Widget::parent() const {    return _dfunc()->parent;}
 const Rect& Widget::relativeRect() const{  return _dfunc()->rect.relative;}
 bool Widget::isNotClipped() const{  return _dfunc()->noClip;}
-void Widget::setVisible( bool visible ){  _dfunc()->flag.visible = visible;}
+void Widget::setVisible( bool visible ){  _dfunc()->flag.visible = visible; invalidate(); }
 bool Widget::isTabStop() const{  return _dfunc()->flag.tabStop;}
 bool Widget::hasTabgroup() const{  return _dfunc()->isTabGroup;}
-void Widget::setText( const std::string& text ){  _dfunc()->text.value = text;}
+void Widget::setText( const std::string& text ){  _dfunc()->text.value = text; invalidate(); }
 void Widget::setTooltipText( const std::string& text ) { _dfunc()->text.tooltip = text;}
 std::string Widget::text() const{  return _dfunc()->text.value;}
 std::string Widget::tooltipText() const{  return _dfunc()->text.tooltip;}
@@ -196,6 +196,16 @@ public:
 
   virtual void debugDraw( gfx::Engine& painter );
 
+  //! Subtree is composed to offscreen picture once and then blitted as one piece.
+  /** Picture is recomposed after invalidate() of any widget in subtree. Children which
+  stick out of element (popup menus) are drawn every frame over it. Element should
+  have opaque background, semitransparent pixels are blended twice. */
+  void setCached( bool enabled );
+  bool isCached() const;
+
+  //! Marks element as changed, so cached ancestors recompose it on next draw
+  void invalidate();
+
   virtual void animate( unsigned int timeMs );
 
   //! Destructor
@@ -457,6 +467,9 @@ protected:
   // not virtual because needed in constructor
   void _recalculateAbsolutePosition(bool recursive);
 
+  void _drawCached( gfx::Engine& painter );
+  void _drawOverflow( gfx::Engine& painter, const Rect& area );
+
   __DECLARE_IMPL(Widget)
 };
 
@@ -19,6 +19,7 @@
 #include "core/variant_map.hpp"
 #include "core/alignment.hpp"
 #include "core/list.hpp"
+#include "gfx/picture.hpp"
 #include <set>
 
 namespace gui
@@ -113,6 +114,13 @@ public:
   //! tab groups are containers like windows, use ctrl+tab to navigate
   bool isTabGroup;
 
+  //! retained drawing of subtree, see Widget::setCached
+  struct {
+    bool enabled;
+    bool dirty;
+    gfx::Picture picture;
+  } cache;
+
   //runtime properties
   VariantMap properties;
 
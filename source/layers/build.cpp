@@ -45,6 +45,9 @@
 #include "city/statistic.hpp"
 #include "core/osystem.hpp"
 
+#include <unordered_map>
+#include <unordered_set>
+
 using namespace gui;
 using namespace gfx;
 using namespace events;
@@ -52,11 +55,25 @@ using namespace events;
 namespace citylayer
 {
 static const int frameCountLimiter=12;
+static const unsigned int previewPoolLimit=4096;
+static const TilePos neighbours[8] = { TilePos( -1, -1 ), TilePos( 0, -1 ), TilePos( 1, -1 ), TilePos( -1, 0 ),
+                                       TilePos( 1, 0 ), TilePos( -1, 1 ), TilePos( 0, 1 ), TilePos( 1, 1 ) };
 
 class Build::Impl
 {
 public:
   typedef std::map<unsigned int, Tile*> CachedTiles;
+  typedef std::unordered_multimap<unsigned int, Tile*> TilesPool;
+
+  // result of checks for construction placed on position
+  struct Check
+  {
+    unsigned int planned;     // mask of planned neighbours, aqueducts over roads look at them
+    bool mayBuild;
+    std::vector<bool> green;  // colors of area tiles when construction can't be placed
+  };
+  typedef std::unordered_map<unsigned int, Check> Checks;
+
   bool multiBuilding;
   TilePos lastTilePos;
   TilePos startTilePos;
@@ -88,8 +105,16 @@ public:
   TilesArray buildTiles;  // these tiles have draw over "normal" tilemap tiles!
   CachedTiles cachedTiles;
 
+  TilesPool pool;                         // preview tiles from previous drag, by position
+  Checks checks;                          // valid until map may change, see resetChecks()
+  std::unordered_set<unsigned int> planned;
+  ConstructionPtr checked;
+
 public:
   void sortBuildTiles();
+  Tile* takeTile( const Tile& basic );
+  void resetChecks();
+  void clearPool();
 };
 
 void Build::_discardPreview()
@@ -100,11 +125,17 @@ void Build::_discardPreview()
     if( tile->overlay().isValid() )
       tile->overlay()->deleteLater();
 
-    delete tile;
+    tile->setOverlay( 0 );
+    tile->setMaster( 0 );
+    d.pool.insert( std::make_pair( tile->pos().hash(), tile ) );
   }
 
+  if( d.pool.size() > previewPoolLimit )
+    d.clearPool();
+
   d.buildTiles.clear();
   d.cachedTiles.clear();
+  d.planned.clear();
 }
 
 void Build::_checkPreviewBuild(const TilePos& pos)
@@ -115,7 +146,6 @@ void Build::_checkPreviewBuild(const TilePos& pos)
   if (buildMode.isNull())
     return;
 
-  // TODO: do only when needed, when (i, j, _buildInstance) has changed
   ConstructionPtr construction = buildMode->contruction();
 
   if( !construction.isValid() )
@@ -123,32 +153,82 @@ void Build::_checkPreviewBuild(const TilePos& pos)
     return;
   }
 
+  if( d.checked != construction )
+  {
+    d.resetChecks();
+    d.checked = construction;
+  }
+
   Size size = construction->size();
   int cost = construction->info().cost();
+  Tilemap& tmap = _city()->tilemap();
+  city::AreaInfo areaInfo( _city(), pos, &d.buildTiles );
 
-  bool walkersOnTile = false;
-  if( buildMode->flag( LayerMode::checkWalkers ) )
+  unsigned int planned = 0;
+  for( int k=0; k < 8; k++ )
   {
-    TilesArray tiles = _city()->tilemap().area( pos, size );
-    for( auto tile : tiles )
+    if( d.planned.count( ( pos + neighbours[ k ] ).hash() ) )
+      planned |= 1 << k;
+  }
+
+  auto it = d.checks.find( pos.hash() );
+  if( it == d.checks.end() || it->second.planned != planned )
+  {
+    Impl::Check& check = d.checks[ pos.hash() ];
+    check.planned = planned;
+    check.green.clear();
+
+    bool walkersOnTile = false;
+    if( buildMode->flag( LayerMode::checkWalkers ) )
     {
-      auto walkers = _city()->walkers( tile->epos() )
-                              .exclude<Corpse>();
+      TilesArray tiles = tmap.area( pos, size );
+      for( auto tile : tiles )
+      {
+        auto walkers = _city()->walkers( tile->epos() )
+                                .exclude<Corpse>();
 
-      if( !walkers.empty() )
+        if( !walkers.empty() )
+        {
+          walkersOnTile = true;
+          break;
+        }
+      }
+    }
+
+    check.mayBuild = !walkersOnTile && construction->canBuild( areaInfo );
+    if( !check.mayBuild )
+    {
+      Construction::BuildArea buildArea = construction->buildArea( areaInfo );
+      for (int dj = 0; dj < size.height(); ++dj)
       {
-        walkersOnTile = true;
-        break;
+        for (int di = 0; di < size.width(); ++di)
+        {
+          TilePos rPos = pos + TilePos( di, dj );
+          if( !tmap.isInside( rPos ) )
+            continue;
+
+          const auto area = buildArea.find( rPos );
+          const bool isConstructible = tmap.at( rPos ).getFlag( Tile::isConstructible );
+          const bool inBuildArea  = area != buildArea.end() ? area->second : true;
+
+          walkersOnTile = false;
+          if( buildMode->flag( LayerMode::checkWalkers ) )
+          {
+            walkersOnTile = !_city()->walkers( rPos ).empty();
+          }
+
+          check.green.push_back( !walkersOnTile && isConstructible && inBuildArea );
+        }
       }
     }
+
+    it = d.checks.find( pos.hash() );
   }
 
-  city::AreaInfo areaInfo( _city(), pos, &d.buildTiles );
-  bool canBuild = construction->canBuild( areaInfo );
-  if( !walkersOnTile && canBuild )
+  const Impl::Check& check = it->second;
+  if( check.mayBuild )
   {
     d.mayBuildInCity = true;
-    Tilemap& tmap = _city()->tilemap();
     Tile *masterTile=0;
     d.money4Construction += cost;
     for (int dj = 0; dj < size.height(); ++dj)
@@ -156,54 +236,35 @@ void Build::_checkPreviewBuild(const TilePos& pos)
       for (int di = 0; di < size.width(); ++di)
       {
         Tile& basicTile = tmap.at( pos + TilePos( di, dj ) );
-        Tile* tile = new Tile( basicTile.pos() );  // make a copy of tile
-        tile->setEPos( basicTile.epos() );
+        Tile* tile = d.takeTile( basicTile );  // make a copy of tile
 
         if (di==0 && dj==0)
         {
           // this is the masterTile
           masterTile = tile;
         }
-        tile->setPicture( tmap.at( pos + TilePos( di, dj ) ).picture() );
+        tile->setPicture( basicTile.picture() );
         tile->setMaster( masterTile );
         tile->setOverlay( construction.as<Overlay>() );
         d.buildTiles.push_back( tile );
+        d.planned.insert( basicTile.epos().hash() );
       }
     }
   }
   else
   {
     d.mayBuildInCity = false;
-    Tilemap& tmap = _city()->tilemap();
-    Construction::BuildArea buildArea = construction->buildArea( areaInfo );
+    unsigned int index = 0;
     for (int dj = 0; dj < size.height(); ++dj)
     {
       for (int di = 0; di < size.width(); ++di)
       {
         TilePos rPos = pos + TilePos( di, dj );
-        if( !tmap.isInside( rPos ) )
+        if( !tmap.isInside( rPos ) || index >= check.green.size() )
           continue;
 
-        const Tile& basicTile = tmap.at( rPos );
-
-        const auto it = buildArea.find( rPos );
-
-        const bool isConstructible = basicTile.getFlag( Tile::isConstructible );
-        const bool inBuildArea  = it != buildArea.end() ? it->second : true;
-
-        Tile* tile = new Tile( basicTile.pos() );  // make a copy of tile
-        tile->setEPos( basicTile.epos() );
-
-        walkersOnTile = false;
-        if( buildMode->flag( LayerMode::checkWalkers ) )
-        {
-          walkersOnTile = !_city()->walkers( rPos ).empty();
-        }
-
-        tile->setPicture( (!walkersOnTile && isConstructible && inBuildArea) ? d.btile.green : d.btile.red );
-        tile->setMaster( 0 );
-        tile->setFlag( Tile::clearAll, true );
-        tile->setOverlay( 0 );
+        Tile* tile = d.takeTile( tmap.at( rPos ) );  // make a copy of tile
+        tile->setPicture( check.green[ index++ ] ? d.btile.green : d.btile.red );
         d.buildTiles.push_back( tile );
       }
     }
@@ -227,6 +288,21 @@ static bool compare_tile(const Tile* one, const Tile* two)
   return one->pos().z() > two->pos().z();
 }
 
+// order of diagonal scan from left down corner: far diagonals first, then along i
+static bool compare_isometric(const Tile* one, const Tile* two)
+{
+  const TilePos& a = one->epos();
+  const TilePos& b = two->epos();
+  int da = a.j() - a.i();
+  int db = b.j() - b.i();
+  return da != db ? da > db : a.i() < b.i();
+}
+
+static bool same_tile(const Tile* one, const Tile* two)
+{
+  return one->epos() == two->epos();
+}
+
 void Build::_updatePreviewTiles( bool force )
 {
   __D_REF(d,Build);
@@ -257,35 +333,10 @@ void Build::_updatePreviewTiles( bool force )
     TilesArray pathTiles = RoadPropagator::createPath( _city()->tilemap(),
                                                        startTile->epos(), stopTile->epos(),
                                                        d.roadAssignment, d.kbShift );
-    Tilemap& tmap = _city()->tilemap();
-    TilePos leftUpCorner = pathTiles.leftUpCorner();
-    TilePos rigthDownCorner = pathTiles.rightDownCorner();
-    TilePos leftDownCorner( leftUpCorner.i(), rigthDownCorner.j() );
-    TilesArray ret;
-
-    int mmapSize = std::max<int>( leftUpCorner.j() - rigthDownCorner.j() + 1,
-                                  rigthDownCorner.i() - leftUpCorner.i() + 1 );
-    for( int y=0; y < mmapSize; y++ )
-    {
-      for( int t=0; t <= y; t++ )
-      {
-        TilePos tpos = leftDownCorner + TilePos( t, mmapSize - 1 - ( y - t ) );
-        if( pathTiles.contain( tpos ) )
-          ret.push_back( &tmap.at( tpos ) );
-      }
-    }
-
-    for( int x=1; x < mmapSize; x++ )
-    {
-      for( int t=0; t < mmapSize-x; t++ )
-      {
-        TilePos tpos = leftDownCorner + TilePos( x + t, t );
-        if( pathTiles.contain( tpos ) )
-          ret.push_back( &tmap.at( tpos ) );
-      }
-    }
 
-    pathTiles = ret;
+    // planned tiles affect checks of next ones, so path goes in isometric order
+    std::sort( pathTiles.begin(), pathTiles.end(), compare_isometric );
+    pathTiles.erase( std::unique( pathTiles.begin(), pathTiles.end(), same_tile ), pathTiles.end() );
     for( auto tile : pathTiles )
       _checkPreviewBuild( tile->epos() );
   }
@@ -344,6 +395,7 @@ void Build::_buildAll()
   }
 
   d.startTilePos = d.lastTilePos;
+  d.resetChecks();
 
   if( !buildOk )
   {
@@ -500,7 +552,17 @@ void Build::_drawBuildTile( const RenderInfo& rinfo, Tile* tile)
   bool maskSet = false;
   Size size(1,1);
 
-  if( construction.isValid() && construction->canBuild( areaInfo ) )
+  bool mayBuild = false;
+  if( construction.isValid() )
+  {
+    // preview update already checked this position, don't ask construction every frame
+    auto check = _d->checks.find( areaInfo.pos.hash() );
+    mayBuild = ( _d->checked == construction && check != _d->checks.end() )
+                 ? check->second.mayBuild
+                 : construction->canBuild( areaInfo );
+  }
+
+  if( mayBuild )
   {
     rinfo.engine.setColorMask( 0x00000000, 0x0000ff00, 0, 0xff000000 );
     maskSet = true;
@@ -594,6 +656,8 @@ void Build::render( Engine& engine)
 
   if( ++d.frameCount >= frameCountLimiter)
   {
+    // walkers move and map may change under cursor
+    d.resetChecks();
     _updatePreviewTiles( true );
     d.frameCount -= frameCountLimiter;
   }
@@ -711,7 +775,15 @@ void Build::changeLayer(int layer)
 }
 
 LayerPtr Build::drawLayer() const { return _dfunc()->lastLayer; }
-Build::~Build() {}
+
+Build::~Build()
+{
+  __D_REF(d,Build);
+  for( auto tile : d.buildTiles )
+    delete tile;
+
+  d.clearPool();
+}
 
 Build::Build(Camera& camera, PlayerCityPtr city, Renderer* renderer )
   : Layer( &camera, city ), __INIT_IMPL(Build)
@@ -740,4 +812,39 @@ void Build::Impl::sortBuildTiles()
     cachedTiles[ t->epos().hash() ] = t;
 }
 
+Tile* Build::Impl::takeTile( const Tile& basic )
+{
+  Tile* tile = 0;
+  auto it = pool.find( basic.pos().hash() );
+  if( it != pool.end() )
+  {
+    tile = it->second;
+    pool.erase( it );
+  }
+  else
+  {
+    tile = new Tile( basic.pos() );
+  }
+
+  tile->setEPos( basic.epos() );
+  tile->setFlag( Tile::clearAll, true );
+  tile->setMaster( 0 );
+  tile->setOverlay( 0 );
+  return tile;
+}
+
+void Build::Impl::resetChecks()
+{
+  checks.clear();
+  checked = ConstructionPtr();
+}
+
+void Build::Impl::clearPool()
+{
+  for( auto& item : pool )
+    delete item.second;
+
+  pool.clear();
+}
+
 }//end namespace citylayer
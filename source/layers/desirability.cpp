@@ -26,6 +26,7 @@
 #include "core/event.hpp"
 #include "core/utils.hpp"
 #include "constants.hpp"
+#include "gfx/picture_bank.hpp"
 
 using namespace gfx;
 
@@ -37,6 +38,7 @@ class Desirability::Impl
 public:
   Font debugFont;
   std::vector<Picture> debugText;
+  PictureRange land;
 };
 
 namespace
@@ -60,7 +62,7 @@ void Desirability::drawTile( const RenderInfo& rinfo, Tile& tile)
     if( tile.getFlag( Tile::isConstructible ) && desirability != 0 )
     {
       int desIndex = __des2index( desirability );
-      Picture pic( config::rc.land2a, 37 + desIndex );
+      const Picture& pic = PictureBank::instance().get( _d->land[ 37 + desIndex ] );
 
       rinfo.engine.draw( pic, tile.mappos() + rinfo.offset );
     }
@@ -82,7 +84,7 @@ void Desirability::drawTile( const RenderInfo& rinfo, Tile& tile)
     {
       //other buildings
       int picOffset = __des2index( desirability );
-      Picture pic( config::rc.land2a, 37 + picOffset );
+      const Picture& pic = PictureBank::instance().get( _d->land[ 37 + picOffset ] );
 
       TilesArray tiles4clear = overlay->area();
 
@@ -147,6 +149,7 @@ Desirability::Desirability( Camera& camera, PlayerCityPtr city)
   : Info( camera, city, 0 ), _d( new Impl )
 {
   _d->debugFont = Font::create( "FONT_1" );
+  _d->land = PictureBank::instance().range( config::rc.land2a, 37 + 7 );  // __des2index() gives -3..6
   _initialize();
 }
 
@@ -41,6 +41,7 @@
 #include "core/logger.hpp"
 #include "core/color_list.hpp"
 #include "gfx/animation_bank.hpp"
+#include "gfx/picture_bank.hpp"
 #include "game/settings.hpp"
 #include "city/statistic.hpp"
 
@@ -480,10 +481,13 @@ void Layer::drawArea( const RenderInfo& rinfo, const TilesArray& area, const std
   if( area.empty() )
     return;
 
+  // group is resolved once per area, tiles use handles
+  PictureBank& bank = PictureBank::instance();
+  PictureRange pics = bank.range( resourceGroup, tileId + config::tile.skipLeftBorder + config::tile.skipRightBorder + 1 );
+
   if( area.size() == 1 )
   {
-    Picture pic(resourceGroup, tileId );
-    rinfo.engine.draw( pic, area.front()->mappos() + rinfo.offset );
+    rinfo.engine.draw( bank.get( pics[ tileId ] ), area.front()->mappos() + rinfo.offset );
   }
   else
   {
@@ -497,8 +501,7 @@ void Layer::drawArea( const RenderInfo& rinfo, const TilesArray& area, const std
     {
       int tileBorders = ( tile->i() == leftBorderAtI ? 0 : config::tile.skipLeftBorder )
                         + ( tile->j() == rightBorderAtJ ? 0 : config::tile.skipRightBorder );
-      Picture pic(resourceGroup, tileBorders + tileId);
-      rinfo.engine.draw( pic, tile->mappos() + rinfo.offset );
+      rinfo.engine.draw( bank.get( pics[ tileBorders + tileId ] ), tile->mappos() + rinfo.offset );
     }
   }
 }
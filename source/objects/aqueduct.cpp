@@ -78,20 +78,24 @@ bool Aqueduct::build( const city::AreaInfo& info )
   for( auto aqueduct : aqueducts )
     aqueduct->updatePicture( info.city );
 
+  _updateNetwork( true );
   return true;
 }
 
-void Aqueduct::addWater(const WaterSource &source)
+TilePosArray Aqueduct::outlets() const
 {
-  WaterSource::addWater( source );
+  TilePosArray ret;
+  for( auto& offset : offsets )
+    ret.push_back( pos() + offset );
 
-  _produceWater( offsets, 4 );
+  return ret;
 }
 
 void Aqueduct::initTerrain(Tile& terrain) {}
 
 void Aqueduct::destroy()
 {
+  _updateNetwork( false );
   Construction::destroy();
 
   if( _city().isValid() )
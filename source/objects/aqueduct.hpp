@@ -26,7 +26,7 @@ public:
   Aqueduct();
 
   virtual bool build( const city::AreaInfo& info );
-  virtual void addWater(const WaterSource &source);
+  virtual TilePosArray outlets() const;
   virtual void initTerrain( gfx::Tile& terrain);
   virtual bool canBuild(const city::AreaInfo& areaInfo ) const;
   virtual bool isNeedRoad() const;
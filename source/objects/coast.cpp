@@ -75,6 +75,7 @@ bool Coast::isFlat() const { return true;}
 void Coast::destroy()
 {
   tile().terrain().coast = false;
+  tile().updateMask();
   CoastList coasts = neighbors();
   for( auto nb : coasts )
     nb->updatePicture();
@@ -293,6 +294,7 @@ Picture Coast::calcPicture()
   {
     tile().setOverlay( nullptr );
     tile().terrain().clear();
+    tile().updateMask();
     destroy();
     deleteLater();
     return Terrain::randomPicture();
@@ -303,6 +305,7 @@ Picture Coast::calcPicture()
     tile().setOverlay( nullptr );
     tile().terrain().clear();
     tile().terrain().water = true;
+    tile().updateMask();
     destroy();
     deleteLater();
     return Picture( config::rc.land1a, 120 );
@@ -76,6 +76,9 @@ public:
 
 public signals:
   Signal0<> onChangeState;
+
+protected:
+  virtual unsigned int _ownerState() const { return factory ? factory->numberWorkers() : 0; }
 };
 
 class Factory::Impl
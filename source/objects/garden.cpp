@@ -113,6 +113,7 @@ void Garden::setPicture(Picture picture)
 {
   Construction::setPicture( picture );
   _flat = picture.width()/ (float)picture.height() >= 1.7f;
+  _updateMasks();
 }
 
 void Garden::update()
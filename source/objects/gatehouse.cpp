@@ -144,6 +144,7 @@ void Gatehouse::load(const VariantMap& stream)
   VARIANT_LOAD_ANY_D ( _d, walkable, stream )
 
   _d->updateSprite();
+  _updateMasks();
 }
 
 bool Gatehouse::isWalkable() const { return _d->walkable; }
@@ -197,7 +198,12 @@ void Gatehouse::timeStep(const unsigned long time)
                                 .walkers
                                 .count<EnemySoldier>( start, end );
 
-        _d->walkable = (enemies_n == 0);
+        bool walkable = (enemies_n == 0);
+        if( walkable != _d->walkable )
+        {
+          _d->walkable = walkable;
+          _updateMasks();
+        }
       }
     }
   }
@@ -212,6 +218,8 @@ void Gatehouse::setMode(Gatehouse::Mode mode)
   case opened: _d->walkable = true;
   case closed: _d->walkable = false;
   }
+
+  _updateMasks();
 }
 
 void Gatehouse::nextMode()
@@ -108,6 +108,9 @@ public:
   virtual TilePos owner() const { return granary ? granary->pos() : TilePos::invalid(); }
 
   Granary* granary;
+
+protected:
+  virtual unsigned int _ownerState() const { return granary ? granary->numberWorkers() : 0; }
 };
 
 class Granary::Impl
@@ -27,6 +27,7 @@
 #include "game/resourcegroup.hpp"
 #include "core/variant_map.hpp"
 #include "gfx/tilemap.hpp"
+#include "gfx/tilemasks.hpp"
 #include "game/gamedate.hpp"
 #include "good/storage.hpp"
 #include "city/statistic.hpp"
@@ -189,7 +190,6 @@ public:
   good::Storage goodstore;
   Services services;  // value=access to the service (0=no access, 100=good access)
   Point randomOffset;
-  std::string evolveInfo;
   Habitants habitants;
   Animation healthAnimation;
   WalkerList walkers;
@@ -200,6 +200,21 @@ public:
   int needHappiness;
   Pictures ground;
 
+  struct
+  {
+    unsigned int missing;  // requirements of checked level which house doesn't meet
+    int level;             // level which was checked
+    bool degrade;
+    std::string text;      // message which isn't made from requirements
+  } evolve;
+
+  struct
+  {
+    House::Neighbors list;
+    unsigned int revision;
+    int range;
+  } neighbors;
+
 public:
   void initGoodStore( int size );
   void consumeServices();
@@ -227,6 +242,11 @@ House::House( HouseLevel::ID level )
 
   _d->changeCondition = 0;
   _d->needHappiness = 100;
+  _d->evolve.missing = 0;
+  _d->evolve.level = _d->houseLevel;
+  _d->evolve.degrade = false;
+  _d->neighbors.revision = 0;
+  _d->neighbors.range = 0;
   setState( pr::happiness, 100 );
 
   _d->initGoodStore( 1 );
@@ -239,8 +259,13 @@ House::House( HouseLevel::ID level )
 
 void House::_checkEvolve()
 {
-  bool validate = _d->spec.checkHouse( this, &_d->evolveInfo );
-  if( !validate )
+  unsigned int missing = _d->spec.missing( this );
+  _d->evolve.level = _d->spec.level();
+  _d->evolve.missing = missing;
+  _d->evolve.degrade = false;
+  _d->evolve.text.clear();
+
+  if( missing )
   {
     _d->changeCondition--;
     if( _d->changeCondition <= needDegrade )
@@ -251,10 +276,9 @@ void House::_checkEvolve()
   }
   else
   {
-    _d->evolveInfo = "";
-    HouseSpecification nextSpec = _d->spec.next();
-
-    bool mayUpgrade =  nextSpec.checkHouse( this, &_d->evolveInfo );
+    const HouseSpecification& nextSpec = _d->spec.next();
+    _d->evolve.level = nextSpec.level();
+    _d->evolve.missing = nextSpec.missing( this );
 
     object::Type needBuilding;
     TilePos rPos;
@@ -263,11 +287,10 @@ void House::_checkEvolve()
     bool haveLowHouseNearMe = nextSpec.findLowLevelHouseNearby(*this, rPos ) > 0;
     if( haveUnwishBuildingsNearMe || haveLowHouseNearMe )
     {
-      _d->evolveInfo = "##nearby_building_negative_effect##";
-      mayUpgrade = false;
+      _d->evolve.missing |= HouseSpecification::rqNeighbors;
     }
 
-    if( mayUpgrade )
+    if( _d->evolve.missing == 0 )
     {
       _d->changeCondition++;
       if( _d->changeCondition >= mayEvolve )
@@ -284,26 +307,40 @@ void House::_checkEvolve()
 
   if( _d->changeCondition < noEvolve )
   {
-    std::string why;
-    _d->spec.checkHouse( this, &why );
-    if( !why.empty() )
-    {
-      why = why.substr( 0, why.size() - 2 );
-      why += "_degrade##";
-    }
-    else
-    {
-      why = "##house_willbe_degrade##";
-    }
-
-    _d->evolveInfo = why;
+    _d->evolve.level = _d->spec.level();
+    _d->evolve.missing = missing;
+    _d->evolve.degrade = true;
   }
   else if( _d->changeCondition > noEvolve )
   {
-    _d->evolveInfo = _("##house_evolves_at##");
+    _d->evolve.text = _("##house_evolves_at##");
   }
 }
 
+const House::Neighbors& House::_neighbors( int range ) const
+{
+  TilePos offset( range, range );
+  unsigned int revision = _city()->tilemap().masks().overlaysRevision( pos() - offset, pos() + offset );
+  if( _d->neighbors.range != range || _d->neighbors.revision != revision )
+  {
+    BuildingList buildings = _city()->statistic().objects.find<Building>( object::any, pos() - offset, pos() + offset );
+    Neighbors& list = _d->neighbors.list;
+    list.buildings.clear();
+    list.houses.clear();
+    for( auto& bld : buildings )
+    {
+      list.buildings.push_back( bld.object() );
+      if( bld->type() == object::house )
+        list.houses.push_back( ptr_cast<House>( bld ).object() );
+    }
+
+    _d->neighbors.range = range;
+    _d->neighbors.revision = revision;
+  }
+
+  return _d->neighbors.list;
+}
+
 void House::_checkPatricianDeals()
 {
   if( !spec().isPatrician() )
@@ -512,9 +549,10 @@ void House::_updateConsumptions( const unsigned long time )
 
 void House::timeStep(const unsigned long time)
 {
+  unsigned int phase = game::Date::phaseOf( pos().hash() );
   if( _d->habitants.empty()  )
   {
-    if( game::Date::isMonthChanged() )
+    if( game::Date::isMonthPhase( phase ) )
     {
       _levelDown();
     }
@@ -530,7 +568,7 @@ void House::timeStep(const unsigned long time)
 
   _updateConsumptions( time );
 
-  if( game::Date::isMonthChanged() )
+  if( game::Date::isMonthPhase( phase ) )
   {
     setState( pr::settleLock, 0 );
 
@@ -541,7 +579,7 @@ void House::timeStep(const unsigned long time)
     _d->poverity = math::clamp( _d->poverity, 0, 100 );
   }
 
-  if( game::Date::isWeekChanged() )
+  if( game::Date::isWeekPhase( phase ) )
   {
     _checkEvolve();
     _updateHappiness();
@@ -735,7 +773,7 @@ bool House::_tryEvolve_12_to_20_lvl( int level4grow, int minSize, const char des
   }
   else
   {
-    _d->evolveInfo = "##no_space_for_evolve##";
+    _d->evolve.text = "##no_space_for_evolve##";
     return false;
   }
 }
@@ -747,7 +785,7 @@ void House::_levelUp()
 
   if( _d->houseLevel >= _city()->victoryConditions().maxHouseLevel() )
   {
-    _d->evolveInfo = "##emperor_limit_houseupgrade##";
+    _d->evolve.text = "##emperor_limit_houseupgrade##";
     return;
   }
 
@@ -1142,7 +1180,7 @@ Variant House::getProperty(const std::string & name) const
   if (name == "unwishedBuildingPos") {
     object::Type needBuilding;
     TilePos rPos;
-    HouseSpecification s = spec().next();
+    const HouseSpecification& s = spec().next();
 
     int unwish = s.findUnwishedBuildingNearby(*this, needBuilding, rPos);
 
@@ -1276,12 +1314,40 @@ std::string House::troubleDesc() const
 
   if( ret.empty() && _d->changeCondition <= 0 )
   {
-    ret = _d->evolveInfo;
+    ret = evolveInfo();
   }
 
   return ret;
 }
 
+std::string House::evolveInfo() const
+{
+  if( !_d->evolve.text.empty() )
+    return _d->evolve.text;
+
+  std::string why;
+  if( _d->evolve.missing )
+  {
+    const HouseSpecification& spec = HouseSpecHelper::instance().getSpec( _d->evolve.level );
+    why = spec.missingText( const_cast<House*>( this ), _d->evolve.missing );
+  }
+
+  if( _d->evolve.degrade )
+  {
+    if( !why.empty() )
+    {
+      why = why.substr( 0, why.size() - 2 );
+      why += "_degrade##";
+    }
+    else
+    {
+      why = "##house_willbe_degrade##";
+    }
+  }
+
+  return why;
+}
+
 bool House::isCheckedDesirability() const {  return _city()->buildOptions().isCheckDesirability(); }
 
 void House::addWalker(WalkerPtr walker)
@@ -1447,7 +1513,6 @@ float House::taxesThisYear() const { return _d->economy.taxesThisYear; }
 
 void House::appendMoney(float money)                             { _d->economy.money += money; }
 DateTime House::lastTaxationDate() const                         { return _d->economy.lastTaxationDate;}
-std::string House::evolveInfo() const                            { return _d->evolveInfo;}
 bool House::isWalkable() const                                   { return size().width() == 1; }
 bool House::isFlat() const                                       { return _d->isFlat; }
 const CitizenGroup& House::habitants() const                     { return _d->habitants; }
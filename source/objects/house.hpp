@@ -102,6 +102,15 @@ public:
   void __debugChangeLevel( int change );
   void __debugMakeGeneration();
 private:
+  // overlays in square around house, rescanned when some tile changes overlay,
+  // so pointers never outlive their tiles and houses don't hold each other
+  struct Neighbors
+  {
+    std::vector<Building*> buildings;
+    std::vector<House*> houses;
+  };
+
+  const Neighbors& _neighbors( int range ) const;
   void _updateHealthLevel();
   void _levelUp();
   void _levelDown();
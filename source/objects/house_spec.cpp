@@ -34,6 +34,7 @@
 #include <string>
 #include <map>
 #include <list>
+#include <vector>
 
 using namespace gfx;
 
@@ -61,6 +62,7 @@ public:
 
   typedef std::map<good::Product, int> RequiredGoods;
   RequiredGoods requiredGoods;  // rate of good usage for every good (furniture, pottery, ...)
+  unsigned int requiredGoodsMask;  // requirements of goods which house must have in store
 
   typedef std::map<good::Product, float> GoodConsumptionMuls;
   GoodConsumptionMuls consumptionMuls;
@@ -77,162 +79,212 @@ int HouseSpecification::minHealthLevel() const {  return _d->minHealthLevel; }
 int HouseSpecification::minReligionLevel() const{  return _d->minReligionLevel;}
 int HouseSpecification::minFoodLevel() const{  return _d->minFoodLevel;}
 
+namespace {
+
+// goods which house of some levels must keep in store
+static const struct GoodRule
+{
+  good::Product product;
+  HouseSpecification::Requirement requirement;
+  object::Type building;
+  const char* text;
+} goodRules[] = {
+  { good::pottery,    HouseSpecification::rqPottery,    object::pottery_workshop,   "##missing_pottery##" },
+  { good::furniture,  HouseSpecification::rqFurniture,  object::furniture_workshop, "##missing_furniture##" },
+  { good::oil,        HouseSpecification::rqOil,        object::oil_workshop,       "##missing_oil##" },
+  { good::wine,       HouseSpecification::rqWine,       object::wine_workshop,      "##missing_wine##" },
+  { good::prettyWine, HouseSpecification::rqPrettyWine, object::wine_workshop,      "##missing_second_wine##" }
+};
+
+inline void setReason( std::string* reason, const char* text )
+{
+  if( reason )
+    *reason = text;
+}
+
+// the first requirement player is told about
+inline unsigned int firstOf( unsigned int missing ) { return missing & ( ~missing + 1 ); }
+
+}
+
 bool HouseSpecification::checkHouse( HousePtr house, std::string* retMissing,
                                      object::Type* retBtype, TilePos* retPos ) const
 {
-  bool res = true;
-  int value;
-  std::string reason;
-  std::string defaultStr;
-  object::Type defaultNeedType;
+  if( retBtype )
+    *retBtype = object::unknown;
+
+  unsigned int rq = missing( house );
+  if( rq == 0 )
+    return true;
 
-  std::string& ref = retMissing ? *retMissing : defaultStr;
-  object::Type& needBuilding = retBtype ? *retBtype : defaultNeedType;
+  if( retMissing )
+    *retMissing = missingText( house, rq );
 
-  needBuilding = object::unknown;
+  if( retBtype )
+    *retBtype = missingBuilding( house, rq );
 
+  return false;
+}
+
+unsigned int HouseSpecification::missing( HousePtr house ) const
+{
+  // checks go in bit order and stop on first failure,
+  // so failed house doesn't pay for desirability scan and services behind it
   if( house->habitants().count() == 0 )
-  {
-    ref = "##house_no_citizen##";
-    return false;
-  }
+    return rqHabitants;
 
-  value = computeDesirabilityLevel( house, reason );
-  if( house->isCheckedDesirability() && value < _d->minDesirability )
-  {
-    ref = "##low_desirability##";
-    needBuilding = object::garden;
-    return false;
-  }
+  if( house->isCheckedDesirability() && computeDesirabilityLevel( house ) < _d->minDesirability )
+    return rqDesirability;
+
+  if( computeEntertainmentLevel( house ) < _d->minEntertainmentLevel )
+    return rqEntertainment;
+
+  if( computeEducationLevel( house ) < _d->minEducationLevel )
+    return rqEducation;
+
+  if( computeHealthLevel( house ) < _d->minHealthLevel )
+    return rqHealth;
+
+  if( computeReligionLevel( house ) < _d->minReligionLevel )
+    return rqReligion;
 
-  value = computeEntertainmentLevel( house );
-  if( value < _d->minEntertainmentLevel )
+  if( computeWaterLevel( house ) < _d->minWaterLevel )
+    return rqWater;
+
+  if( computeFoodLevel( house ) < _d->minFoodLevel )
+    return rqFood;
+
+  if( _d->requiredGoodsMask )
   {
-    if( value == 0 )
+    const good::Store& store = house->store();
+    for( auto& rule : goodRules )
     {
-      ref = "##missing_entertainment##";
-      needBuilding = object::theater;
+      if( (_d->requiredGoodsMask & rule.requirement) && store.qty( rule.product ) == 0 )
+        return rule.requirement;
     }
-    else
-    {
-      switch( _d->minEntertainmentLevel / 20 )
-      {
-      case 0: ref = "##missing_entertainment_theater##"; needBuilding = object::theater; break;
-      case 1: ref = "##missing_entertainment_amph##"; needBuilding = object::amphitheater; break;
-      case 2: ref = "##missing_entertainment_also##"; needBuilding = object::amphitheater; break;
-      case 3: ref = "##missing_entertainment_colosseum##"; needBuilding = object::colosseum; break;
-      case 4: ref = "##missing_entertainment_hippodrome##"; needBuilding = object::hippodrome; break;
-        //##missing_entertainment_patrician##
-      }
-    }
-    return false;
   }
 
-  value = computeEducationLevel( house, reason );
-  if( value < _d->minEducationLevel )
-  {
-    ref = /*_("##missing_education##") + */reason;
-    switch( value )
-    {
-    case 0: case 1: needBuilding = object::school; break;
-    case 2: needBuilding = object::academy; break;
-    case 3: needBuilding = object::library; break;
-    }
+  return 0;
+}
 
-    return false;
-  }
+std::string HouseSpecification::missingText( HousePtr house, unsigned int missing ) const
+{
+  std::string reason;
 
-  value = computeHealthLevel( house, reason );
-  if( value < _d->minHealthLevel )
+  switch( firstOf( missing ) )
   {
-    ref = /*_( "##missing_health##" ) + */reason;
+  case rqHabitants: return "##house_no_citizen##";
+  case rqDesirability: return "##low_desirability##";
+  case rqNeighbors: return "##nearby_building_negative_effect##";
+
+  case rqEntertainment:
+    if( computeEntertainmentLevel( house ) == 0 )
+      return "##missing_entertainment##";
 
-    switch( value )
+    switch( _d->minEntertainmentLevel / 20 )
     {
-    case 1: needBuilding = object::baths; break;
-    case 2: needBuilding = object::barber; break;
-    case 3: needBuilding = object::clinic; break;
-    case 4: needBuilding = object::hospital; break;
+    case 0: return "##missing_entertainment_theater##";
+    case 1: return "##missing_entertainment_amph##";
+    case 2: return "##missing_entertainment_also##";
+    case 3: return "##missing_entertainment_colosseum##";
+    case 4: return "##missing_entertainment_hippodrome##";
+      //##missing_entertainment_patrician##
     }
+  break;
 
-    return false;
-  }
+  case rqEducation: computeEducationLevel( house, &reason ); break;
+  case rqHealth: computeHealthLevel( house, &reason ); break;
+  case rqWater: computeWaterLevel( house, &reason ); break;
 
-  value = computeReligionLevel( house );
-  if( value < _d->minReligionLevel )
-  {
+  case rqReligion:
     switch( _d->minReligionLevel )
     {
-    case 0: ref = "##religion_undef_reason##"; break;
-    case 1: ref = "##missing_religion##"; break;
-    case 2: ref = "##missing_second_religion##"; break;
-    case 3: ref = "##missing_third_religion##"; break;
+    case 0: return "##religion_undef_reason##";
+    case 1: return "##missing_religion##";
+    case 2: return "##missing_second_religion##";
+    case 3: return "##missing_third_religion##";
     }
-    needBuilding = object::oracle;
-    return false;
-  }
+  break;
 
-  value = computeWaterLevel(house, reason);
-  if( value < _d->minWaterLevel )
-  {
-    ref = reason;
-    needBuilding = object::fountain;
-    return false;
-  }
+  case rqFood:
+    if( !house->hasServiceAccess( Service::market ) )
+      return "##missing_market##";
 
-  value = computeFoodLevel(house);
-  if( value < _d->minFoodLevel )
-  {
-    if( !house->hasServiceAccess( Service::market ) ) { ref = "##missing_market##"; }
-    else
+    switch( _d->minFoodLevel )
     {
-      switch( _d->minFoodLevel )
-      {
-      case 1: ref = "##missing_food##"; break;
-      case 2: ref = "##missing_second_food##"; break;
-      case 3: ref = "##missing_third_food##"; break;
-      }
+    case 1: return "##missing_food##";
+    case 2: return "##missing_second_food##";
+    case 3: return "##missing_third_food##";
     }
-    needBuilding = object::market;
-    return false;
-  }
+  break;
 
-  if( _d->requiredGoods[good::pottery] != 0 && house->store().qty(good::pottery) == 0)
-  {
-    ref = "##missing_pottery##";
-    needBuilding = object::pottery_workshop;
-    return false;
+  default:
+    for( auto& rule : goodRules )
+    {
+      if( missing & rule.requirement )
+        return rule.text;
+    }
+  break;
   }
 
-  if( _d->requiredGoods[good::furniture] != 0 && house->store().qty(good::furniture) == 0)
-  {
-    ref = "##missing_furniture##";
-    needBuilding = object::furniture_workshop;
-    return false;
-  }
+  return reason;
+}
 
-  if( _d->requiredGoods[good::oil] != 0 && house->store().qty(good::oil) == 0)
+object::Type HouseSpecification::missingBuilding( HousePtr house, unsigned int missing ) const
+{
+  switch( firstOf( missing ) )
   {
-    ref = "##missing_oil##";
-    needBuilding = object::oil_workshop;
-    return false;
-  }
+  case rqDesirability: return object::garden;
+  case rqReligion: return object::oracle;
+  case rqWater: return object::fountain;
+  case rqFood: return object::market;
 
-  if( _d->requiredGoods[good::wine] != 0 && house->store().qty(good::wine) == 0)
-  {
-    ref = "##missing_wine##";
-    needBuilding = object::wine_workshop;
-    return false;
-  }
+  case rqEntertainment:
+    if( computeEntertainmentLevel( house ) == 0 )
+      return object::theater;
 
-  if( _d->requiredGoods[good::prettyWine] != 0 && house->store().qty(good::prettyWine) == 0)
-  {
-    ref = "##missing_second_wine##";
-    needBuilding = object::wine_workshop;
-    return false;
+    switch( _d->minEntertainmentLevel / 20 )
+    {
+    case 0: return object::theater;
+    case 1: case 2: return object::amphitheater;
+    case 3: return object::colosseum;
+    case 4: return object::hippodrome;
+    }
+  break;
+
+  case rqEducation:
+    switch( computeEducationLevel( house ) )
+    {
+    case 0: case 1: return object::school;
+    case 2: return object::academy;
+    case 3: return object::library;
+    }
+  break;
+
+  case rqHealth:
+    switch( computeHealthLevel( house ) )
+    {
+    case 1: return object::baths;
+    case 2: return object::barber;
+    case 3: return object::clinic;
+    case 4: return object::hospital;
+    }
+  break;
+
+  case rqHabitants:
+  case rqNeighbors:
+  break;
+
+  default:
+    for( auto& rule : goodRules )
+    {
+      if( missing & rule.requirement )
+        return rule.building;
+    }
+  break;
   }
 
-  return res;
+  return object::unknown;
 }
 
 unsigned int HouseSpecification::consumptionInterval(HouseSpecification::IntervalName name) const
@@ -253,10 +305,8 @@ unsigned int HouseSpecification::consumptionInterval(HouseSpecification::Interva
 int HouseSpecification::findUnwishedBuildingNearby(const House& house, object::Type& rType, TilePos& refPos ) const
 {
   int aresOffset = math::clamp<int>( house.level() / 5, 1, 10 );
-  TilePos housePos = house.pos();
   int houseDesrbl = house.desirability().base;
-  BuildingList buildings = house._city()->statistic().objects.find<Building>( object::any,
-                                                                               housePos, aresOffset );
+  const std::vector<Building*>& buildings = house._neighbors( aresOffset ).buildings;
 
   int ret = 0;
   for( auto bld : buildings )
@@ -277,10 +327,7 @@ int HouseSpecification::findUnwishedBuildingNearby(const House& house, object::T
 int HouseSpecification::findLowLevelHouseNearby(const House& house, TilePos& refPos ) const
 {
   int aresOffset = math::clamp<int>( house.level() / 5, 1, 10 );
-  TilePos offset( aresOffset, aresOffset );
-  TilePos housePos = house.pos();
-  HouseList houses = house._city()->statistic().objects.find<House>( object::house,
-                                                                     housePos - offset, housePos + offset );
+  const std::vector<House*>& houses = house._neighbors( aresOffset ).houses;
 
   int ret = 0;
   for( auto h : houses )
@@ -298,7 +345,7 @@ int HouseSpecification::findLowLevelHouseNearby(const House& house, TilePos& ref
   return ret;
 }
 
-int HouseSpecification::computeWaterLevel(HousePtr house, std::string &oMissingRequirement) const
+int HouseSpecification::computeWaterLevel(HousePtr house, std::string* oMissingRequirement) const
 {
   // no water=0, well=1, fountain=2
   int res = 0;
@@ -309,11 +356,11 @@ int HouseSpecification::computeWaterLevel(HousePtr house, std::string &oMissingR
   else if (house->hasServiceAccess(Service::well))
   {
     res = 1;
-    oMissingRequirement = "##missing_fountain##";
+    setReason( oMissingRequirement, "##missing_fountain##" );
   }
   else
   {
-    oMissingRequirement = "##missing_water##";
+    setReason( oMissingRequirement, "##missing_water##" );
   }
   return res;
 }
@@ -345,7 +392,7 @@ int HouseSpecification::computeEntertainmentLevel(HousePtr house) const
 }
 
 
-int HouseSpecification::computeHealthLevel(HousePtr house, std::string &oMissingRequirement) const
+int HouseSpecification::computeHealthLevel(HousePtr house, std::string* oMissingRequirement) const
 {
    // no health=0, bath=1, bath+doctor/hospital=2, bath+doctor/hospital+barber=3, bath+doctor+hospital+barber=4
    int res = 0;
@@ -368,33 +415,33 @@ int HouseSpecification::computeHealthLevel(HousePtr house, std::string &oMissing
            {
              if (house->hasServiceAccess(Service::doctor))
              {
-               oMissingRequirement = "##missing_hospital##";
+               setReason( oMissingRequirement, "##missing_hospital##" );
              }
              else
              {
-               oMissingRequirement = "##missing_doctor##";
+               setReason( oMissingRequirement, "##missing_doctor##" );
              }
            }
          }
          else
          {
-           oMissingRequirement = "##missing_barber##";
+           setReason( oMissingRequirement, "##missing_barber##" );
          }
       }
       else
       {
-        oMissingRequirement = "##missing_doctor_or_hospital##";
+        setReason( oMissingRequirement, "##missing_doctor_or_hospital##" );
       }
    }
    else
    {
-     oMissingRequirement = "##missing_bath##";
+     setReason( oMissingRequirement, "##missing_bath##" );
    }
    return res;
 }
 
 
-int HouseSpecification::computeEducationLevel(HousePtr house, std::string &oMissingRequirement) const
+int HouseSpecification::computeEducationLevel(HousePtr house, std::string* oMissingRequirement) const
 {
   int res = 0;
   bool haveSchool = house->hasServiceAccess(Service::school);
@@ -412,19 +459,19 @@ int HouseSpecification::computeEducationLevel(HousePtr house, std::string &oMiss
       }
       else
       {
-        oMissingRequirement = "##missing_library##";
+        setReason( oMissingRequirement, "##missing_library##" );
       }
     }
     else
     {
-      oMissingRequirement = "##missing_college##";
+      setReason( oMissingRequirement, "##missing_college##" );
     }
   }
   else
   {
-     oMissingRequirement = haveLibrary
-                             ? "##missing_school##"
-                             : "##missing_school_or_library##";
+    setReason( oMissingRequirement, haveLibrary
+                                      ? "##missing_school##"
+                                      : "##missing_school_or_library##" );
   }
 
   return res;
@@ -441,7 +488,7 @@ int HouseSpecification::computeReligionLevel(HousePtr house) const
   return res;
 }
 
-float HouseSpecification::evaluateServiceNeed(HousePtr house, const Service::Type service)
+float HouseSpecification::evaluateServiceNeed(HousePtr house, const Service::Type service) const
 {
    float res = 0;
 
@@ -481,13 +528,13 @@ float HouseSpecification::evaluateServiceNeed(HousePtr house, const Service::Typ
    return res * (100 - house->getServiceValue(service));
 }
 
-float HouseSpecification::evaluateEntertainmentNeed(HousePtr house, const Service::Type service)
+float HouseSpecification::evaluateEntertainmentNeed(HousePtr house, const Service::Type service) const
 {
    //int houseLevel = house.getLevelSpec().getHouseLevel();
    return (float)next()._d->minEntertainmentLevel;
 }
 
-float HouseSpecification::evaluateEducationNeed(HousePtr house, const Service::Type service)
+float HouseSpecification::evaluateEducationNeed(HousePtr house, const Service::Type service) const
 {
   float res = 0;
   //int houseLevel = house.getLevelSpec().getHouseLevel();
@@ -514,7 +561,7 @@ float HouseSpecification::evaluateEducationNeed(HousePtr house, const Service::T
   return res;
 }
 
-float HouseSpecification::evaluateHealthNeed(HousePtr house, const Service::Type service)
+float HouseSpecification::evaluateHealthNeed(HousePtr house, const Service::Type service) const
 {
    float res = 0;
    //int houseLevel = house.getLevelSpec().getHouseLevel();
@@ -548,7 +595,7 @@ float HouseSpecification::evaluateHealthNeed(HousePtr house, const Service::Type
    return std::max<float>( res, 100 - house->state( pr::health ) );
 }
 
-float HouseSpecification::evaluateReligionNeed(HousePtr house, const Service::Type service)
+float HouseSpecification::evaluateReligionNeed(HousePtr house, const Service::Type service) const
 {
    //int houseLevel = house.getLevelSpec().getHouseLevel();
    int minLevel = next()._d->minReligionLevel;
@@ -609,6 +656,19 @@ HouseSpecification::~HouseSpecification() {}
 
 HouseSpecification::HouseSpecification() : _d( new Impl )
 {
+  _d->houseLevel = HouseLevel::vacantLot;
+  _d->tileCapacity = 0;
+  _d->taxRate = 0;
+  _d->minEntertainmentLevel = 0;
+  _d->minHealthLevel = 0;
+  _d->minDesirability = _d->maxDesirability = 0;
+  _d->minEducationLevel = 0;
+  _d->crime = 0;
+  _d->prosperity = 0;
+  _d->minWaterLevel = 0;
+  _d->minReligionLevel = 0;
+  _d->minFoodLevel = 0;
+  _d->requiredGoodsMask = 0;
   _d->srvcInterval = game::Date::days2ticks( 2 );
   _d->foodInterval = game::Date::days2ticks( 30 );
   _d->goodInterval = game::Date::days2ticks( 15 );
@@ -619,12 +679,12 @@ HouseSpecification::HouseSpecification( const HouseSpecification& other ) : _d(
   *this = other;
 }
 
-HouseSpecification HouseSpecification::next() const
+const HouseSpecification& HouseSpecification::next() const
 {
   return HouseSpecHelper::instance().getSpec(_d->houseLevel+1);
 }
 
-int HouseSpecification::computeDesirabilityLevel(HousePtr house, std::string& oMissingRequirement) const
+int HouseSpecification::computeDesirabilityLevel(HousePtr house) const
 {
   PlayerCityPtr city = house->_city();
 
@@ -661,6 +721,7 @@ HouseSpecification& HouseSpecification::operator=( const HouseSpecification& oth
   _d->minReligionLevel = other._d->minReligionLevel;  // number of religions
   _d->minFoodLevel = other._d->minFoodLevel;  // number of food types
   _d->requiredGoods = other._d->requiredGoods;
+  _d->requiredGoodsMask = other._d->requiredGoodsMask;
   _d->consumptionMuls = other._d->consumptionMuls;
 
   return *this;
@@ -669,7 +730,7 @@ HouseSpecification& HouseSpecification::operator=( const HouseSpecification& oth
 class HouseSpecHelper::Impl
 {
 public:
-  typedef std::map<int, HouseSpecification > HouseLevels;
+  typedef std::vector<HouseSpecification> HouseLevels;
   typedef std::map<std::string, StringArray > HouseTextures;
 
   HouseLevels levels;
@@ -684,22 +745,27 @@ HouseSpecHelper& HouseSpecHelper::instance()
 
 HouseSpecHelper::HouseSpecHelper() : _d( new Impl )
 {
+  // levels are kept in place, so references to them stay valid after reload
+  _d->levels.resize( HouseLevel::maxLevel );
+  for( unsigned int level=0; level < _d->levels.size(); level++ )
+    _d->levels[ level ]._d->houseLevel = HouseLevel::ID( level );
+
   Logger::debug( "HouseLevelSpec INIT" );
 }
 
-HouseSpecification HouseSpecHelper::getSpec(const int houseLevel)
+const HouseSpecification& HouseSpecHelper::getSpec(const int houseLevel)
 {
-  int level = math::clamp<int>(houseLevel, 0, 20);
+  int level = math::clamp<int>(houseLevel, 0, HouseLevel::greatPalace);
   return _d->levels[level];
 }
 
 int HouseSpecHelper::getLevel( const std::string& name )
 {
-  for( auto item : _d->levels )
+  for( auto& item : _d->levels )
   {
-    if( item.second.internalName() == name )
+    if( !item.internalName().empty() && item.internalName() == name )
     {
-      return item.second.level();
+      return item.level();
     }
   }
 
@@ -751,6 +817,13 @@ void HouseSpecHelper::initialize( const vfs::Path& filename )
     spec._d->prosperity = hSpec.get( "prosperity" ).toInt();  // prosperity
     spec._d->taxRate = hSpec.get( "tax" ).toInt();// tax_rate
 
+    spec._d->requiredGoodsMask = 0;
+    for( auto& rule : goodRules )
+    {
+      if( spec._d->requiredGoods[ rule.product ] != 0 )
+        spec._d->requiredGoodsMask |= rule.requirement;
+    }
+
     for( auto& goodType : good::all() )
     {
       spec._d->consumptionMuls[ goodType ] = 1;
@@ -780,6 +853,12 @@ void HouseSpecHelper::initialize( const vfs::Path& filename )
       }
     }
 
+    if( spec._d->houseLevel < 0 || spec._d->houseLevel >= (int)_d->levels.size() )
+    {
+      Logger::warning( "HouseSpecHelper: unknown level {} for {}", spec._d->houseLevel, specConfig.first );
+      continue;
+    }
+
     _d->levels[ spec._d->houseLevel ] = spec;
   }
 }
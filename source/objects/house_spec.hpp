@@ -34,6 +34,12 @@ class HouseSpecification
 public:
   typedef enum { intv_foods=0, intv_goods, intv_service, intv_count } IntervalName;
 
+  //! bits of unmet requirements, lower bit is told to player first
+  typedef enum { rqNeighbors=0x1, rqHabitants=0x2, rqDesirability=0x4, rqEntertainment=0x8,
+                 rqEducation=0x10, rqHealth=0x20, rqReligion=0x40, rqWater=0x80, rqFood=0x100,
+                 rqPottery=0x200, rqFurniture=0x400, rqOil=0x800, rqWine=0x1000,
+                 rqPrettyWine=0x2000 } Requirement;
+
   HouseLevel::ID level() const;
   int tileCapacity() const;
   int taxRate() const;
@@ -52,28 +58,35 @@ public:
   bool checkHouse(HousePtr house, std::string* retMissing = 0,
                   object::Type* needBuilding = 0, TilePos *retPos=0) const;
 
+  //! first requirement of this level which house doesn't meet or 0, never rqNeighbors
+  unsigned int missing(HousePtr house) const;
+
+  //! reason for first of missing requirements, made only when player needs it
+  std::string missingText(HousePtr house, unsigned int missing) const;
+  object::Type missingBuilding(HousePtr house, unsigned int missing) const;
+
   unsigned int consumptionInterval( IntervalName name ) const;
 
   int findLowLevelHouseNearby(const House& house, TilePos &refPos) const;
   int findUnwishedBuildingNearby(const House& house, object::Type& rType, TilePos &refPos) const;
 
-  HouseSpecification next() const;
+  const HouseSpecification& next() const;
 
-  int computeDesirabilityLevel(HousePtr house, std::string &oMissingRequirement) const;
+  int computeDesirabilityLevel(HousePtr house) const;
   int computeEntertainmentLevel(HousePtr house) const;
-  int computeEducationLevel(HousePtr house, std::string &oMissingRequirement) const;
-  int computeHealthLevel(HousePtr house, std::string &oMissingRequirement) const;
+  int computeEducationLevel(HousePtr house, std::string* oMissingRequirement=0) const;
+  int computeHealthLevel(HousePtr house, std::string* oMissingRequirement=0) const;
   int computeReligionLevel(HousePtr house) const;
-  int computeWaterLevel(HousePtr house, std::string &oMissingRequirement) const;
+  int computeWaterLevel(HousePtr house, std::string* oMissingRequirement=0) const;
   int computeFoodLevel(HousePtr house) const;
   int computeMonthlyGoodConsumption(HousePtr house, const good::Product goodType, bool real) const;
   int computeMonthlyFoodConsumption( HousePtr house ) const;
 
-  float evaluateServiceNeed(HousePtr house, const Service::Type service);
-  float evaluateEntertainmentNeed(HousePtr house, const Service::Type service);
-  float evaluateEducationNeed(HousePtr house, const Service::Type service);
-  float evaluateHealthNeed(HousePtr house, const Service::Type service);
-  float evaluateReligionNeed(HousePtr house, const Service::Type service);
+  float evaluateServiceNeed(HousePtr house, const Service::Type service) const;
+  float evaluateEntertainmentNeed(HousePtr house, const Service::Type service) const;
+  float evaluateEducationNeed(HousePtr house, const Service::Type service) const;
+  float evaluateHealthNeed(HousePtr house, const Service::Type service) const;
+  float evaluateReligionNeed(HousePtr house, const Service::Type service) const;
   // float evaluateFoodNeed(House &house, const ServiceType service);
 
   int minDesirabilityLevel() const;
@@ -99,7 +112,7 @@ class HouseSpecHelper
 public:
   static HouseSpecHelper& instance();
 
-  HouseSpecification getSpec(const int houseLevel);
+  const HouseSpecification& getSpec(const int houseLevel);
   int getLevel( const std::string& name );
   void initialize( const vfs::Path& filename );
   gfx::Picture getPicture(int houseLevel , int size) const;
@@ -141,6 +141,7 @@ bool Overlay::build(const city::AreaInfo &info)
 
       tile.setOverlay( this );
       initTerrain( tile );
+      tile.updateMask();
     }
   }
   info.city->setOption( PlayerCity::updateTiles, 1 );
@@ -235,6 +236,16 @@ void Overlay::setSize( const Size& size ){  _d->size = size;}
 Point Overlay::offset( const Tile&, const Point& ) const{  return Point( 0, 0 );}
 Animation& Overlay::_animation() { return _d->animation;}
 Tile* Overlay::_masterTile(){  return _d->masterTile;}
+
+void Overlay::_updateMasks()
+{
+  if( _d->masterTile == nullptr || _city().isNull() )
+    return;
+
+  for( auto tile : area() )
+    tile->updateMask();
+}
+
 PlayerCityPtr Overlay::_city() const{ return _d->city;}
 Pictures& Overlay::_fgPictures(){  return _d->fgPictures; }
 const Picture& Overlay::_fgPicture( unsigned int index ) const { return _d->fgPictures[index]; }
@@ -129,6 +129,7 @@ protected:
   void setType(const object::Type type);
   gfx::Animation& _animation();
   gfx::Tile* _masterTile();
+  void _updateMasks();
   PlayerCityPtr _city() const;
   gfx::Tilemap& _map() const;
   int _cityOpt(int name);
@@ -60,6 +60,7 @@ PREDEFINE_CLASS_SMARTLIST(Senate,List)
 PREDEFINE_CLASS_SMARTLIST(Shipyard,List)
 PREDEFINE_CLASS_SMARTLIST(Ruins,List)
 PREDEFINE_CLASS_SMARTLIST(Reservoir,List)
+PREDEFINE_CLASS_SMARTLIST(WaterSource,List)
 PREDEFINE_CLASS_SMARTLIST(Barracks,List)
 PREDEFINE_CLASS_SMARTLIST(Creamery,List)
 PREDEFINE_CLASS_SMARTLIST(Colosseum,List)
@@ -72,7 +72,10 @@ bool Rock::build( const city::AreaInfo& areainfo )
 void Rock::destroy()
 {
   for( auto tile : area() )
+  {
     tile->terrain().rock = false;
+    tile->updateMask();
+  }
 }
 
 void Rock::setPicture(Picture picture)
@@ -155,6 +155,16 @@ bool BurningRuins::build( const city::AreaInfo& info)
 }
 
 bool BurningRuins::isWalkable() const{  return (state( pr::fire ) == 0);}
+
+void BurningRuins::setState(int name, float value)
+{
+  bool walkable = isWalkable();
+  Ruins::setState( name, value );
+
+  if( walkable != isWalkable() )
+    _updateMasks();
+}
+
 bool BurningRuins::isDestructible() const{  return isWalkable();}
 bool BurningRuins::canDestroy() const { return (state( pr::fire ) == 0); }
 
@@ -54,6 +54,7 @@ public:
   virtual bool isWalkable() const;
   virtual bool isDestructible() const;
   virtual void destroy();
+  virtual void setState(int name, float value);
   virtual bool isFlat() const { return false; }
   virtual bool canDestroy() const;
   virtual bool getMinimapColor(int& color1, int& color2) const;
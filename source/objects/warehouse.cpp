@@ -242,8 +242,7 @@ void Warehouse::load( const VariantMap& stream )
 {
   WorkingBuilding::load( stream );
 
-  _d->goodStore.load( stream.get( literals::goodStore ).toMap() );
-
+  // rooms go first, store index is rebuilt from them on load
   VariantList vm_tiles = stream.get( literals::tiles ).toList();
   int tileIndex = 0;
   for( const auto& it : vm_tiles )
@@ -252,6 +251,8 @@ void Warehouse::load( const VariantMap& stream )
     tileIndex++;
   }
 
+  _d->goodStore.load( stream.get( literals::goodStore ).toMap() );
+
   VARIANT_LOAD_ANY_D( _d, isTradeCenter, stream )
 
   computePictures();
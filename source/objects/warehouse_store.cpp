@@ -158,6 +158,7 @@ bool WarehouseStore::applyStorageReservation( good::Stock &stock, const int rese
     }
   }
 
+  _changed();
   _warehouse->computePictures();
   return true;
 }
@@ -220,6 +221,7 @@ bool WarehouseStore::applyRetrieveReservation(good::Stock& stock, const int rese
     }
   }
 
+  _changed();
   _warehouse->computePictures();
   return true;
 }
@@ -249,6 +251,8 @@ void WarehouseStore::load(const VariantMap &stream)
   for( auto& it : _capacities )
     if( it.second == 0 )
       it.second = maxCapacity;
+
+  _changed();
 }
 
 int WarehouseStore::capacity() const
@@ -273,6 +277,12 @@ void WarehouseStore::setCapacity(const int) {}
 void WarehouseStore::setCapacity(const good::Product &goodType, const int maxQty)
 {
   _capacities[ goodType ] = maxQty;
+  _changed();
+}
+
+unsigned int WarehouseStore::_ownerState() const
+{
+  return _warehouse ? _warehouse->numberWorkers() : 0;
 }
 
 int WarehouseStore::capacity( const good::Product& goodType ) const
@@ -48,6 +48,9 @@ public:
   virtual VariantMap save() const;
   virtual void load(const VariantMap &stream);
 
+protected:
+  virtual unsigned int _ownerState() const;
+
 private:
   Warehouse* _warehouse;
   good::ProductMap _capacities;
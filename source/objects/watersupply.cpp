@@ -34,42 +34,59 @@
 #include "game/gamedate.hpp"
 #include "gfx/tilearea.hpp"
 #include "gfx/tilemap_config.hpp"
+#include "gfx/tileparams.hpp"
+#include "city/statistic.hpp"
+#include "city/cityservice_water.hpp"
 
 using namespace gfx;
 
 REGISTER_CLASS_IN_OVERLAYFACTORY(object::reservoir, Reservoir)
 
+namespace {
+enum { aquiferRange=10 };
+}
+
 class WaterSource::Impl
 {
 public:
   int  water;
   bool lastWaterState;
-  int  daysWithoutWater;
   Point fullOffset;
   bool isRoad;
   std::string errorStr;
 };
 
-void Reservoir::_dropWater()
+void Reservoir::_changeCoverage( int delta )
 {
-  //now remove water flag from near tiles
-  TilesArea reachedTiles( _map(), pos() - TilePos( 10, 10 ), Size::square( 10 + 10 ) + size() );
-
-  for( auto& tile : reachedTiles )
-    tile->setParam( Tile::pReservoirWater, 0 );
+  // every full reservoir adds one to tiles of aquifer, so overlaps stay covered
+  TileParams& params = _map().params();
+  TilePos start = pos() - TilePos( aquiferRange, aquiferRange );
+  int range = aquiferRange * 2 + size().width();
+  for( int j=start.j(); j < start.j() + range; j++ )
+  {
+    for( int i=start.i(); i < start.i() + range; i++ )
+      params.change( Tile::pReservoirWater, i, j, delta );
+  }
 }
 
 void Reservoir::_waterStateChanged()
 {
-
+  if( _haveCoverage != haveWater() )
+  {
+    _haveCoverage = haveWater();
+    _changeCoverage( _haveCoverage ? 1 : -1 );
+  }
 }
 
 void Reservoir::destroy()
 {
-  _dropWater();
-  broke();
+  if( _haveCoverage )
+  {
+    _haveCoverage = false;
+    _changeCoverage( -1 );
+  }
 
-  // update adjacent aqueducts
+  _updateNetwork( false );
   Construction::destroy();
 }
 
@@ -78,11 +95,6 @@ std::string Reservoir::troubleDesc() const
   return haveWater() ? "" : "##trouble_too_far_from_water##";
 }
 
-void Reservoir::addWater(const WaterSource& source)
-{
-  WaterSource::addWater( source );
-}
-
 void Reservoir::initialize(const object::Info& mdata)
 {
   WaterSource::initialize( mdata );
@@ -90,19 +102,23 @@ void Reservoir::initialize(const object::Info& mdata)
   _d->fullOffset = mdata.getOption( "fullOffset" );
 }
 
-void Reservoir::broke()
+bool Reservoir::isSource() const { return _isWaterSource; }
+
+TilePosArray Reservoir::outlets() const
 {
-  int saveWater = water();
-  _d->water = 100;
-  WaterSource::broke();
+  TilePosArray ret;
+  const TilePos offsets[4] = { TilePos( -1, 1), TilePos( 1, 3 ), TilePos( 3, 1), TilePos( 1, -1) };
+  for( auto& offset : offsets )
+    ret.push_back( pos() + offset );
 
-  _d->water = saveWater;
+  return ret;
 }
 
 Reservoir::Reservoir()
     : WaterSource( object::reservoir, Size::square( 3 ) )
 {
   _isWaterSource = false;
+  _haveCoverage = false;
   setPicture( info().randomPicture( size() ) );
 
   // utilitya 34      - empty reservoir
@@ -124,6 +140,7 @@ bool Reservoir::build( const city::AreaInfo& info )
 
   _isWaterSource = _isNearWater( info.city, info.pos );
   _setError( _isWaterSource ? "" : "##need_connect_to_other_reservoir##");
+  _updateNetwork( true );
 
   return true;
 }
@@ -142,37 +159,12 @@ void Reservoir::timeStep(const unsigned long time)
 {
   WaterSource::timeStep( time );
 
-  if( _isWaterSource )
-  {
-    _d->water = 100;
-  }
-
-  if( !_d->water )
+  if( !haveWater() )
   {
     _fgPicture( 0 ) = Picture::getInvalid();
-    _dropWater();
-    broke();
     return;
   }
 
-  //filled area, that reservoir present
-  if( game::Date::isWeekChanged() )
-  {
-    TilesArray reachedTiles = aquifer();
-
-    for( auto& tile : reachedTiles )
-    {
-      int value = tile->param( Tile::pReservoirWater );
-      tile->setParam( Tile::pReservoirWater, math::clamp( value+1, 0, 20 ) );
-    }
-  }
-
-  if( game::Date::isDayChanged() )
-  {
-    const TilePos offsets[4] = { TilePos( -1, 1), TilePos( 1, 3 ), TilePos( 3, 1), TilePos( 1, -1) };
-    _produceWater(offsets, 4);
-  }
-
   _animation().update( time );
 
   // takes current animation frame and put it into foreground
@@ -181,7 +173,7 @@ void Reservoir::timeStep(const unsigned long time)
 
 TilesArray Reservoir::aquifer() const
 {
-  TilesArea r( _map(), pos() - TilePos( 10, 10 ), Size::square( 10 + 10 ) + size() );
+  TilesArea r( _map(), pos() - TilePos( aquiferRange, aquiferRange ), Size::square( aquiferRange * 2 ) + size() );
   return r;
 }
 
@@ -222,81 +214,51 @@ WaterSource::WaterSource(const object::Type type, const Size& size )
 
 WaterSource::~WaterSource(){}
 
-void WaterSource::addWater( const WaterSource& source )
-{
-  if( source.water() > water()+1 )
-  {
-    _d->water = source.water() - 1;
-    _d->daysWithoutWater = 0;
-  }
-}
-
 bool WaterSource::haveWater() const{  return _d->water > 0;}
+bool WaterSource::isSource() const { return false; }
+TilePosArray WaterSource::outlets() const { return TilePosArray(); }
 
 void WaterSource::timeStep( const unsigned long time )
 {
-  if( game::Date::isDayChanged() )
-  {
-    _d->daysWithoutWater++;
-    if( _d->daysWithoutWater > 5 )
-    {
-      _d->water = math::clamp( _d->water-10, 0, 100 );
-    }
-
-    if( _d->lastWaterState != (_d->water > 0) )
-    {
-      _d->lastWaterState = _d->water > 0;
-      _waterStateChanged();
-    }
-  }
-
   Construction::timeStep( time );
 }
 
-void WaterSource::_produceWater(const TilePos* points, const int size)
+void WaterSource::setWater( int value )
 {
-  Tilemap& tilemap = _map();
-
-  for( int index=0; index < size; index++ )
+  _d->water = value;
+  if( _d->lastWaterState != (_d->water > 0) )
   {
-    TilePos p = pos() + points[index];
-    if( tilemap.isInside( p ) )
-    {
-      auto ws = tilemap.at( p ).overlay<WaterSource>();
-
-      if( ws.isValid() )
-      {
-        if( ws->water() < water() )
-            ws->addWater( *this );
-      }
-    }
+    _d->lastWaterState = _d->water > 0;
+    _waterStateChanged();
   }
 }
 
-void WaterSource::_setIsRoad(bool value){  _d->isRoad = value;}
-bool WaterSource::_isRoad() const { return _d->isRoad; }
-int WaterSource::water() const{ return _d->water; }
-std::string WaterSource::errorDesc() const{  return _d->errorStr;}
-void WaterSource::_setError(const std::string& error){  _d->errorStr = error;}
-
-void WaterSource::broke()
+void WaterSource::_updateNetwork( bool attach )
 {
-  TilesArray tiles = _map().rect( pos() - TilePos( 1, 1), size() + Size::square(2) );
+  if( _city().isNull() )
+    return;
 
-  int saveWater = water();
-  _d->water = 0;
-  for( auto tile : tiles )
-  {
-    auto waterSource = tile->overlay<WaterSource>();
+  auto network = _city()->statistic().services.find<city::Water>();
+  if( network.isNull() )
+    return;
 
-    if( waterSource.isValid() )
-    {
-      if( waterSource->water() > 0 && waterSource->water() < saveWater )
-          waterSource->broke();
-    }
-  }
+  if( attach ) network->addSource( this );
+  else network->removeSource( this );
 }
 
+void WaterSource::_setIsRoad(bool value)
+{
+  bool changed = (_d->isRoad != value);
+  _d->isRoad = value;
+  if( changed )
+    _updateMasks();
+}
+
+bool WaterSource::_isRoad() const { return _d->isRoad; }
+int WaterSource::water() const{ return _d->water; }
+std::string WaterSource::errorDesc() const{  return _d->errorStr;}
+void WaterSource::_setError(const std::string& error){  _d->errorStr = error;}
+
 void WaterSource::save(VariantMap &stream) const
 {
   Construction::save( stream );
@@ -309,7 +271,6 @@ void WaterSource::load(const VariantMap &stream)
   Construction::load( stream );
   VARIANT_LOAD_ANY_D( _d, water, stream )
   VARIANT_LOAD_ANY_D( _d, isRoad, stream )
-  _d->daysWithoutWater = 0;
 }
 
 
@@ -21,6 +21,7 @@
 #include "core/position.hpp"
 #include "service.hpp"
 #include "core/direction.hpp"
+#include "core/tilepos_array.hpp"
 
 class WaterSource : public Construction
 {
@@ -28,20 +29,27 @@ public:
   WaterSource( const object::Type type, const Size& size );
   ~WaterSource();
   
-  virtual void addWater( const WaterSource& source );
   virtual bool haveWater() const;  
   virtual void timeStep(const unsigned long time);
   virtual void save(VariantMap &stream) const;
   virtual void load(const VariantMap &stream);
   virtual std::string errorDesc() const;
-  virtual void broke();
+
+  //! gives water without neighbours, level of network starts here
+  virtual bool isSource() const;
+
+  //! tiles where water flows from this object
+  virtual TilePosArray outlets() const;
 
   int water() const;
 
+  //! level is set by city water network
+  void setWater( int value );
+
 protected:
   void _setError( const std::string& error );
   virtual void _waterStateChanged() {}
-  virtual void _produceWater(const TilePos* points, const int size);
+  void _updateNetwork( bool attach );
   void _setIsRoad( bool value );
   bool _isRoad() const;
   
@@ -64,15 +72,16 @@ public:
   virtual bool getMinimapColor(int &color1, int &color2) const;
   virtual void destroy();
   virtual std::string troubleDesc() const;
-  virtual void addWater( const WaterSource& source );
   virtual void initialize(const object::Info& mdata);
-  virtual void broke();
+  virtual bool isSource() const;
+  virtual TilePosArray outlets() const;
 
   TilePos entry( Direction direction );
 
 private:
   bool _isWaterSource;
-  void _dropWater();
+  bool _haveCoverage;
+  void _changeCoverage( int delta );
   void _waterStateChanged();
   bool _isNearWater( PlayerCityPtr city, const TilePos& pos ) const;
 };
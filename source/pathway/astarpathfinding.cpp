@@ -16,8 +16,9 @@
 #include "objects/construction.hpp"
 #include "astarpathfinding.hpp"
 #include "gfx/tilemap.hpp"
+#include "gfx/tilemasks.hpp"
 #include "core/position.hpp"
-#include "astarpoint.hpp"
+#include "astarpool.hpp"
 #include "path_finding.hpp"
 #include "core/utils.hpp"
 #include "core/foreach.hpp"
@@ -26,10 +27,9 @@
 #include <set>
 
 using namespace std;
+using namespace gfx;
 
 namespace {
-static const AStarPoint invalidPoint;
-typedef std::vector< AStarPoint* > APoints;
 static SimpleLogger LOG_PF( "PathFinder" );
 }
 
@@ -37,73 +37,34 @@ class Pathfinder::Impl
 {
 public:
   TilePossibleCondition condition;
+  const TileMasks* masks;
+  int maskFlag;  // built-in condition, 0 means call delegate
 
-  class Grid : std::vector< AStarPoint* >
-  {
-  public:
-    inline size_type hash( const TilePos& pos ) const { return pos.j() * _size.width() + pos.i(); }
-
-    AStarPoint* operator[](const TilePos& pos ) const
-    {
-      return *(begin() + hash( pos ));
-    }
-
-    void reset( int width, int height )
-    {
-      foreach( it, *this )
-      {
-        delete *it;
-        *it = 0;
-      }
-
-      _size = Size( width, height );
-      resize( _size.area() );
-    }
-
-    void init( Tile* tile )
-    {
-      *(begin() + hash( tile->pos() ) ) = new AStarPoint( tile );
-    }
-
-    Size _size;
-  };
-
-  Grid grid;
+  AStarPool pool;
   unsigned int maxLoopCount;
   int verbose;
 
   bool getTraversingPoints(TilePos start, TilePos stop, Pathway& oPathWay );
 
-  AStarPoint* at( const TilePos& pos ) const
-  {
-    if( isValid( pos ) )
-    {
-      return grid[ pos ];
-    }
-    else
-    {
-      //LOG_PF.info( "ERROR: failed to gather point (%d,%d) on grid", pos.getI(), pos.getJ() );
-      return 0;
-    }
-  }
-
   const Tile* tile( const TilePos& pos ) const
   {
-    AStarPoint* ap = at( pos );
-    return ap ? ap->tile : 0;
+    return pool.isValid( pos ) ? pool.tiles[ pool.index( pos ) ] : 0;
   }
 
   bool isValid( const TilePos& pos ) const
   {
-    return ( pos.i() >= 0 && pos.j() >= 0 && pos.i() < grid._size.width() && pos.j() < grid._size.height() );
+    return pool.isValid( pos );
   }
 
-  bool isWalkable( const TilePos& pos )
+  bool isWalkable( int i, int j )
   {
-    if( isValid( pos ) )
+    if( pool.isValid( i, j ) )
     {
+       if( maskFlag )
+         return (masks->at( pool.index( i, j ) ) & maskFlag) != 0;
+
        bool ret;
-       condition( at( pos )->tile, ret );
+       condition( pool.tiles[ pool.index( i, j ) ], ret );
        return ret;
     }
     return false;
@@ -122,6 +83,8 @@ Pathfinder::Pathfinder() : _d( new Impl )
 
   _d->maxLoopCount = 4800;
   _d->verbose = 0;
+  _d->masks = 0;
+  _d->maskFlag = 0;
 }
 
 void Pathfinder::update( const Tilemap& tilemap )
@@ -130,26 +93,27 @@ void Pathfinder::update( const Tilemap& tilemap )
 
   LOG_PF.info( "Resizing grid to {}", tilemap.size());
   int size = tilemap.size();
-  _d->grid.reset( size, size );
+  _d->pool.reset( size, size );
+  _d->masks = &tilemap.masks();
 
-  LOG_PF.info( "Allocating AStarPoints" );
+  LOG_PF.info( "Filling node pool" );
   const TilesArray& tiles = tilemap.allTiles();
   for (auto& tile : tiles) {
-    _d->grid.init(tile);
+    _d->pool.tiles[ _d->pool.index( tile->pos() ) ] = tile;
   }
   LOG_PF.info( "Updating finished" );
 }
 
 Pathway Pathfinder::getPath(TilePos start, TilesArray arrivedArea, int flags)
 {
-  if( _d->grid._size.area() == 0 )
+  if( _d->pool.empty() )
     return Pathway();
 
   Pathway oPathway;
   if( (flags & Pathway::checkStart) )
   {
-    AStarPoint* ap = _d->at( start );
-    if( !ap || !(ap->tile) || !(ap->tile->isWalkable( true ) ) )
+    const Tile* tile = _d->tile( start );
+    if( !tile || !tile->isWalkable( true ) )
       return Pathway();
   }
 
@@ -184,7 +148,7 @@ Pathway Pathfinder::getPath(TilePos start, TilePos stop,  int flags)
     return Pathway();
   }
 
-  if( _d->grid._size.area() == 0 )
+  if( _d->pool.empty() )
   {
     return Pathway();
   }
@@ -205,7 +169,7 @@ bool Pathfinder::Impl::getTraversingPoints( TilePos start, TilePos stop, Pathway
   while( cPos != stop )
   {
     TilePos move( math::clamp( stop.i() - cPos.i(), -1, 1 ), math::clamp( stop.j() - cPos.j(), -1, 1 ) );
-    oPathway.setNextTile( *(at( cPos + move )->tile) );
+    oPathway.setNextTile( *tile( cPos + move ) );
     cPos += move;
   }
 
@@ -216,16 +180,6 @@ unsigned int Pathfinder::maxLoopCount() const {  return _d->maxLoopCount; }
 void Pathfinder::setMaxLoopCount(unsigned int count){ _d->maxLoopCount = count; }
 void Pathfinder::setVerboseMode(int level) {  _d->verbose = level;}
 
-bool _inArea( APoints& area, AStarPoint* end )
-{
-  for (auto& p : area) {
-    if (p == end)
-      return true;
-  }
-
-  return false;
-}
-
 void Pathfinder::Impl::isRoad( const Tile* tile, bool& possible ) {  possible = tile ? tile->isWalkable( false ) : false; }
 void Pathfinder::Impl::isTerrain( const Tile* tile, bool& possible ) { possible = tile ? tile->isWalkable( true ) : false; }
 void Pathfinder::Impl::isDeepWater( const Tile* tile, bool& possible ) { possible = tile ? tile->getFlag( Tile::tlDeepWater ) : false; }
@@ -248,14 +202,14 @@ bool Pathfinder::Impl::aStar( const TilePos& startPos, TilesArray arrivedArea, P
     return false;
   }
 
-  AStarPoint* ap = at(startPos);
-  if (!ap || !ap->tile)
+  const Tile* startTile = tile(startPos);
+  if (!startTile)
   {
     LOG_PF.warn("AStar: wrong start pos at [{},{}]", startPos.i(), startPos.j());
     return false;
   }
 
-  oPathWay.init(*(ap->tile));
+  oPathWay.init(*startTile);
 
   for (auto tile : arrivedArea)
   {
@@ -268,62 +222,65 @@ bool Pathfinder::Impl::aStar( const TilePos& startPos, TilesArray arrivedArea, P
 
   bool useRoad = ((flags & Pathway::ignoreRoad) == 0);
 
+  maskFlag = 0;
   if ((flags & Pathway::customCondition)) {}
-  else if((flags & Pathway::roadOnly) > 0) { condition = makeDelegate(this, &Impl::isRoad); }
-  else if((flags & Pathway::terrainOnly) > 0) { condition = makeDelegate(this, &Impl::isTerrain); }
-  else if((flags & Pathway::deepWaterOnly) > 0) { condition = makeDelegate(this, &Impl::isDeepWater); }
-  else if((flags & Pathway::waterOnly) > 0) { condition = makeDelegate(this, &Impl::isWater); }
+  else if((flags & Pathway::roadOnly) > 0) { condition = makeDelegate(this, &Impl::isRoad); maskFlag = TileMasks::road; }
+  else if((flags & Pathway::terrainOnly) > 0) { condition = makeDelegate(this, &Impl::isTerrain); maskFlag = TileMasks::terrain; }
+  else if((flags & Pathway::deepWaterOnly) > 0) { condition = makeDelegate(this, &Impl::isDeepWater); maskFlag = TileMasks::deepWater; }
+  else if((flags & Pathway::waterOnly) > 0) { condition = makeDelegate(this, &Impl::isWater); maskFlag = TileMasks::water; }
   else
   {
     return false;
   }
 
-  // Define points to work with
-  AStarPoint* start = at(startPos);
-  if (!start)
-    return false;
-  APoints endPoints;
-
-  for (auto tile : arrivedArea) { endPoints.push_back(at(tile->pos())); }
+  pool.nextGeneration();
 
-  AStarPoint* current = NULL;
-  AStarPoint* child = NULL;
+  // Define points to work with
+  AStarPool::Index start = pool.index(startPos);
+  for (auto tile : arrivedArea)
+  {
+    if (pool.isValid(tile->pos()))
+      pool.setTarget(pool.index(tile->pos()));
+  }
 
-  // Define the open and the close list
-  list<AStarPoint*> openList;
-  list<AStarPoint*> closedList;
+  // heuristic always aims at the first arrived tile
+  const TilePos& endPos = arrivedArea.front()->pos();
+  const bool fourDirection = (flags & Pathway::fourDirection) != 0;
 
+  AStarPool::Index current = AStarPool::invalid;
   unsigned int n = 0;
+  bool found = false;
 
-  // Add the start point to the openList
-  openList.push_back( start );
-  start->opened = true;
+  // Add the start point to the open set
+  pool.open(start, AStarPool::invalid, 0, 0);
 
-  while (n == 0 || ( !_inArea(endPoints, current) && n < maxLoopCount))
+  while (n == 0 || n < maxLoopCount)
   {
     n++;
-    // Look for the smallest F value in the openList and make it the current point
-    for(auto& point : openList)
+    if (!pool.hasOpened())
     {
-      if( point == openList.front() || point->getFScore() <= current->getFScore() )
-      {
-        current = point;
-      }
+      // nothing more to expand, target is unreachable
+      n = maxLoopCount;
+      break;
     }
 
+    // Smallest F value in the open set becomes the current point
+    current = pool.top();
+
     // Stop if we reached the end
-    if (_inArea( endPoints, current))
+    if (pool.isTarget(current))
     {
+      found = true;
       break;
     }
 
-    // Remove the current point from the openList
-    openList.remove(current);
-    current->opened = false;
+    pool.close(current);
 
-    // Add the current point to the closedList
-    closedList.push_back(current);
-    current->closed = true;
+    const int ci = pool.i(current);
+    const int cj = pool.j(current);
+    const int roadScore = useRoad
+                            ? (pool.tiles[current]->getFlag(Tile::tlRoad) ? 0 : 10)
+                            : 0;
 
     // Get all current's adjacent walkable points
     for (int x = -1; x < 2; x ++)
@@ -336,98 +293,83 @@ bool Pathfinder::Impl::aStar( const TilePos& startPos, TilesArray arrivedArea, P
           continue;
         }
 
-        if( (flags & Pathway::fourDirection) && !(x==0 || y==0) )
+        const bool corner = (x != 0 && y != 0);
+        if (fourDirection && corner)
           continue;
-        // Get this point
-        child = at(current->getPos() + TilePos(x, y));
 
-        if (!child)
+        const int ni = ci + x;
+        const int nj = cj + y;
+        if (!pool.isValid(ni, nj))
         {
-          //LOG_PF.info( "No child for parent is (%d,%d)", current->getPos().getI() + x, current->getPos().getJ() + y );
           continue;
         }
 
+        AStarPool::Index child = pool.index(ni, nj);
+
         // If it's closed or not walkable then pass
-        if (child->closed || !isWalkable( child->getPos()))
+        if (pool.isClosed(child) || !isWalkable(ni, nj))
         {
           continue;
         }
 
         // If we are at a corner
-        if (x != 0 && y != 0)
+        if (corner)
         {
           // if the next horizontal point is not walkable or in the closed list then pass
-          //AStarPoint* tmpPoint = getPoint( current->pos + TilePos( 0, y ) );
-          TilePos tmp = current->getPos() + TilePos(0, y);
-          if (!isWalkable(tmp) || at(tmp)->closed)
+          if (!isWalkable(ci, nj) || pool.isClosed(pool.index(ci, nj)))
           {
             continue;
           }
 
-          tmp = current->getPos() + TilePos( x, 0 );
           // if the next vertical point is not walkable or in the closed list then pass
-          if (!isWalkable(tmp) || at(tmp)->closed)
+          if (!isWalkable(ni, cj) || pool.isClosed(pool.index(ni, cj)))
           {
             continue;
           }
         }
 
-        // If it's already in the openList
-        if (child->opened)
+        int g = pool.g[current] + (corner ? 14 : 10) + roadScore;
+        int h = (abs(endPos.i() - ni) + abs(endPos.j() - nj)) * 10;
+
+        // If it's already in the open set
+        if (pool.isOpened(child))
         {
           // If it has a wroste g score than the one that pass through the current point
           // then its path is improved when it's parent is the current point
-          if (child->getGScore() > child->getGScore(current, useRoad))
+          if (pool.g[child] > g)
           {
-            // Change its parent and g score
-            child->setParent(current);
-            child->computeScores(endPoints.front(), useRoad);
+            pool.improve(child, current, g, g + h);
           }
         }
         else
         {
-          // Add it to the openList with current point as parent
-          openList.push_back(child);
-          child->opened = true;
-
-          // Compute it's g, h and f score
-          child->setParent(current);
-          child->computeScores(endPoints.front(), useRoad);
+          pool.open(child, current, g, g + h);
         }
       }
     }
   }
 
-  // Reset
-  for (auto point : openList) {
-    point->opened = false;
-  }
-
-  for (auto point : closedList) {
-    point->closed = false;
-  }
-
-  if( n == maxLoopCount )
+  if (!found || n == maxLoopCount)
   {
-    if( verbose > 0 )
+    if (verbose > 0)
     {
       LOG_PF.warn( "AStar: maxLoopCount reached from [{},{}] to [{},{}]",
-                       startPos.i(), startPos.j(), endPoints.front()->getPos().i(), endPoints.front()->getPos().j() );
+                       startPos.i(), startPos.j(), endPos.i(), endPos.j() );
       crashhandler::printstack(false);
     }
     return false;
   }
+
   // Resolve the path starting from the end point
-  APoints lPath;
-  while (current->hasParent() && current != start)
+  std::vector<AStarPool::Index> lPath;
+  while (pool.parent[current] != AStarPool::invalid && current != start)
   {
-    lPath.insert(lPath.begin(), 1, current);
-    current = current->getParent();
-    n++;
+    lPath.push_back(current);
+    current = pool.parent[current];
   }
 
-  for( auto pathPoint : lPath) {
-    oPathWay.setNextTile( *(pathPoint->tile) );
+  for (auto it = lPath.rbegin(); it != lPath.rend(); ++it) {
+    oPathWay.setNextTile(*(pool.tiles[*it]));
   }
 
   return oPathWay.length() > 1;
@@ -0,0 +1,193 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __CAESARIA_ASTARPOOL_H_INCLUDED__
+#define __CAESARIA_ASTARPOOL_H_INCLUDED__
+
+#include "core/position.hpp"
+#include "gfx/tile.hpp"
+#include <vector>
+#include <algorithm>
+
+// Flat node storage for A*, one slot per tilemap cell.
+// Open/closed state is stamped with the search generation,
+// so starting a new query never needs to touch the whole pool.
+class AStarPool
+{
+public:
+  typedef unsigned int Index;
+  enum { invalid = 0xffffffff };
+
+  AStarPool() : _width( 0 ), _height( 0 ), _generation( 0 ), _counter( 0 ) {}
+
+  void reset( int width, int height )
+  {
+    _width = width;
+    _height = height;
+    _generation = 0;
+
+    unsigned int area = width * height;
+    tiles.assign( area, 0 );
+    g.assign( area, 0 );
+    f.assign( area, 0 );
+    parent.assign( area, invalid );
+    order.assign( area, 0 );
+    heapPos.assign( area, invalid );
+    openMark.assign( area, 0 );
+    closeMark.assign( area, 0 );
+    targetMark.assign( area, 0 );
+
+    _heap.clear();
+    _heap.reserve( area );
+  }
+
+  inline bool empty() const { return tiles.empty(); }
+  inline bool isValid( int i, int j ) const { return i >= 0 && j >= 0 && i < _width && j < _height; }
+  inline bool isValid( const TilePos& pos ) const { return isValid( pos.i(), pos.j() ); }
+  inline Index index( int i, int j ) const { return j * _width + i; }
+  inline Index index( const TilePos& pos ) const { return index( pos.i(), pos.j() ); }
+  inline int i( Index idx ) const { return idx % _width; }
+  inline int j( Index idx ) const { return idx / _width; }
+  inline TilePos pos( Index idx ) const { return TilePos( i( idx ), j( idx ) ); }
+
+  void nextGeneration()
+  {
+    _heap.clear();
+    _counter = 0;
+    _generation++;
+    if( _generation == 0 )
+    {
+      // stamps wrapped around, old marks could match again
+      std::fill( openMark.begin(), openMark.end(), 0 );
+      std::fill( closeMark.begin(), closeMark.end(), 0 );
+      std::fill( targetMark.begin(), targetMark.end(), 0 );
+      _generation = 1;
+    }
+  }
+
+  inline bool isOpened( Index idx ) const { return openMark[ idx ] == _generation; }
+  inline bool isClosed( Index idx ) const { return closeMark[ idx ] == _generation; }
+  inline bool isTarget( Index idx ) const { return targetMark[ idx ] == _generation; }
+  inline void setTarget( Index idx ) { targetMark[ idx ] = _generation; }
+
+  inline bool hasOpened() const { return !_heap.empty(); }
+  inline Index top() const { return _heap.front(); }
+
+  void open( Index idx, Index from, int gScore, int fScore )
+  {
+    openMark[ idx ] = _generation;
+    parent[ idx ] = from;
+    g[ idx ] = gScore;
+    f[ idx ] = fScore;
+    order[ idx ] = _counter++;
+
+    heapPos[ idx ] = _heap.size();
+    _heap.push_back( idx );
+    _siftUp( heapPos[ idx ] );
+  }
+
+  void improve( Index idx, Index from, int gScore, int fScore )
+  {
+    parent[ idx ] = from;
+    g[ idx ] = gScore;
+    f[ idx ] = fScore;
+    _siftUp( heapPos[ idx ] );
+  }
+
+  void close( Index idx )
+  {
+    closeMark[ idx ] = _generation;
+
+    unsigned int pos = heapPos[ idx ];
+    Index last = _heap.back();
+    _heap.pop_back();
+    heapPos[ idx ] = invalid;
+    if( pos < _heap.size() )
+    {
+      _heap[ pos ] = last;
+      heapPos[ last ] = pos;
+      _siftDown( pos );
+      _siftUp( heapPos[ last ] );
+    }
+  }
+
+  std::vector<const gfx::Tile*> tiles;
+  std::vector<int> g;
+  std::vector<int> f;
+  std::vector<Index> parent;
+  std::vector<unsigned int> order;
+  std::vector<unsigned int> heapPos;
+  std::vector<unsigned int> openMark;
+  std::vector<unsigned int> closeMark;
+  std::vector<unsigned int> targetMark;
+
+private:
+  // lowest f first, on equal f the latest opened node wins
+  inline bool _before( Index a, Index b ) const
+  {
+    return f[ a ] < f[ b ] || ( f[ a ] == f[ b ] && order[ a ] > order[ b ] );
+  }
+
+  inline void _place( unsigned int pos, Index idx )
+  {
+    _heap[ pos ] = idx;
+    heapPos[ idx ] = pos;
+  }
+
+  void _siftUp( unsigned int pos )
+  {
+    Index idx = _heap[ pos ];
+    while( pos > 0 )
+    {
+      unsigned int up = (pos - 1) / 2;
+      if( !_before( idx, _heap[ up ] ) )
+        break;
+
+      _place( pos, _heap[ up ] );
+      pos = up;
+    }
+    _place( pos, idx );
+  }
+
+  void _siftDown( unsigned int pos )
+  {
+    Index idx = _heap[ pos ];
+    unsigned int count = _heap.size();
+    while( true )
+    {
+      unsigned int child = pos * 2 + 1;
+      if( child >= count )
+        break;
+
+      if( child + 1 < count && _before( _heap[ child + 1 ], _heap[ child ] ) )
+        child++;
+
+      if( !_before( _heap[ child ], idx ) )
+        break;
+
+      _place( pos, _heap[ child ] );
+      pos = child;
+    }
+    _place( pos, idx );
+  }
+
+  int _width;
+  int _height;
+  unsigned int _generation;
+  unsigned int _counter;
+  std::vector<Index> _heap;
+};
+
+#endif //__CAESARIA_ASTARPOOL_H_INCLUDED__
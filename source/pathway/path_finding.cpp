@@ -23,21 +23,31 @@
 #include "core/position.hpp"
 #include "objects/road.hpp"
 #include "gfx/tile.hpp"
+#include "gfx/tilemasks.hpp"
 #include "core/variant.hpp"
 #include "city/statistic.hpp"
+#include "city/roadgraph.hpp"
 #include "core/logger.hpp"
 #include "objects/building.hpp"
+#include <vector>
+#include <algorithm>
 
 using namespace gfx;
 
+namespace {
+struct Offset { int i, j; };
+// same order as Tilemap::getNeighbors returns tiles
+static const Offset allNeighbors[] = { { -1, -1 }, { -1, 0 }, { -1, 1 }, { 0, 1 },
+                                       { 1, 1 }, { 1, 0 }, { 1, -1 }, { 0, -1 } };
+static const Offset fourNeighbors[] = { { -1, 0 }, { 0, 1 }, { 1, 0 }, { 0, -1 } };
+}
+
 class Propagator::Impl
 {
 public:
-  std::set<PathwayPtr> activeBranches;
+  enum { noParent=-1 };
 
-  typedef std::map<Tile*, PathwayPtr> RouteMap;
-
-  RouteMap completedBranches;
+  TilesArray origins;
   Propagator::ObsoleteOverlays obsoleteOvs;
   PlayerCityPtr city;
 
@@ -45,14 +55,113 @@ public:
   Tilemap* tilemap;
   bool allLands;  // true if can walk in all lands, false if limited to roads
   bool allDirections;  // true if can walk in all directions, false if limited to North/South/East/West
+
+  // flat per-tile state, a cell is valid only when its mark equals current generation
+  int size;
+  unsigned int generation;
+  std::vector<unsigned int> mark;
+  std::vector<int> distance;  // steps from the closest origin
+  std::vector<int> parent;    // index of previous tile on the way
+
+  void reset();
+  void seed();
+  int fill( unsigned int maxDistance, const std::vector<int>& targets );
+  int closest( const TilesArray& tiles ) const;
+  bool isPassable( int i, int j, TileMasks::Flag walkFlag ) const;
+  PathwayPtr way( int index, int root ) const;
+
+  inline int index( const Tile& tile ) const { return tile.j() * size + tile.i(); }
+  inline bool isVisited( int idx ) const { return mark[ idx ] == generation; }
+
+  inline void visit( int idx, int from, int dist )
+  {
+    mark[ idx ] = generation;
+    parent[ idx ] = from;
+    distance[ idx ] = dist;
+  }
+
+  inline const Offset* neighbors( int& count ) const
+  {
+    count = allDirections ? 8 : 4;
+    return allDirections ? allNeighbors : fourNeighbors;
+  }
 };
 
+void Propagator::Impl::reset()
+{
+  if( size != tilemap->size() )
+  {
+    size = tilemap->size();
+    mark.assign( size * size, 0 );
+    distance.assign( size * size, 0 );
+    parent.assign( size * size, noParent );
+    generation = 0;
+  }
+
+  generation++;
+  if( generation == 0 )
+  {
+    // stamps wrapped around, old marks could match again
+    std::fill( mark.begin(), mark.end(), 0 );
+    generation = 1;
+  }
+}
+
+void Propagator::Impl::seed()
+{
+  reset();
+
+  // init trivial completed branches
+  for( auto tile : origins )
+  {
+    int idx = index( *tile );
+    if( !isVisited( idx ) )
+      visit( idx, noParent, 0 );
+  }
+}
+
+bool Propagator::Impl::isPassable( int i, int j, TileMasks::Flag walkFlag ) const
+{
+  if( !tilemap->masks().is( i, j, walkFlag ) )
+    return false;
+
+  if( obsoleteOvs.empty() )
+    return true;
+
+  OverlayPtr overlay = tilemap->at( i, j ).overlay();
+  return overlay.isNull() || !obsoleteOvs.count( overlay->type() );
+}
+
+PathwayPtr Propagator::Impl::way( int idx, int root ) const
+{
+  std::vector<int> chain;
+  chain.push_back( idx );
+  while( idx != root && parent[ idx ] != noParent )
+  {
+    idx = parent[ idx ];
+    chain.push_back( idx );
+  }
+
+  PathwayPtr pathWay( new Pathway() );
+  pathWay->drop();
+
+  auto it = chain.rbegin();
+  pathWay->init( tilemap->at( *it % size, *it / size ) );
+  for( ++it; it != chain.rend(); ++it )
+    pathWay->setNextTile( tilemap->at( *it % size, *it / size ) );
+
+  return pathWay;
+}
+
 Propagator::Propagator(PlayerCityPtr city) : _d( new Impl )
 {
   _d->city = city;
   _d->tilemap = &city->tilemap();
+  _d->origin = 0;
   _d->allLands = false;
   _d->allDirections = true;
+  _d->size = 0;
+  _d->generation = 0;
 }
 
 void Propagator::setAllLands(const bool value) {   _d->allLands = value;}
@@ -87,125 +196,121 @@ void Propagator::init( Tile& origin )
 
 void Propagator::init(const TilesArray& origin)
 {
-  _d->activeBranches.clear();
-  _d->completedBranches.clear();
   _d->obsoleteOvs.clear();
+  _d->origins = origin;
+  _d->seed();
+}
+
+int Propagator::Impl::fill( unsigned int maxDistance, const std::vector<int>& targets )
+{
+  const TileMasks::Flag walkFlag = allLands ? TileMasks::terrain : TileMasks::road;
+  int offsetsCount;
+  const Offset* offsets = neighbors( offsetsCount );
+
+  // breadth first, so every tile is reached by one of the shortest ways
+  seed();
 
-  // init propagation
-  foreach( it, origin )
+  std::vector<int> queue;
+  for( auto tile : origins )
   {
-    // std::cout << "Tile access " << tile.getI() << "," << tile.getJ() << std::endl;
-    Tile* tile = *it;
-    PathwayPtr pathWay( new Pathway() );
-    pathWay->drop();
-    pathWay->init( *tile );
-    // init active branches
-    _d->activeBranches.insert( pathWay );
-    // init trivial completed branches
-    _d->completedBranches.insert( std::pair<Tile*, PathwayPtr>( tile, pathWay ) );
+    int idx = index( *tile );
+    if( parent[ idx ] == noParent )
+      queue.push_back( idx );
   }
-}
 
-void Propagator::propagate(const unsigned int maxDistance)
-{
-   int nbLoops = 0;  // to detect infinite loops
+  for( unsigned int head=0; head < queue.size(); head++ )
+  {
+    int idx = queue[ head ];
+    if( !targets.empty() && std::binary_search( targets.begin(), targets.end(), idx ) )
+      return idx;
 
-   std::set<PathwayPtr>::iterator firstBranch;
-   std::set<PathwayPtr>& activeBranches = _d->activeBranches;
-   const ObsoleteOverlays& obsoleteOvs = _d->obsoleteOvs;
+    // way length counts tiles, origin is the first one
+    int dist = distance[ idx ];
+    if( (unsigned int)dist + 2 > maxDistance )
+    {
+      // tiles left in queue are within range, but their neighbors are not
+      continue;
+    }
 
-   // propagate on all tiles
-   while (!activeBranches.empty())
-   {
-      // while there are active paths
-      if ((nbLoops++)>10000)
+    int ci = idx % size;
+    int cj = idx / size;
+    for( int k=0; k < offsetsCount; k++ )
+    {
+      int ni = ci + offsets[ k ].i;
+      int nj = cj + offsets[ k ].j;
+      if( !isPassable( ni, nj, walkFlag ) )
+        continue;
+
+      int nidx = nj * size + ni;
+      if( !isVisited( nidx ) )
       {
-        Logger::warning( "!!! Infinite loop detected during propagation");
-        _d->completedBranches.clear();
-        return;
+        visit( nidx, idx, dist + 1 );
+        queue.push_back( nidx );
       }
+    }
+  }
 
-      // get the shortest active path
-      firstBranch = activeBranches.begin();
+  return noParent;
+}
 
-      PathwayPtr pathWay = *firstBranch;
-      const Tile& tile = pathWay->back();
-      //std::cout << "Propagation from tile " << tile.getI() << ", " << tile.getJ() << std::endl;
+int Propagator::Impl::closest( const TilesArray& tiles ) const
+{
+  int bestIndex = noParent;
+  for( auto& tile : tiles )
+  {
+    int idx = index( *tile );
+    if( !isVisited( idx ) )
+      continue;
 
-      unsigned int tileLength = 1;
-      if( pathWay->length() + tileLength > maxDistance)
-      {
-         // we processed all paths within range. stop the propagation
-         //std::cout << "MaxDistance reached. stop propagation" << std::endl;
-         break;
-      }
+    if( bestIndex == noParent || distance[ idx ] < distance[ bestIndex ] )
+      bestIndex = idx;
+  }
 
-      // propagate to neighbour tiles
-      TilesArray accessTiles = _d->tilemap->getNeighbors(tile.pos(), _d->allDirections ? Tilemap::AllNeighbors : Tilemap::FourNeighbors);
-      foreach( itr, accessTiles )
-      {
-        Tile* tile2 = *itr;
-        // for every neighbor tile
-        bool tileWalkable = tile2->isWalkable( _d->allLands );
-        bool overlayWalkable = true;
-        if( tile2->overlay().isValid() )
-        {
-          overlayWalkable = !obsoleteOvs.count( tile2->overlay()->type() );
-        }
+  return bestIndex;
+}
 
-        if( tileWalkable && overlayWalkable )
-        {
-          // std::cout << "Next tile: " << tile2.getI() << ", " << tile2.getJ() << std::endl;
+void Propagator::propagate(const unsigned int maxDistance)
+{
+  _d->fill( maxDistance, std::vector<int>() );
+}
 
-          if (_d->completedBranches.find( tile2 )==_d->completedBranches.end())
-          {
-            // the tile has not been processed yet
-            PathwayPtr pathWay2( new Pathway( *pathWay.object() ) );
-            pathWay2->drop();
-            pathWay2->setNextTile( *tile2 );
+Tile* Propagator::propagateTo(const TilesArray& targets, const unsigned int maxDistance)
+{
+  std::vector<int> indexes;
+  for( auto tile : targets )
+    indexes.push_back( _d->index( *tile ) );
 
-            _d->activeBranches.insert(pathWay2);
-            _d->completedBranches.insert(std::pair<Tile*, PathwayPtr>( tile2, pathWay2));
+  if( indexes.empty() )
+    return 0;
 
-            // pathWay2.prettyPrint();
-            // std::cout << "distance at:" << tile2.getI() << "," << tile2.getJ() << " is:" << pathWay2.getLength() << std::endl;
-          }
-        }
-      }
+  std::sort( indexes.begin(), indexes.end() );
+  int idx = _d->fill( maxDistance, indexes );
+
+  return idx != Impl::noParent ? &_d->tilemap->at( idx % _d->size, idx / _d->size ) : 0;
+}
 
-      // this path is no longer active
-      _d->activeBranches.erase(firstBranch);
-   }
+Pathway Propagator::wayTo(const TilesArray& tiles) const
+{
+  int idx = _d->closest( tiles );
+  return idx != Impl::noParent ? *_d->way( idx, Impl::noParent ).object() : Pathway();
 }
 
 DirectPRoutes Propagator::getRoutes(const object::Type buildingType)
 {
   DirectPRoutes ret;
   // init the building list
-  ConstructionList constructionList = _d->city->statistic().objects.find<Construction>( buildingType );
+  const ConstructionList& constructionList = _d->city->roadGraph().destinations( buildingType );
 
   // for each destination building
   for( auto destination : constructionList )
   {
-    std::set<PathwayPtr> destPath;  // paths to the current building, ordered by distance
+    // closest reached roadside tile of the current building
+    int bestIndex = _d->closest( destination->roadside() );
 
-    const TilesArray& destTiles = destination->roadside();
-    for( auto& tile : destTiles )
-    {
-      // searches path to that given tile
-      Impl::RouteMap::iterator pathWayIt= _d->completedBranches.find( tile );
-
-      if( pathWayIt != _d->completedBranches.end() )
-      {
-        // we found a path!!!
-        destPath.insert( pathWayIt->second );
-      }
-    }
-
-    if (!destPath.empty())
+    if( bestIndex != Impl::noParent )
     {
       // there is a path to that destination
-      ret[ destination ] = *destPath.begin();
+      ret[ destination ] = _d->way( bestIndex, Impl::noParent );
     }
   }
 
@@ -214,100 +319,69 @@ DirectPRoutes Propagator::getRoutes(const object::Type buildingType)
 
 PathwayList Propagator::getWays(const unsigned int maxDistance)
 {
-  PathwayList oPathWayList;
-  int nbLoops = 0;  // to detect infinite loops
+  struct Branch { int root, head; unsigned int length; };
 
-  std::set<PathwayPtr>::iterator firstBranch;
+  PathwayList oPathWayList;
+  const TileMasks::Flag walkFlag = _d->allLands ? TileMasks::terrain : TileMasks::road;
+  int offsetsCount;
+  const Offset* offsets = _d->neighbors( offsetsCount );
 
-  std::set< Tile* > markTiles;
-  const ObsoleteOverlays& obsoleteOvs = _d->obsoleteOvs;
+  // every tile may belong only to one branch, origins stay free
+  // until some branch walks through them
+  _d->reset();
 
-  // propagate all branches
-  while( !_d->activeBranches.empty() )
+  std::vector<Branch> activeBranches;
+  for( auto it = _d->origins.rbegin(); it != _d->origins.rend(); ++it )
   {
-    // while there are active branches
-
-    // get an active branch
-    firstBranch = _d->activeBranches.begin();
+    Branch branch = { _d->index( **it ), _d->index( **it ), 1 };
+    activeBranches.push_back( branch );
+  }
 
-    PathwayPtr pathWay( new Pathway( *const_cast<PathwayPtr&>( *firstBranch ).object() ) );
+  int nextTiles[ 8 ];
+  while( !activeBranches.empty() )
+  {
+    Branch branch = activeBranches.back();
+    activeBranches.pop_back();
 
-    while( pathWay->length() < maxDistance)
+    while( branch.length < maxDistance )
     {
       // propagate branch until maxDistance is reached
-      if ((nbLoops++)>100000)
-      {
-        Logger::warning("Infinite loop detected during propagation");
-        return PathwayList();
-      }
-
-      const Tile& tile = pathWay->back();
-      // std::cout << "Propagation from tile " << tile.getI() << ", " << tile.getJ() << std::endl;
-
-      // propagate to neighbour tiles
-      TilesArray accessTiles = _d->tilemap->getNeighbors(tile.pos(), _d->allDirections ? Tilemap::AllNeighbors : Tilemap::FourNeighbors);
-
-      // nextTiles = accessTiles - alreadyProcessedTiles
-      TilesArray nextTiles;
-      foreach( itr, accessTiles )
+      int ci = branch.head % _d->size;
+      int cj = branch.head / _d->size;
+      int nextCount = 0;
+      for( int k=0; k < offsetsCount; k++ )
       {
-        Tile* tile2 = *itr;
-        // for every neighbour tile
-        bool notResolved = (markTiles.find( tile2 ) == markTiles.end());
-
-        bool tileWalkable = tile2->isWalkable( _d->allLands );
-        bool overlayWalkable = true;
-        if( tile2->overlay().isValid() )
-        {
-          overlayWalkable = !obsoleteOvs.count( tile2->overlay()->type() );
-        }
+        int ni = ci + offsets[ k ].i;
+        int nj = cj + offsets[ k ].j;
+        if( !_d->isPassable( ni, nj, walkFlag ) )
+          continue;
 
-        if( tileWalkable && overlayWalkable && !pathWay->contains( *tile2 ) && notResolved)
+        int nidx = nj * _d->size + ni;
+        if( nidx != branch.root && !_d->isVisited( nidx ) )
         {
-          nextTiles.push_back( tile2 );
-          markTiles.insert( tile2 );
+          _d->visit( nidx, branch.head, branch.length );
+          nextTiles[ nextCount++ ] = nidx;
         }
       }
 
-      if (nextTiles.size() == 0)
+      if( nextCount == 0 )
       {
         // the current branch has been fully maximized
         break;
       }
 
-      foreach( itTile, nextTiles )
+      // side tiles start own branches, current one goes on with the last tile
+      for( int k=0; k < nextCount-1; k++ )
       {
-        // for every neighbor tile
-        Tile &tile2 = **itTile;
-        // std::cout << "Next tile: " << tile2.getI() << ", " << tile2.getJ() << std::endl;
-
-        if (*itTile == nextTiles.back())
-        {
-          // update the current branch
-          // std::cout << "updated!" << std::endl;
-          pathWay->setNextTile(tile2);
-        }
-        else
-        {
-          // copy the current branch
-          // std::cout << "cloned!" << std::endl;
-          PathwayPtr pathWay2( new Pathway( *pathWay.object() ) );
-          pathWay2->drop();
-          pathWay2->setNextTile(tile2);
-          _d->activeBranches.insert( pathWay2 );
-        }
+        Branch fork = { branch.root, nextTiles[ k ], branch.length + 1 };
+        activeBranches.push_back( fork );
       }
-    }
 
-    // the current branch has been fully maximized
-    if( pathWay->length() )
-    {
-      oPathWayList.push_back( pathWay );
+      branch.head = nextTiles[ nextCount-1 ];
+      branch.length++;
     }
-    // pathWay.prettyPrint();
 
-    // this branch is no longer active
-    _d->activeBranches.erase( firstBranch );
+    oPathWayList.push_back( _d->way( branch.head, branch.root ) );
   }
 
   return oPathWayList;
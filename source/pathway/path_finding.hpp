@@ -54,9 +54,17 @@ public:
       init(constr);
   }
 
+  /** breadth first fill of distances and parent links, ways are built only for requested destinations */
   void propagate(const unsigned int maxDistance);
 
-  /** returns all paths starting at origin */
+  /** same fill, which stops as soon as one of targets is reached,
+   *  returns that target or null when no one is within max distance */
+  gfx::Tile* propagateTo(const gfx::TilesArray& targets, const unsigned int maxDistance);
+
+  /** way to the closest of tiles reached by last propagation, invalid if none is reached */
+  Pathway wayTo(const gfx::TilesArray& tiles) const;
+
+  /** returns all paths starting at origin, drops the result of previous propagate() */
   PathwayList getWays(const unsigned int maxDistance);
   DirectPRoutes getRoutes(const object::Type buildingType);
 
@@ -18,6 +18,7 @@
 #include "astarpathfinding.hpp"
 #include "gfx/tilemap.hpp"
 #include "city/statistic.hpp"
+#include "city/roadgraph.hpp"
 #include "core/logger.hpp"
 
 using namespace gfx;
@@ -135,14 +136,52 @@ DirectRoute PathwayHelper::shortWay(const TilePos& startPos, ConstructionList bu
 
 DirectRoute PathwayHelper::shortWay(PlayerCityPtr city, const TilePos& startPos, object::Type buildingType, WayType type)
 {
-  ConstructionList constructions = city->statistic().objects.find<Construction>( buildingType );
-  return shortWay( startPos, constructions, type );
+  city::RoadGraph& roads = city->roadGraph();
+  if( type == roadOnly || type == roadFirst )
+  {
+    // road graph already knows closest building, so only one search needed
+    ConstructionPtr nearest = roads.nearest( startPos, buildingType );
+    if( nearest.isValid() )
+    {
+      Pathway way = create( startPos, nearest, type );
+      if( way.isValid() )
+        return DirectRoute( nearest, way );
+    }
+  }
+
+  return shortWay( startPos, roads.destinations( buildingType ), type );
 }
 
 DirectRoute PathwayHelper::shortWay(PlayerCityPtr city, const Locations& area, object::Type buildingType, WayType type)
 {
+  city::RoadGraph& roads = city->roadGraph();
+  if( type == roadOnly || type == roadFirst )
+  {
+    TilePos bestStart = TilePos::invalid();
+    ConstructionPtr nearest;
+    int bestDistance = city::RoadGraph::unreachable;
+    for( auto& pos : area )
+    {
+      int distance;
+      ConstructionPtr construction = roads.nearest( pos, buildingType, &distance );
+      if( construction.isValid() && (nearest.isNull() || distance < bestDistance) )
+      {
+        nearest = construction;
+        bestDistance = distance;
+        bestStart = pos;
+      }
+    }
+
+    if( nearest.isValid() )
+    {
+      Pathway way = create( bestStart, nearest, type );
+      if( way.isValid() )
+        return DirectRoute( nearest, way );
+    }
+  }
+
   Locations locations( area );
-  ConstructionList constructions = city->statistic().objects.find<Construction>( buildingType );
+  const ConstructionList& constructions = roads.destinations( buildingType );
 
   DirectRoute shortestWay;
   while( !locations.empty() )
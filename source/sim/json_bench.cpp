@@ -0,0 +1,142 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "json_bench.hpp"
+#include "core/json.hpp"
+#include "core/format.hpp"
+#include "core/bytearray.hpp"
+#include "vfs/directory.hpp"
+#include "vfs/entries.hpp"
+#include "vfs/file.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+namespace sim
+{
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+struct Document
+{
+  std::string name;
+  ByteArray data;
+};
+
+inline double elapsed( const Clock::time_point& from )
+{
+  return std::chrono::duration<double>( Clock::now() - from ).count();
+}
+
+// every file which starts like json object, binary maps and sounds are skipped
+bool looksLikeJson( const ByteArray& data )
+{
+  for( unsigned int i=0; i < data.size(); i++ )
+  {
+    char c = data.data()[ i ];
+    if( c == ' ' || c == '\t' || c == '\n' || c == '\r' )
+      continue;
+
+    return c == '{';
+  }
+
+  return false;
+}
+
+void collect( const vfs::Directory& dir, std::vector<Document>& docs )
+{
+  vfs::Entries entries = dir.entries();
+  for( const auto& item : entries.items() )
+  {
+    std::string name = item.name.toString();
+    if( name == "." || name == ".." )
+      continue;
+
+    if( item.isDirectory )
+    {
+      collect( vfs::Directory( item.fullpath ), docs );
+      continue;
+    }
+
+    Document doc;
+    doc.name = item.fullpath.toString();
+    doc.data = vfs::NFile::open( item.fullpath ).readAll();
+    if( looksLikeJson( doc.data ) )
+      docs.push_back( doc );
+  }
+}
+
+}
+
+int runJsonBench( const std::string& directory, int rounds )
+{
+  std::vector<Document> docs;
+  collect( vfs::Directory( directory ), docs );
+
+  size_t bytes = 0;
+  for( const auto& doc : docs )
+    bytes += doc.data.size();
+
+  std::printf( "%s", fmt::format( "json files:  {} ({:.2f} MB) in {}\n", docs.size(), bytes / 1048576.0, directory ).c_str() );
+
+  int failed = 0;
+  double parseTime = 0;
+  double serializeTime = 0;
+  size_t outBytes = 0;
+  for( int round=0; round < rounds; round++ )
+  {
+    for( const auto& doc : docs )
+    {
+      Clock::time_point start = Clock::now();
+      bool ok;
+      Variant tree = Json::parse( doc.data.data(), doc.data.size(), ok );
+      parseTime += elapsed( start );
+
+      start = Clock::now();
+      std::string text = Json::serialize( tree, " " );
+      serializeTime += elapsed( start );
+      outBytes += text.size();
+
+      if( round > 0 )
+        continue;
+
+      // floats come back as strings, so compare text of second pass
+      bool again;
+      std::string second = Json::serialize( Json::parse( text, again ), " " );
+      if( !ok || !again || second != text )
+      {
+        std::printf( "%s", fmt::format( "  failed: {}{}\n", doc.name, ok ? "" : " (parse error)" ).c_str() );
+        failed++;
+      }
+    }
+  }
+
+  double megabytes = bytes * (double)rounds / 1048576.0;
+  std::printf( "%s", fmt::format( "rounds:      {}\n"
+                                  "parse:       {:.3f} s ({:.1f} MB/s)\n"
+                                  "serialize:   {:.3f} s ({:.1f} MB/s out)\n"
+                                  "round trip:  {} failed\n",
+                                  rounds,
+                                  parseTime, parseTime > 0 ? megabytes / parseTime : 0.0,
+                                  serializeTime, serializeTime > 0 ? outBytes / 1048576.0 / serializeTime : 0.0,
+                                  failed ).c_str() );
+
+  return failed;
+}
+
+}//end namespace sim
@@ -0,0 +1,31 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __CAESARIA_SIM_JSON_BENCH_H_INCLUDED__
+#define __CAESARIA_SIM_JSON_BENCH_H_INCLUDED__
+
+#include <string>
+
+namespace sim
+{
+
+/** Parses and serializes every model/config file found in directory,
+ *  checks that tree survives round trip and prints throughput.
+ *  Returns count of files which failed. */
+int runJsonBench( const std::string& directory, int rounds );
+
+}//end namespace sim
+
+#endif //__CAESARIA_SIM_JSON_BENCH_H_INCLUDED__
@@ -0,0 +1,268 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+
+// Headless simulation runner: loads city without window, audio and input,
+// steps given count of days as fast as possible and prints timings.
+//
+// usage: caesaria-sim -load <file.sav|file.omap|file.map> [-days 365] [-profile trace.json]
+//        caesaria-sim -jsonbench <resources dir> [-rounds 10]
+//        caesaria-sim -pkbench <maps dir> [-rounds 10]
+
+#include "core/exception.hpp"
+#include "core/format.hpp"
+#include "core/logger.hpp"
+#include "core/stacktrace.hpp"
+#include "vfs/path.hpp"
+#include "vfs/directory.hpp"
+#include "game/settings.hpp"
+#include "game/game.hpp"
+#include "game/gamedate.hpp"
+#include "game/freeplay_finalizer.hpp"
+#include "events/dispatcher.hpp"
+#include "world/empire.hpp"
+#include "city/city.hpp"
+#include "city/states.hpp"
+#include "city/tick_profiler.hpp"
+#include "json_bench.hpp"
+#include "pkware_bench.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+#ifdef GAME_PLATFORM_UNIX
+#include <sys/resource.h>
+#endif
+
+#ifdef GAME_PLATFORM_WIN
+  #undef main
+#endif
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+struct Subsystem
+{
+  const char* name;
+  double seconds;
+};
+
+enum { sDate=0, sEmpire, sEvents, sCount };
+
+inline double elapsed( const Clock::time_point& from )
+{
+  return std::chrono::duration<double>( Clock::now() - from ).count();
+}
+
+// peak resident set size in kilobytes, 0 when platform can't tell
+long peakRss()
+{
+#ifdef GAME_PLATFORM_UNIX
+  rusage usage;
+  if( getrusage( RUSAGE_SELF, &usage ) != 0 )
+    return 0;
+#ifdef GAME_PLATFORM_MACOSX
+  return usage.ru_maxrss / 1024;
+#else
+  return usage.ru_maxrss;
+#endif
+#else
+  return 0;
+#endif
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+  crashhandler::install();
+
+  vfs::Directory workdir = vfs::Path( argv[0] ).directory();
+
+  game::Settings& options = game::Settings::instance();
+  Logger::registerWriter(Logger::consolelog, "");
+
+  options.setwdir(workdir.toString());
+  bool wdirChanged = options.checkwdir( argv, argc );
+  if (wdirChanged)
+    workdir = SETTINGS_STR(workDir);
+
+  options.resetIfNeed(argv, argc);
+  if (options.haveLastConfig())
+    options.loadLastConfig();
+
+  options.checkCmdOptions(argv, argc);
+  options.checkC3present();
+
+  if (!KILLSWITCH(verbose))
+  {
+    Logger::addFilter(LogWriter::info);
+    Logger::addFilter(LogWriter::debug);
+  }
+
+  options.changeSystemLang(SETTINGS_STR(language));
+
+  std::string benchDir = game::Settings::get( "jsonbench" ).toString();
+  if( !benchDir.empty() )
+  {
+    Variant roundsValue = game::Settings::get( "rounds" );
+    return sim::runJsonBench( benchDir, roundsValue.isNull() ? 10 : roundsValue.toInt() ) > 0 ? 1 : 0;
+  }
+
+  std::string pkBenchDir = game::Settings::get( "pkbench" ).toString();
+  if( !pkBenchDir.empty() )
+  {
+    Variant roundsValue = game::Settings::get( "rounds" );
+    return sim::runPkwareBench( pkBenchDir, roundsValue.isNull() ? 10 : roundsValue.toInt() ) > 0 ? 1 : 0;
+  }
+
+  std::string filename = game::Settings::get( "load" ).toString();
+  Variant daysValue = game::Settings::get( "days" );
+  int days = daysValue.isNull() ? 365 : daysValue.toInt();
+  std::string profileName = game::Settings::get( "profile" ).toString();
+
+  if( filename.empty() || days <= 0 )
+  {
+    std::printf( "usage: %s -load <file.sav|file.omap|file.map> [-days 365] [-profile trace.json]\n"
+                 "       %s -jsonbench <resources dir> [-rounds 10]\n"
+                 "       %s -pkbench <maps dir> [-rounds 10]\n", argv[0], argv[0], argv[0] );
+    return 1;
+  }
+
+  int result = 0;
+  try
+  {
+    Game game;
+    game.initialize( true );
+
+    // first exec creates splash state, second one loads
+    // resources and metadata without showing anything
+    game.exec();
+    game.exec();
+
+    Clock::time_point loadStart = Clock::now();
+    if( !game.load( filename ) )
+    {
+      std::printf( "can't load %s\n", filename.c_str() );
+      return 1;
+    }
+
+    vfs::Path path( filename );
+    if( path.isMyExtension( ".map", false ) || path.isMyExtension( ".omap", false ) )
+    {
+      // same preparation as lobby does for free play maps
+      game::freeplay::Finalizer finalizer( game.city() );
+      finalizer.addPopulationMilestones();
+      finalizer.initBuildOptions();
+      finalizer.addEvents();
+      finalizer.resetFavour();
+    }
+    double loadTime = elapsed( loadStart );
+
+    Subsystem subsystems[ sCount ] = { { "date", 0 }, { "empire", 0 }, { "events", 0 } };
+    double worstDay = 0;
+
+    game::Date& cdate = game::Date::instance();
+    world::EmpirePtr empire = game.empire();
+    events::Dispatcher& dispatcher = events::Dispatcher::instance();
+
+    unsigned int ticks = game::Date::days2ticks( days );
+    unsigned int dayTicks = game::Date::days2ticks( 1 );
+
+    if( !profileName.empty() )
+      city::TickProfiler::setEnabled( true );
+
+    Clock::time_point runStart = Clock::now();
+    Clock::time_point dayStart = runStart;
+    for( unsigned int time=1; time <= ticks; time++ )
+    {
+      Clock::time_point start = Clock::now();
+      cdate.timeStep( time );
+      Clock::time_point point = Clock::now();
+      subsystems[ sDate ].seconds += std::chrono::duration<double>( point - start ).count();
+
+      start = point;
+      empire->timeStep( time );
+      point = Clock::now();
+      subsystems[ sEmpire ].seconds += std::chrono::duration<double>( point - start ).count();
+
+      start = point;
+      dispatcher.update( game, time );
+      point = Clock::now();
+      subsystems[ sEvents ].seconds += std::chrono::duration<double>( point - start ).count();
+
+      if( time % dayTicks == 0 )
+      {
+        worstDay = std::max( worstDay, std::chrono::duration<double>( point - dayStart ).count() );
+        dayStart = point;
+      }
+    }
+    double runTime = elapsed( runStart );
+
+    PlayerCityPtr city = game.city();
+    std::printf( "%s", fmt::format( "file:        {}\n"
+                                    "load:        {:.3f} s\n"
+                                    "days:        {} ({} ticks)\n"
+                                    "run:         {:.3f} s\n"
+                                    "ticks/sec:   {:.1f}\n"
+                                    "days/sec:    {:.2f}\n"
+                                    "worst day:   {:.3f} ms\n",
+                                    filename, loadTime, days, ticks, runTime,
+                                    runTime > 0 ? ticks / runTime : 0.0,
+                                    runTime > 0 ? days / runTime : 0.0,
+                                    worstDay * 1000 ).c_str() );
+
+    for( const auto& subsystem : subsystems )
+    {
+      std::printf( "%s", fmt::format( "  {:<10} {:.3f} s ({:.1f}%)\n", subsystem.name, subsystem.seconds,
+                                      runTime > 0 ? subsystem.seconds * 100 / runTime : 0.0 ).c_str() );
+    }
+
+    if( city::TickProfiler::enabled() )
+    {
+      for( int stage=0; stage < city::TickProfiler::stageCount; stage++ )
+      {
+        double seconds = city::TickProfiler::total( (city::TickProfiler::Stage)stage ) / 1e9;
+        std::printf( "%s", fmt::format( "    {:<8} {:.3f} s\n",
+                                        city::TickProfiler::name( city::TickProfiler::stage, stage ),
+                                        seconds ).c_str() );
+      }
+
+      city::TickProfiler::exportTrace( profileName );
+    }
+
+    const DateTime& date = game::Date::current();
+    std::printf( "%s", fmt::format( "date:        {}.{}.{}\n"
+                                    "population:  {}\n"
+                                    "overlays:    {}\n"
+                                    "walkers:     {}\n"
+                                    "peak rss:    {} KB\n",
+                                    date.year(), (int)date.month() + 1, (int)date.day(), city->states().population,
+                                    city->overlays().size(), city->walkers().size(), peakRss() ).c_str() );
+
+    game.destroy();
+  }
+  catch( Exception& e )
+  {
+    Logger::fatal("Critical error: " + e.getDescription());
+    crashhandler::printstack();
+    result = 1;
+  }
+
+  crashhandler::remove();
+
+  return result;
+}
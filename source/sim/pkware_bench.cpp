@@ -0,0 +1,296 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "pkware_bench.hpp"
+#include "game/pkwareinputstream.hpp"
+#include "core/format.hpp"
+#include "core/bytearray.hpp"
+#include "vfs/directory.hpp"
+#include "vfs/entries.hpp"
+#include "vfs/file.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+namespace sim
+{
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+enum { eofLength=519, blockSize=4096 };
+
+struct Chunk
+{
+  std::string name;
+  const char* data;
+  int length;
+  std::string plain;
+};
+
+inline double elapsed( const Clock::time_point& from )
+{
+  return std::chrono::duration<double>( Clock::now() - from ).count();
+}
+
+// straight port of the original bit by bit decoder, used as reference
+class Reference
+{
+public:
+  Reference( const char* data, int length )
+    : _data( (const unsigned char*)data ), _length( length ), _bit( 16 )
+  {
+    _dictBits = _data[ 1 ];
+    _dict.resize( 64 << _dictBits );
+    _first = -1;
+  }
+
+  bool decode( std::string& out )
+  {
+    while( _bit <= _length * 8 )
+    {
+      if( !bit() )
+      {
+        int b = bits( 8 );
+        put( b );
+        out.push_back( (char)b );
+        continue;
+      }
+
+      int length = copyLength();
+      if( length >= eofLength )
+        return true;
+
+      int lower = length == 2 ? 2 : _dictBits;
+      int offset = ( offsetHigh() << lower ) | bits( lower );
+      for( int i=0; i < length; i++ )
+      {
+        int size = _dict.size();
+        char b = _dict[ ( size + _first - offset ) % size ];
+        put( b );
+        out.push_back( b );
+      }
+    }
+
+    return false;
+  }
+
+private:
+  int bit()
+  {
+    int pos = _bit++;
+    return pos < _length * 8 ? ( _data[ pos / 8 ] >> ( pos % 8 ) ) & 1 : 0;
+  }
+
+  int bits( int count )
+  {
+    int result = 0;
+    for( int i=0; i < count; i++ )
+      result |= bit() << i;
+    return result;
+  }
+
+  int reversed( int count )
+  {
+    int result = 0;
+    for( int i=0; i < count; i++ )
+      result = ( result << 1 ) | bit();
+    return result;
+  }
+
+  void put( int b )
+  {
+    _first = ( _first + 1 ) % _dict.size();
+    _dict[ _first ] = (char)b;
+  }
+
+  int copyLength()
+  {
+    switch( bits( 2 ) )
+    {
+    case 3: return 3;
+    case 1: return 4 - 2 * bit();
+    case 2: return bit() ? 5 : 7 - bit();
+    }
+
+    switch( bits( 2 ) )
+    {
+    case 3: return 8;
+    case 1: return bit() ? 9 : 10 + bit();
+    case 2: return bit() ? 12 + bits( 2 ) : 16 + bits( 3 );
+    }
+
+    switch( bits( 2 ) )
+    {
+    case 3: return 24 + bits( 4 );
+    case 1: return 40 + bits( 5 );
+    case 2: return 72 + bits( 6 );
+    }
+
+    return bit() ? 136 + bits( 7 ) : 264 + bits( 8 );
+  }
+
+  int offsetHigh()
+  {
+    switch( bits( 2 ) )
+    {
+    case 3: return 0;
+    case 1:
+      switch( bits( 2 ) )
+      {
+      case 3: return 0x1;
+      case 1: return 0x2;
+      case 2: return 0x4 - bit();
+      }
+      return 0x6 - bit();
+    case 2:
+    {
+      int high = reversed( 4 );
+      return high ? 0x16 - high : 0x17 - bit();
+    }
+    }
+
+    switch( bits( 2 ) )
+    {
+    case 3: return 0x1f - reversed( 3 );
+    case 1: return 0x27 - reversed( 3 );
+    case 2: return 0x2f - reversed( 3 );
+    }
+    return 0x3f - reversed( 4 );
+  }
+
+  const unsigned char* _data;
+  int _length;
+  int _bit;
+  int _dictBits;
+  ByteArray _dict;
+  int _first;
+};
+
+// chunks in .sav are written as length followed by PKWare header,
+// candidates which reference decoder can't finish are not chunks
+void collect( const std::string& name, const ByteArray& file, std::vector<Chunk>& chunks )
+{
+  const unsigned char* data = (const unsigned char*)file.data();
+  for( unsigned int i=4; i + 2 < file.size(); i++ )
+  {
+    if( data[ i ] != 0 || data[ i+1 ] < 4 || data[ i+1 ] > 6 )
+      continue;
+
+    unsigned int length = data[ i-4 ] | ( data[ i-3 ] << 8 ) | ( data[ i-2 ] << 16 ) | ( data[ i-1 ] << 24 );
+    if( length <= 2 || length > file.size() - i )
+      continue;
+
+    Chunk chunk;
+    chunk.name = name;
+    chunk.data = file.data() + i;
+    chunk.length = length;
+    if( Reference( chunk.data, chunk.length ).decode( chunk.plain ) )
+    {
+      chunks.push_back( chunk );
+      i += length - 1;
+    }
+  }
+}
+
+}
+
+int runPkwareBench( const std::string& directory, int rounds )
+{
+  std::vector<std::string> names;
+  std::vector<ByteArray> files;
+  std::vector<Chunk> chunks;
+
+  vfs::Entries entries = vfs::Directory( directory ).entries();
+  for( const auto& item : entries.items() )
+  {
+    if( item.isDirectory || item.fullpath.extension() != ".sav" )
+      continue;
+
+    names.push_back( item.fullpath.toString() );
+    files.push_back( vfs::NFile::open( item.fullpath ).readAll() );
+  }
+
+  // chunks point into files, so they're collected when vector doesn't grow anymore
+  for( unsigned int k=0; k < files.size(); k++ )
+    collect( names[ k ], files[ k ], chunks );
+
+  size_t packed = 0;
+  size_t bytes = 0;
+  for( const auto& chunk : chunks )
+  {
+    packed += chunk.length;
+    bytes += chunk.plain.size();
+  }
+
+  std::printf( "%s", fmt::format( "chunks:      {} from {} saves ({:.2f} MB packed, {:.2f} MB plain)\n",
+                                  chunks.size(), files.size(), packed / 1048576.0, bytes / 1048576.0 ).c_str() );
+
+  int failed = 0;
+  double decodeTime = 0;
+  double referenceTime = 0;
+  unsigned char block[ blockSize ];
+  for( int round=0; round < rounds; round++ )
+  {
+    for( const auto& chunk : chunks )
+    {
+      std::string out;
+      Clock::time_point start = Clock::now();
+      try
+      {
+        PKWareInputStream pk( chunk.data, chunk.length );
+        int count;
+        do
+        {
+          count = pk.read( block, blockSize );
+          if( round == 0 )
+            out.append( (const char*)block, count );
+        }
+        while( count == blockSize );
+      }
+      catch( PKException& e )
+      {
+        out = "!" + e.msg;
+      }
+      decodeTime += elapsed( start );
+
+      start = Clock::now();
+      std::string plain;
+      Reference( chunk.data, chunk.length ).decode( plain );
+      referenceTime += elapsed( start );
+
+      if( round == 0 && out != chunk.plain )
+      {
+        std::printf( "%s", fmt::format( "  failed: chunk of {} bytes in {}\n", chunk.length, chunk.name ).c_str() );
+        failed++;
+      }
+    }
+  }
+
+  double megabytes = bytes * (double)rounds / 1048576.0;
+  std::printf( "%s", fmt::format( "rounds:      {}\n"
+                                  "decode:      {:.3f} s ({:.1f} MB/s)\n"
+                                  "reference:   {:.3f} s ({:.1f} MB/s)\n"
+                                  "round trip:  {} failed\n",
+                                  rounds,
+                                  decodeTime, decodeTime > 0 ? megabytes / decodeTime : 0.0,
+                                  referenceTime, referenceTime > 0 ? megabytes / referenceTime : 0.0,
+                                  failed ).c_str() );
+
+  return failed;
+}
+
+}//end namespace sim
@@ -0,0 +1,31 @@
+// This file is part of CaesarIA.
+//
+// CaesarIA is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// CaesarIA is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with CaesarIA.  If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef __CAESARIA_SIM_PKWARE_BENCH_H_INCLUDED__
+#define __CAESARIA_SIM_PKWARE_BENCH_H_INCLUDED__
+
+#include <string>
+
+namespace sim
+{
+
+/** Decodes every compressed chunk of .sav files found in directory,
+ *  checks output against bit by bit reference decoder and prints throughput.
+ *  Returns count of chunks which failed. */
+int runPkwareBench( const std::string& directory, int rounds );
+
+}//end namespace sim
+
+#endif //__CAESARIA_SIM_PKWARE_BENCH_H_INCLUDED__
@@ -28,10 +28,14 @@
 #include "vfs/directory.hpp"
 #include "vfs/memfile.hpp"
 #include "core/debug_timer.hpp"
+#include "core/math.hpp"
 
 #include <sstream>
 #include <iomanip>
 #include <iostream>
+#include <algorithm>
+#include <thread>
+#include <vector>
 
 using namespace gfx;
 
@@ -56,6 +60,212 @@ enum {
 namespace {
 static const std::string readerTypename=TEXT(Sg2ArchiveReader);
 static const char* arch555ext = "555";
+
+// decoded image in A8R8G8B8, same layout as picture surface
+struct Bitmap
+{
+  unsigned int* pixels;
+  int width;
+  int height;
+};
+
+// 555 color to A8R8G8B8, 0xf81f is transparent key
+inline unsigned int rgb555( unsigned int color )
+{
+  // 5 bits of channel go to high bits, low bits repeat top of channel
+  unsigned int red = ((color & 0x7c00) >> 7) | ((color & 0x7000) >> 12);
+  unsigned int green = ((color & 0x3e0) >> 2) | ((color & 0x300) >> 8);
+  unsigned int blue = ((color & 0x1f) << 3) | ((color & 0x1c) >> 2);
+  unsigned int argb = 0xff000000 | (red << 16) | (green << 8) | blue;
+
+  return color == 0xf81f ? 0 : argb;
+}
+
+// no branches and no aliasing between src and dst, so compiler
+// vectorizes this loop with sse2/neon
+inline void decodeRun( const unsigned char* src, unsigned int* dst, int count )
+{
+  for( int i=0; i < count; i++ )
+    dst[ i ] = rgb555( src[ i*2 ] | (src[ i*2+1 ] << 8) );
+}
+
+void writeIsometricTile( Bitmap& img, const unsigned char* buffer,
+                         int offset_x, int offset_y,
+                         int tile_width, int tile_height )
+{
+  int half_height = tile_height / 2;
+
+  for( int y = 0; y < tile_height; y++ )
+  {
+    int start = y < half_height
+                  ? tile_height - 2 * (y + 1)
+                  : 2 * y - tile_height;
+    int count = tile_width - 2 * start;
+
+    decodeRun( buffer, img.pixels + (offset_y + y) * img.width + offset_x + start, count );
+    buffer += count * 2;
+  }
+}
+
+void writeIsometricBase( Bitmap& img, const SgImageRecord& rec, const unsigned char* buffer )
+{
+  int i = 0, x, y;
+  int width, height, height_offset;
+  int size = rec.flags[3];
+  int x_offset, y_offset;
+  int tile_bytes, tile_height, tile_width;
+
+  width = img.width;
+  height = (width + 2) / 2; /* 58 -> 30, 118 -> 60, etc */
+  height_offset = img.height - height;
+  y_offset = height_offset;
+
+  if (size == 0)
+  {
+    /* Derive the tile size from the height (more regular than width) */
+    /* Note that this causes a problem with 4x4 regular vs 3x3 large: */
+    /* 4 * 30 = 120; 3 * 40 = 120 -- give precedence to regular */
+    if (height % ISOMETRIC_TILE_HEIGHT == 0)
+    {
+      size = height / ISOMETRIC_TILE_HEIGHT;
+    }
+    else if (height % ISOMETRIC_LARGE_TILE_HEIGHT == 0)
+    {
+      size = height / ISOMETRIC_LARGE_TILE_HEIGHT;
+    }
+  }
+
+  /* Determine whether we should use the regular or large (emperor) tiles */
+  if (ISOMETRIC_TILE_HEIGHT * size == height)
+  {
+    /* Regular tile */
+    tile_bytes  = ISOMETRIC_TILE_BYTES;
+    tile_height = ISOMETRIC_TILE_HEIGHT;
+    tile_width  = ISOMETRIC_TILE_WIDTH;
+  }
+  else if (ISOMETRIC_LARGE_TILE_HEIGHT * size == height)
+  {
+    /* Large (emperor) tile */
+    tile_bytes  = ISOMETRIC_LARGE_TILE_BYTES;
+    tile_height = ISOMETRIC_LARGE_TILE_HEIGHT;
+    tile_width  = ISOMETRIC_LARGE_TILE_WIDTH;
+  }
+  else
+  {
+    Logger::warning( "Unknown tile size: {} (height {}, width {}, size {}})",
+         2 * height / size, height, width, size );
+    return;
+  }
+
+  /* Check if buffer length is enough: (width + 2) * height / 2 * 2bpp */
+  if( (width + 2) * height != (int)rec.uncompressed_length)
+  {
+    Logger::warning(
+      "Data length doesn't match footprint size: {} vs {} ({}) {}",
+      (width + 2) * height,
+      rec.uncompressed_length,
+      rec.length,
+      rec.invert_offset );
+    return;
+  }
+
+  i = 0;
+  for (y = 0; y < (size + (size - 1)); y++)
+  {
+    x_offset = (y < size ? (size - y - 1) : (y - size + 1)) * tile_height;
+    for (x = 0; x < (y < size ? y + 1 : 2 * size - y - 1); x++, i++)
+    {
+      writeIsometricTile( img, &buffer[i * tile_bytes],
+                          x_offset, y_offset, tile_width, tile_height);
+      x_offset += tile_width + 2;
+    }
+    y_offset += tile_height / 2;
+  }
+}
+
+void writeTransparentImage( Bitmap& img, const unsigned char* buffer, int length )
+{
+  int i = 0;
+  int x = 0, y = 0;
+  int width = img.width;
+
+  while( i < length && y < img.height )
+  {
+    unsigned char c = buffer[i++];
+    if (c == 255)
+    {
+      /* The next byte is the number of pixels to skip */
+      x += buffer[i++];
+      while (x >= width)
+      {
+        y++; x -= width;
+      }
+    }
+    else
+    {
+      /* `c' is the number of image data bytes, run may wrap to next rows */
+      int count = c;
+      while( count > 0 && y < img.height )
+      {
+        int part = std::min( count, width - x );
+        decodeRun( buffer + i, img.pixels + y * width + x, part );
+        i += part * 2;
+        count -= part;
+        x += part;
+        if( x >= width )
+        {
+          y++; x = 0;
+        }
+      }
+      i += count * 2;
+    }
+  }
+}
+
+void writePlainImage( Bitmap& img, const SgImageRecord& rec, const unsigned char* buffer )
+{
+  // Check whether the image data is OK
+  if (rec.height * rec.width * 2 != (int)rec.length)
+  {
+    Logger::warning( "Image data length doesn't match image size" );
+    return;
+  }
+
+  // rows lie one after another, same as in bitmap
+  decodeRun( buffer, img.pixels, img.width * img.height );
+}
+
+// buffer holds rec.length bytes of image
+void decodeImage( Bitmap& img, const SgImageRecord& rec, const unsigned char* buffer )
+{
+  switch( rec.type )
+  {
+    case 0:
+    case 1:
+    case 10:
+    case 12:
+    case 13:
+      writePlainImage( img, rec, buffer );
+    break;
+
+    case 30:
+      writeIsometricBase( img, rec, buffer );
+      writeTransparentImage( img, buffer + rec.uncompressed_length,
+                             rec.length - rec.uncompressed_length );
+    break;
+
+    case 256:
+    case 257:
+    case 276:
+      writeTransparentImage( img, buffer, rec.length );
+    break;
+
+    default:
+      Logger::warning( "Unknown image type: {}", rec.type );
+    break;
+  }
+}
+
 }
 
 Sg2ArchiveLoader::Sg2ArchiveLoader(vfs::FileSystem*)
@@ -180,6 +390,7 @@ Sg2ArchiveReader::Sg2ArchiveReader(NFile file) : _file( file )
       _fileInfo[name];
       _fileInfo[name].fn = p555.toString();
       _fileInfo[name].sr = sir;
+      _groups[ bmp_name ] << name;
 
       addItem( name, sir.offset, sir.length, false);
     } // image loop
@@ -203,12 +414,6 @@ NFile Sg2ArchiveReader::createAndOpenFile(unsigned int index)
   return NFile();
 }
 
-void Sg2ArchiveReader::_loadSpriteImage( Picture& img, const SgFileEntry& rec)
-{
-  ByteArray buffer = _readData( rec );
-  _writeTransparentImage( img, (unsigned char*)buffer.data(), rec.sr.length);
-}
-
 std::string Sg2ArchiveReader::_find555File( const SgFileEntry& rec )
 {
   // Fetch basename of the file
@@ -253,13 +458,24 @@ std::string Sg2ArchiveReader::_findFilenameCaseInsensitive( const std::string& d
   return std::string();
 }
 
-ByteArray Sg2ArchiveReader::_readData(const SgFileEntry& rec )
+NFile& Sg2ArchiveReader::_open555( const std::string& filename )
 {
-  std::string filename = rec.fn;
-  unsigned int start = rec.sr.offset - rec.sr.flags[0];
-  unsigned int data_length = rec.sr.length;
+  Files555::iterator it = _555files.find( filename );
+  if( it != _555files.end() )
+    return it->second;
+
+  // handle stays open while archive is mounted
+  FSEntityPtr ptr( new FileNative( filename, Entity::fmRead ) );
+  ptr->drop();
+
+  NFile& file = _555files[ filename ];
+  file = NFile( ptr );
+  return file;
+}
 
-  FileNative z5file( filename, Entity::fmRead );
+ByteArray Sg2ArchiveReader::_readData( const std::string& filename, unsigned int start, unsigned int length )
+{
+  NFile& z5file = _open555( filename );
   if (!z5file.isOpen() )
   {
     Logger::warning( "Unable to open 555 file {}", filename );
@@ -267,15 +483,15 @@ ByteArray Sg2ArchiveReader::_readData(const SgFileEntry& rec )
   }
 
   z5file.seek( start );
-  if( data_length <= 0 )
+  if( length <= 0 )
   {
-    Logger::warning( "Data length: {}", data_length); // not an error per se
+    Logger::warning( "Data length: {}", length); // not an error per se
   }
 
-  ByteArray data = z5file.read( data_length );
+  ByteArray data = z5file.read( length );
 
   unsigned int real_read = data.size();
-  if( real_read + 4 == data_length && z5file.isEof() )
+  if( real_read + 4 == length && z5file.isEof() )
   {
     // Exception for some C3 graphics: last image is 'missing' 4 bytes
     data.resize( real_read + 4 );
@@ -286,225 +502,127 @@ ByteArray Sg2ArchiveReader::_readData(const SgFileEntry& rec )
   return data;
 }
 
-void Sg2ArchiveReader::_loadIsometricImage( Picture& pic, const SgFileEntry& rec )
+ByteArray Sg2ArchiveReader::_readData(const SgFileEntry& rec )
 {
-  ByteArray buffer = _readData( rec );
-  _writeIsometricBase( pic, rec.sr, (unsigned char*)buffer.data() );
-  _writeTransparentImage( pic, (unsigned char*)(&buffer[0] + rec.sr.uncompressed_length),
-                          rec.sr.length - rec.sr.uncompressed_length);
+  return _readData( rec.fn, rec.sr.offset - rec.sr.flags[0], rec.sr.length );
 }
 
-void Sg2ArchiveReader::_writeIsometricBase( Picture& img, const SgImageRecord& rec, const unsigned char* buffer )
+StringArray Sg2ArchiveReader::groups() const
 {
-  int i = 0, x, y;
-  int width, height, height_offset;
-  int size = rec.flags[3];
-  int x_offset, y_offset;
-  int tile_bytes, tile_height, tile_width;
-
-  width = img.width();
-  height = (width + 2) / 2; /* 58 -> 30, 118 -> 60, etc */
-  height_offset = img.height() - height;
-  y_offset = height_offset;
+  StringArray ret;
+  for( auto& group : _groups )
+    ret << group.first;
 
-  if (size == 0)
-  {
-    /* Derive the tile size from the height (more regular than width) */
-    /* Note that this causes a problem with 4x4 regular vs 3x3 large: */
-    /* 4 * 30 = 120; 3 * 40 = 120 -- give precedence to regular */
-    if (height % ISOMETRIC_TILE_HEIGHT == 0)
-    {
-      size = height / ISOMETRIC_TILE_HEIGHT;
-    }
-    else if (height % ISOMETRIC_LARGE_TILE_HEIGHT == 0)
-    {
-      size = height / ISOMETRIC_LARGE_TILE_HEIGHT;
-    }
-  }
-
-  /* Determine whether we should use the regular or large (emperor) tiles */
-  if (ISOMETRIC_TILE_HEIGHT * size == height)
-  {
-    /* Regular tile */
-    tile_bytes  = ISOMETRIC_TILE_BYTES;
-    tile_height = ISOMETRIC_TILE_HEIGHT;
-    tile_width  = ISOMETRIC_TILE_WIDTH;
-  }
-  else if (ISOMETRIC_LARGE_TILE_HEIGHT * size == height)
-  {
-    /* Large (emperor) tile */
-    tile_bytes  = ISOMETRIC_LARGE_TILE_BYTES;
-    tile_height = ISOMETRIC_LARGE_TILE_HEIGHT;
-    tile_width  = ISOMETRIC_LARGE_TILE_WIDTH;
-  }
-  else
-  {
-    Logger::warning( "Unknown tile size: {} (height {}, width {}, size {}})",
-         2 * height / size, height, width, size );
-    return;
-  }
+  return ret;
+}
 
-  /* Check if buffer length is enough: (width + 2) * height / 2 * 2bpp */
-  if( (width + 2) * height != (int)rec.uncompressed_length)
+gfx::Pictures Sg2ArchiveReader::loadGroup( const std::string& group, int workers )
+{
+  gfx::Pictures ret;
+  decodeGroup( group, workers, [&ret]( const std::string& name, const Size& size, const unsigned int* pixels )
   {
-    Logger::warning(
-      "Data length doesn't match footprint size: {} vs {} ({}) {}",
-      (width + 2) * height,
-      rec.uncompressed_length,
-      rec.length,
-      rec.invert_offset );
-    return;
-  }
+    gfx::Picture pic( size, (unsigned char*)pixels, false );
+    pic.setName( name );
+    ret << pic;
+  });
 
-  i = 0;
-  for (y = 0; y < (size + (size - 1)); y++)
-  {
-    x_offset = (y < size ? (size - y - 1) : (y - size + 1)) * tile_height;
-    for (x = 0; x < (y < size ? y + 1 : 2 * size - y - 1); x++, i++)
-    {
-      _writeIsometricTile( img, &buffer[i * tile_bytes],
-               x_offset, y_offset, tile_width, tile_height);
-      x_offset += tile_width + 2;
-    }
-    y_offset += tile_height / 2;
-  }
+  return ret;
 }
 
-void Sg2ArchiveReader::_writeIsometricTile( Picture& img, const unsigned char* buffer,
-                                            int offset_x, int offset_y,
-                                            int tile_width, int tile_height )
+void Sg2ArchiveReader::decodeGroup( const std::string& group, int workers, ImageCallback callback )
 {
-  int half_height = tile_height / 2;
-  int x, y, i = 0;
-
-  unsigned int* pixels = img.lock();
-
-  for (y = 0; y < half_height; y++)
+  struct Task
   {
-    int start = tile_height - 2 * (y + 1);
-    int end = tile_width - start;
-    for (x = start; x < end; x++, i += 2)
-    {
-      unsigned int* bufp32;
-      bufp32 = pixels + (offset_y + y) * img.width() + offset_x + x;
-      *bufp32 = _555toRGBA( (buffer[i+1] << 8) | buffer[i] );
-    }
-  }
+    std::string name;
+    const SgImageRecord* sr;
+    const unsigned char* data;
+    std::vector<unsigned int> pixels;
+  };
 
-  for (y = half_height; y < tile_height; y++)
+  struct Span
   {
-    int start = 2 * y - tile_height;
-    int end = tile_width - start;
-    for (x = start; x < end; x++, i += 2)
-    {
-      unsigned int* bufp32;
-      bufp32 = pixels + (offset_y + y) * img.width() + offset_x + x;
-      *bufp32 = _555toRGBA( (buffer[i+1] << 8) | buffer[i] );
-    }
-  }
+    unsigned int start;
+    unsigned int end;
+    ByteArray data;
+  };
 
-  img.unlock();
-}
-
-void Sg2ArchiveReader::_writeTransparentImage( Picture& img, const unsigned char* buffer, int length)
-{
-  int i = 0;
-  int x = 0, y = 0, j;
-  int width = img.width();
+  Groups::iterator git = _groups.find( group );
+  if( git == _groups.end() )
+    return;
 
-  unsigned int* pixels = img.lock();
-  while (i < length)
+  // images of group lie in 555 file one after another, read whole range once
+  std::map<std::string, Span> spans;
+  std::vector<const SgFileEntry*> entries;
+  for( auto& name : git->second )
   {
-    unsigned char c = buffer[i++];
-    if (c == 255)
+    const SgFileEntry& rec = _fileInfo[ name ];
+    unsigned int start = rec.sr.offset - rec.sr.flags[0];
+    unsigned int end = start + rec.sr.length;
+
+    std::map<std::string, Span>::iterator sit = spans.find( rec.fn );
+    if( sit == spans.end() )
     {
-      /* The next byte is the number of pixels to skip */
-      x += buffer[i++];
-      while (x >= width)
-      {
-        y++; x -= width;
-      }
+      Span span = { start, end, ByteArray() };
+      spans[ rec.fn ] = span;
     }
     else
     {
-      /* `c' is the number of image data bytes */
-      for (j = 0; j < c; j++, i += 2)
-      {
-        unsigned int* bufp32;
-        bufp32 = pixels + y * img.width() + x;
-        *bufp32 = _555toRGBA( buffer[i] | (buffer[i+1] << 8) );
-
-        x++;
-        if (x >= width)
-        {
-          y++; x = 0;
-        }
-      }
+      sit->second.start = std::min( sit->second.start, start );
+      sit->second.end = std::max( sit->second.end, end );
     }
-  }
-  img.unlock();
-}
-
-void Sg2ArchiveReader::_loadPlainImage( Picture& pic, const SgFileEntry& rec)
-{
-  // Check whether the image data is OK
-  if (rec.sr.height * rec.sr.width * 2 != (int)rec.sr.length)
-  {
-    Logger::warning( "Image data length doesn't match image size" );
-    return;
-  }
-
-  unsigned int need_length = rec.sr.length;
-  ByteArray data = _readData( rec );
-  if( data.size() != need_length )
-  {
-    Logger::warning( "Unable to read {} bytes from file (read {} bytes)",
-                     data.size(), need_length );
-    return;
+    entries.push_back( &rec );
   }
 
-  int i = 0;
-  unsigned int* pixels = pic.lock();
+  for( auto& span : spans )
+    span.second.data = _readData( span.first, span.second.start, span.second.end - span.second.start );
 
-  unsigned char* rdata = (unsigned char*)data.data();
-  for (int y = 0; y < (int)rec.sr.height; y++)
+  std::vector<Task> tasks;
+  tasks.reserve( entries.size() );
+  for( unsigned int k=0; k < entries.size(); k++ )
   {
-    for (int x = 0; x < (int)rec.sr.width; x++, i+= 2)
+    const SgFileEntry& rec = *entries[ k ];
+    const Span& span = spans[ rec.fn ];
+    unsigned int start = rec.sr.offset - rec.sr.flags[0] - span.start;
+    if( start + rec.sr.length > span.data.size() || rec.sr.width <= 0 || rec.sr.height <= 0 )
     {
-      unsigned int* bufp32;
-      bufp32 = pixels + y * pic.width() + x;
-      *bufp32 = _555toRGBA( rdata[i] | (rdata[i+1] << 8) );
+      Logger::warning( "Sg2ArchiveReader: can't read data for {}", git->second[ k ] );
+      continue;
     }
-  }
-
-  pic.unlock();
-}
 
-unsigned int Sg2ArchiveReader::_555toRGBA( unsigned short color)
-{
-  if(color == 0xf81f)
-  {
-    return 0;
+    Task task;
+    task.name = vfs::Path( git->second[ k ] ).removeExtension();
+    task.sr = &rec.sr;
+    task.data = (const unsigned char*)span.data.data() + start;
+    tasks.push_back( task );
   }
 
-  NColor rgb( 0xff000000 );
-
-  // Red: bits 11-15, should go to bits 17-24
-  unsigned int red = ((color & 0x7c00) << 9) | ((color & 0x7000) << 4);
-
-  // Green: bits 6-10, should go to bits 9-16
-  unsigned int green = ((color & 0x3e0) << 6) | ((color & 0x300));
+  // workers touch only own pixel buffers, callback is called from here
+  auto decode = [&tasks]( unsigned int first, unsigned int step )
+  {
+    for( unsigned int k=first; k < tasks.size(); k += step )
+    {
+      Task& task = tasks[ k ];
+      task.pixels.assign( task.sr->width * task.sr->height, 0 );
+      Bitmap img = { task.pixels.data(), task.sr->width, task.sr->height };
+      decodeImage( img, *task.sr, task.data );
+    }
+  };
 
-  // Blue: bits 1-5, should go to bits 1-8
-  unsigned int blue = ((color & 0x1f) << 3) | ((color & 0x1c) >> 2);
+  workers = math::clamp<int>( workers, 1, std::max<int>( tasks.size(), 1 ) );
+  std::vector<std::thread> threads;
+  for( int w=1; w < workers; w++ )
+    threads.push_back( std::thread( decode, w, workers ) );
 
-  rgb.setRed( (red >> 16) & 0xff );
-  rgb.setGreen( (green >> 8) & 0xff );
-  rgb.setBlue( blue & 0xff );
+  decode( 0, workers );
+  for( auto& thread : threads )
+    thread.join();
 
-  return rgb.abgr();
+  for( auto& task : tasks )
+    callback( task.name, Size( task.sr->width, task.sr->height ), task.pixels.data() );
 }
 
+const Path& Sg2ArchiveReader::path() const { return _file.path(); }
+
 NFile Sg2ArchiveReader::createAndOpenFile(const Path& filename)
 {
   FileInfo::iterator it = _fileInfo.find( filename.toString() );
@@ -516,29 +634,19 @@ NFile Sg2ArchiveReader::createAndOpenFile(const Path& filename)
     Picture result( Size( sir.width, sir.height ), 0, true );
     result.fill( ColorList::clear, Rect() ); // Transparent black
 
-    switch(sir.type)
+    ByteArray buffer = _readData( it->second );
+    if( buffer.size() >= sir.length )
     {
-      case 0:
-      case 1:
-      case 10:
-      case 12:
-      case 13:
-        _loadPlainImage( result, it->second );
-        break;
-
-      case 30:
-        _loadIsometricImage( result, it->second );
-      break;
-
-      case 256:
-      case 257:
-      case 276:
-        _loadSpriteImage( result, it->second );
-      break;
-
-      default:
-        Logger::warning("Unknown image type: {}", sir.type);
-      break;
+      Bitmap img = { result.lock(), result.width(), result.height() };
+      decodeImage( img, sir, (const unsigned char*)buffer.data() );
+
+      // png writer takes A8B8G8R8
+      for( int k=0; k < img.width * img.height; k++ )
+      {
+        unsigned int c = img.pixels[ k ];
+        img.pixels[ k ] = (c & 0xff00ff00) | ((c >> 16) & 0xff) | ((c & 0xff) << 16);
+      }
+      result.unlock();
     }
 
     ByteArray data = PictureConverter::save( result, "PNG" );
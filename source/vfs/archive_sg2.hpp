@@ -22,13 +22,11 @@
 #include "file.hpp"
 #include "archive.hpp"
 #include "entries.hpp"
+#include "core/stringarray.hpp"
+#include "gfx/picturesarray.hpp"
 
 #include <map>
-
-namespace gfx
-{
-  class Picture;
-}
+#include <functional>
 
 namespace vfs
 {
@@ -137,20 +135,34 @@ public:
 
   Archive::Type getType() const;
 
+  //! names of bitmap groups in archive, like "land1a"
+  StringArray groups() const;
+
+  //! decodes all images of group at once, 555 data is read with one call per file
+  //! and decoding is split between worker threads, pictures are named like in bank
+  gfx::Pictures loadGroup( const std::string& group, int workers=1 );
+
+  //! name (without extension), size and A8R8G8B8 pixels of decoded image
+  typedef std::function<void (const std::string&, const Size&, const unsigned int*)> ImageCallback;
+
+  //! same as loadGroup, but images are given to callback on calling thread
+  void decodeGroup( const std::string& group, int workers, ImageCallback callback );
+
+  //! path of sg2 file
+  const Path& path() const;
+
 private:
-  //std::map<std::string, std::ifstream> _555List;
   typedef std::map<std::string, SgFileEntry> FileInfo;
+  typedef std::map<std::string, StringArray> Groups;
+  typedef std::map<std::string, NFile> Files555;
   FileInfo _fileInfo;
+  Groups _groups;
+  Files555 _555files;
   NFile _file;
 
-  void _loadSpriteImage( gfx::Picture& img, const SgFileEntry& rec);
-  void _writeTransparentImage( gfx::Picture& img, const unsigned char* buffer, int length);
-  void _writeIsometricTile( gfx::Picture& img, const unsigned char* buffer, int offset_x, int offset_y, int tile_width, int tile_height);
-  void _writeIsometricBase( gfx::Picture& img, const SgImageRecord& rec, const unsigned char* buffer);
+  NFile& _open555( const std::string& filename );
+  ByteArray _readData( const std::string& filename, unsigned int start, unsigned int length );
   ByteArray _readData( const SgFileEntry& rec );
-  void _loadIsometricImage( gfx::Picture& pic, const SgFileEntry& rec);
-  void _loadPlainImage( gfx::Picture& pic, const SgFileEntry& rec);
-  unsigned int _555toRGBA( unsigned short color);
   std::string _findFilenameCaseInsensitive(const std::string& directory, std::string filename);
   std::string _find555File(const SgFileEntry& rec);
 }; // class Sg2ArchiveReader
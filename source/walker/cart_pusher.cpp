@@ -27,6 +27,7 @@
 #include "good/store.hpp"
 #include "pathway/path_finding.hpp"
 #include "city/city.hpp"
+#include "city/goods_broker.hpp"
 #include "core/variant_map.hpp"
 #include "core/variant_list.hpp"
 #include "game/gamedate.hpp"
@@ -66,9 +67,10 @@ public:
   long reservationID;
   bool cantUnloadGoods;
 
-  BuildingPtr getWalkerDestination_factory(Propagator& pathPropagator, Pathway& oPathWay);
-  BuildingPtr getWalkerDestination_warehouse(Propagator& pathPropagator, Pathway& oPathWay);
-  BuildingPtr getWalkerDestination_granary(Propagator& pathPropagator, Pathway& oPathWay);
+  BuildingPtr getWalkerDestination_factory(PlayerCityPtr city, Pathway& oPathWay);
+  BuildingPtr getWalkerDestination_warehouse(PlayerCityPtr city, Pathway& oPathWay);
+  BuildingPtr getWalkerDestination_granary(PlayerCityPtr city, Pathway& oPathWay);
+  BuildingPtr reserveSink(PlayerCityPtr city, object::Type buildingType, Pathway& oPathWay);
 };
 
 CartPusher::CartPusher(PlayerCityPtr city, CartCapacity cap)
@@ -228,10 +230,7 @@ void CartPusher::getPictures( gfx::Pictures& oPics)
 
 void CartPusher::_computeWalkerDestination()
 {
-   // get the list of buildings within reach
    Pathway pathWay;
-   Propagator pathPropagator( _city() );
-   pathPropagator.setAllDirections( false );
    _d->consumerBuilding = NULL;
 
    if( _d->producerBuilding.isNull() )
@@ -241,32 +240,29 @@ void CartPusher::_computeWalkerDestination()
      return;
    }
 
-   pathPropagator.init(ptr_cast<Construction>(_d->producerBuilding));
-   pathPropagator.propagate(_d->maxDistance);
-
    BuildingPtr destBuilding;
    //if city save goods, need find warehouse first
    if( _city()->tradeOptions().isStacking(_d->stock.type()) )
    {
-      destBuilding = _d->getWalkerDestination_warehouse( pathPropagator, pathWay );
+      destBuilding = _d->getWalkerDestination_warehouse( _city(), pathWay );
    }
 
    if(destBuilding == NULL)
    {
       // try send that good to a factory
-      destBuilding = _d->getWalkerDestination_factory(pathPropagator, pathWay);
+      destBuilding = _d->getWalkerDestination_factory( _city(), pathWay );
    }
 
    if(destBuilding == NULL)
    {
       // try send that good to a granary
-      destBuilding = _d->getWalkerDestination_granary(pathPropagator, pathWay);
+      destBuilding = _d->getWalkerDestination_granary( _city(), pathWay );
    }
 
    if(destBuilding == NULL)
    {
       // try send that good to a warehouse
-      destBuilding = _d->getWalkerDestination_warehouse( pathPropagator, pathWay );
+      destBuilding = _d->getWalkerDestination_warehouse( _city(), pathWay );
    }
 
    if(destBuilding != NULL)
@@ -294,63 +290,22 @@ void CartPusher::_computeWalkerDestination()
    }
 }
 
-template< class T >
-BuildingPtr reserveShortestPath( const object::Type buildingType,
-                                 good::Stock& stock, long& reservationID,
-                                 Propagator &pathPropagator, Pathway& oPathWay )
+BuildingPtr CartPusher::Impl::reserveSink(PlayerCityPtr city, object::Type buildingType, Pathway& oPathWay)
 {
-  BuildingPtr res;
-  DirectPRoutes pathWayList = pathPropagator.getRoutes(buildingType);
+  city::GoodsBroker::Offer offer = city->goodsBroker().findSink( stock.type(), stock.qty(), buildingType,
+                                                                 producerBuilding.as<Construction>(), maxDistance );
+  if( !offer.isValid() )
+    return BuildingPtr();
 
-  //remove factories with improrer storage
-  auto pathWayIt= pathWayList.begin();
-  while( pathWayIt != pathWayList.end() )
-  {
-    // for every factory within range
-    SmartPtr<T> building = pathWayIt->first.as<T>();
+  reservationID = offer.building->store().reserveStorage( stock, game::Date::current() );
+  if( reservationID == 0 )
+    return BuildingPtr();
 
-    if( stock.qty() > building->store().getMaxStore( stock.type() ) )
-    {
-      pathWayList.erase( pathWayIt++ );
-    }
-    else
-    {
-      ++pathWayIt;
-    }
-  }
-
-  //find shortest path
-  int maxLength = 999;
-  PathwayPtr shortestPath = 0;
-  for( auto& item : pathWayList )
-  {
-    if( (int)item.second->length() < maxLength )
-    {
-      shortestPath = item.second;
-      maxLength = item.second->length();
-      res = item.first.as<Building>();
-    }
-  }
-
-  if( res.isValid() )
-  {
-    SmartPtr<T> ptr = res.as<T>();
-    reservationID = ptr->store().reserveStorage( stock, game::Date::current() );
-    if (reservationID != 0)
-    {
-      oPathWay = *(shortestPath.object());
-    }
-    else
-    {
-      res = BuildingPtr();
-    }
-  }
-
-
-  return res;
+  oPathWay = offer.way;
+  return offer.building;
 }
 
-BuildingPtr CartPusher::Impl::getWalkerDestination_factory(Propagator &pathPropagator, Pathway& oPathWay)
+BuildingPtr CartPusher::Impl::getWalkerDestination_factory(PlayerCityPtr city, Pathway& oPathWay)
 {
   BuildingPtr res;
   object::ProductConsumer info( stock.type() );
@@ -362,21 +317,21 @@ BuildingPtr CartPusher::Impl::getWalkerDestination_factory(Propagator &pathPropa
      return BuildingPtr();
   }
 
-  res = reserveShortestPath<Factory>( buildingType, stock, reservationID, pathPropagator, oPathWay );
+  res = reserveSink( city, buildingType, oPathWay );
 
   return res;
 }
 
-BuildingPtr CartPusher::Impl::getWalkerDestination_warehouse(Propagator &pathPropagator, Pathway& oPathWay)
+BuildingPtr CartPusher::Impl::getWalkerDestination_warehouse(PlayerCityPtr city, Pathway& oPathWay)
 {
   BuildingPtr res;
 
-  res = reserveShortestPath<Warehouse>( object::warehouse, stock, reservationID, pathPropagator, oPathWay );
+  res = reserveSink( city, object::warehouse, oPathWay );
 
   return res;
 }
 
-BuildingPtr CartPusher::Impl::getWalkerDestination_granary(Propagator &pathPropagator, Pathway& oPathWay)
+BuildingPtr CartPusher::Impl::getWalkerDestination_granary(PlayerCityPtr city, Pathway& oPathWay)
 {
    BuildingPtr res;
 
@@ -387,7 +342,7 @@ BuildingPtr CartPusher::Impl::getWalkerDestination_granary(Propagator &pathPropa
       return BuildingPtr();
    }
 
-   res = reserveShortestPath<Granary>(object::granary, stock, reservationID, pathPropagator, oPathWay);
+   res = reserveSink( city, object::granary, oPathWay );
 
    return res;
 }
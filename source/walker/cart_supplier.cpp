@@ -27,7 +27,7 @@
 #include "core/variant_map.hpp"
 #include "game/gamedate.hpp"
 #include "good/helper.hpp"
-#include "pathway/path_finding.hpp"
+#include "city/goods_broker.hpp"
 #include "gfx/animation_bank.hpp"
 #include "objects/factory.hpp"
 #include "name_generator.hpp"
@@ -173,45 +173,21 @@ void CartSupplier::getPictures( Pictures& oPics)
   }
 }
 
-template< class T >
-TilePos getSupplierDestination2( Propagator &pathPropagator, const object::Type type,
-                                 const good::Product what, const int needQty,
-                                 Pathway &oPathWay, long& reservId, BuildingPtr base )
+TilePos getSupplierDestination( PlayerCityPtr city, const object::Type type,
+                                const good::Product what, const int needQty,
+                                Pathway &oPathWay, long& reservId, BuildingPtr base, int maxDistance )
 {
-  SmartPtr< T > res;
-
-  DirectPRoutes pathWayList = pathPropagator.getRoutes( type );
-
-  int max_qty = 0;
-
   // select the warehouse with the max quantity of requested goods
-  for( auto& pathWayIt : pathWayList )
-  {
-    // for every warehouse within range
-    BuildingPtr building= pathWayIt.first.as<Building>();
-
-    if( building == base )
-      continue;
-
-    PathwayPtr pathWay= pathWayIt.second;
-
-    SmartPtr<T> destBuilding = building.as<T>();
-    int qty = destBuilding->store().getMaxRetrieve( what );
-    if( qty > max_qty )
-    {
-      res = destBuilding;
-      oPathWay = *pathWay.object();
-      max_qty = qty;
-    }
-  }
-
-  if( res.isValid() )
+  city::GoodsBroker::Offer offer = city->goodsBroker().findSource( what, type, base.as<Construction>(),
+                                                                   maxDistance, base );
+  if( offer.isValid() )
   {
     // a warehouse/granary has been found!
     // reserve some goods from that warehouse/granary
-    int qty = math::clamp( needQty, 0, max_qty );
-    reservId = res->store().reserveRetrieval( what, qty, game::Date::current() );
-    return res->pos();
+    int qty = math::clamp( needQty, 0, offer.qty );
+    reservId = offer.building->store().reserveRetrieval( what, qty, game::Date::current() );
+    oPathWay = offer.way;
+    return offer.building->pos();
   }
   else
   {
@@ -227,24 +203,19 @@ void CartSupplier::computeWalkerDestination(BuildingPtr building, const good::Pr
     return;
 
   // we have something to buy!
-  // get the list of buildings within reach
   Pathway pathWay;
-  Propagator pathPropagator( _city() );
-  pathPropagator.init( building.as<Construction>() );
-  pathPropagator.setAllDirections( false );
-  pathPropagator.propagate( _d->maxDistance);
 
   // try get that good from a granary
-  _d->storageBuildingPos = getSupplierDestination2<Granary>( pathPropagator, object::granary,
-                                                             type, qty, pathWay, _d->reservationID,
-                                                             building );
+  _d->storageBuildingPos = getSupplierDestination( _city(), object::granary,
+                                                   type, qty, pathWay, _d->reservationID,
+                                                   building, _d->maxDistance );
 
   if( _d->storageBuildingPos.i() < 0 )
   {
     // try get that good from a warehouse
-    _d->storageBuildingPos = getSupplierDestination2<Warehouse>( pathPropagator, object::warehouse,
-                                                                 type, qty, pathWay, _d->reservationID,
-                                                                 building );
+    _d->storageBuildingPos = getSupplierDestination( _city(), object::warehouse,
+                                                     type, qty, pathWay, _d->reservationID,
+                                                     building, _d->maxDistance );
   }
 
   if( _d->storageBuildingPos.i() >= 0 )
@@ -25,7 +25,7 @@
 #include "gfx/tilemap.hpp"
 #include "gfx/tile.hpp"
 #include "core/variant.hpp"
-#include "pathway/path_finding.hpp"
+#include "city/goods_broker.hpp"
 #include "market_kid.hpp"
 #include "core/common.hpp"
 #include "good/storage.hpp"
@@ -78,40 +78,22 @@ MarketBuyer::MarketBuyer(PlayerCityPtr city )
 
 MarketBuyer::~MarketBuyer(){}
 
-template< class T >
-TilePos getWalkerDestination2( Propagator &pathPropagator, const object::Type type,
-                               MarketPtr market, good::Storage& basket, const good::Product what,
-                               Pathway& oPathWay, int& reservId)
+TilePos getWalkerDestination( PlayerCityPtr city, const object::Type type,
+                              MarketPtr market, good::Storage& basket, const good::Product what,
+                              Pathway& oPathWay, int& reservId, int maxDistance )
 {
-  SmartPtr< T > res;
-
-  DirectPRoutes pathWayList = pathPropagator.getRoutes( type );
-
-  int max_qty = 0;
-
   // select the warehouse with the max quantity of requested goods
-  for (auto route : pathWayList) {
-    // for every warehouse within range
-    ConstructionPtr construction = route.first;
-    //PathwayPtr pathWay= routeIt->second;
-
-    SmartPtr< T > destBuilding = construction.as<T>();
-    int qty = destBuilding->store().getMaxRetrieve( what );
-    if( qty > max_qty )
-    {
-      res = destBuilding;
-      oPathWay = *route.second.object();
-      max_qty = qty;
-    }
-  }
-
-  if (res.isValid()) {
+  city::GoodsBroker::Offer offer = city->goodsBroker().findSource( what, type, market.as<Construction>(),
+                                                                   maxDistance );
+  if( offer.isValid() )
+  {
     // a warehouse/granary has been found!
     // reserve some goods from that warehouse/granary
-    int qty = std::min(max_qty, market->getGoodDemand(what));
+    int qty = std::min(offer.qty, market->getGoodDemand(what));
     qty = std::min(qty, basket.freeQty(what));
-    reservId = res->store().reserveRetrieval(what, qty, game::Date::current());
-    return res->pos();
+    reservId = offer.building->store().reserveRetrieval(what, qty, game::Date::current());
+    oPathWay = offer.way;
+    return offer.building->pos();
   }
 
   return TilePos::invalid();
@@ -130,12 +112,7 @@ void MarketBuyer::_computeWalkerDestination( MarketPtr market )
   if( priorityGoods.size() > 0 )
   {
     // we have something to buy!
-    // get the list of buildings within reach
     Pathway pathWay;
-    Propagator pathPropagator( _city() );
-    pathPropagator.init( _d->market.as<Construction>() );
-    pathPropagator.setAllDirections( false );
-    pathPropagator.propagate( _d->maxDistance);
 
     // try to find the most needed good
     for (auto& goodType : priorityGoods) {
@@ -143,20 +120,20 @@ void MarketBuyer::_computeWalkerDestination( MarketPtr market )
 
       if (good::isFood(_d->priorityGood)) {
         // try get that good from a granary
-        _d->destBuildingPos = getWalkerDestination2<Granary>( pathPropagator, object::granary, _d->market,
-                                                              _d->basket, _d->priorityGood, pathWay, _d->reservationID );
+        _d->destBuildingPos = getWalkerDestination( _city(), object::granary, _d->market, _d->basket,
+                                                    _d->priorityGood, pathWay, _d->reservationID, _d->maxDistance );
 
         if( _d->destBuildingPos == TilePos::invalid() )
         {
-          _d->destBuildingPos = getWalkerDestination2<Warehouse>( pathPropagator, object::warehouse, _d->market,
-                                                                _d->basket, _d->priorityGood, pathWay, _d->reservationID );
+          _d->destBuildingPos = getWalkerDestination( _city(), object::warehouse, _d->market, _d->basket,
+                                                      _d->priorityGood, pathWay, _d->reservationID, _d->maxDistance );
         }
       }
       else
       {
         // try get that good from a warehouse
-        _d->destBuildingPos = getWalkerDestination2<Warehouse>( pathPropagator, object::warehouse, _d->market,
-                                                                _d->basket, _d->priorityGood, pathWay, _d->reservationID );
+        _d->destBuildingPos = getWalkerDestination( _city(), object::warehouse, _d->market, _d->basket,
+                                                    _d->priorityGood, pathWay, _d->reservationID, _d->maxDistance );
       }
 
       if( config::tilemap.isValidLocation( _d->destBuildingPos ) )
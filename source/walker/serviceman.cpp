@@ -33,7 +33,7 @@
 #include "corpse.hpp"
 #include "gfx/tilemap_config.hpp"
 #include "city/states.hpp"
-#include "gfx/tilearea.hpp"
+#include "city/coverage_field.hpp"
 #include "walkers_factory.hpp"
 #include "core/common.hpp"
 
@@ -53,6 +53,62 @@ REGISTER_SERVICEMAN_IN_WALKERFACTORY( walker::missioner,Service::missionary, mis
 
 namespace {
   const unsigned int defaultServiceDistance = 5;
+
+// Demand of buildings along candidate ways. Every building is
+// evaluated only once per route choice, whatever ways pass it.
+class DemandMap
+{
+public:
+  DemandMap( city::CoverageField& coverage, ServiceWalkerPtr walker )
+    : _coverage( coverage ), _walker( walker ), _generation( 0 ) {}
+
+  float evaluate( const Pathway& way )
+  {
+    // buildings already counted for current way
+    _generation++;
+
+    float res = 0.0;
+    unsigned int distance = _walker->reachDistance();
+    for( auto tile : way.allTiles() )
+    {
+      const city::CoverageField::Indexes& reached = _coverage.reached( tile->pos(), distance );
+      for( auto index : reached )
+      {
+        if( index >= _mark.size() )
+        {
+          _mark.resize( _coverage.count(), 0 );
+          _known.resize( _coverage.count(), false );
+          _value.resize( _coverage.count(), 0.f );
+        }
+
+        if( _mark[ index ] == _generation )
+          continue;
+
+        _mark[ index ] = _generation;
+        if( !_known[ index ] )
+        {
+          BuildingPtr bld = _coverage.building( index );
+          int oneTileValue = bld->evaluateService( _walker );
+          // mul serviceValue for buildingSize, need for more effectively count of path result
+          _value[ index ] = oneTileValue * bld->size().area();
+          _known[ index ] = true;
+        }
+
+        res += _value[ index ];
+      }
+    }
+
+    return res;
+  }
+
+private:
+  city::CoverageField& _coverage;
+  ServiceWalkerPtr _walker;
+  unsigned int _generation;
+  std::vector<unsigned int> _mark;
+  std::vector<bool> _known;
+  std::vector<float> _value;
+};
 }
 
 class ServiceWalker::Impl
@@ -145,13 +201,14 @@ void ServiceWalker::_computeWalkerPath( int orders )
 
   PathwayList pathWayList = pathPropagator.getWays(_d->maxDistance);
   PathwayPtr bestPath;
+  DemandMap demand( _city()->coverage(), this );
 
   if( (orders & goServiceMaximum) == goServiceMaximum )
   {
     float maxPathValue = 0.0;
     for( auto current : pathWayList )
     {
-      float pathValue = evaluatePath( current );
+      float pathValue = demand.evaluate( *current.object() );
       if(pathValue > maxPathValue)
       {
         bestPath = current;
@@ -164,7 +221,7 @@ void ServiceWalker::_computeWalkerPath( int orders )
     float minPathValue = 9999.f;
     for( auto current : pathWayList )
     {
-      float pathValue = evaluatePath( current );
+      float pathValue = demand.evaluate( *current.object() );
       if(pathValue < minPathValue)
       {
         bestPath = current;
@@ -226,9 +283,10 @@ ReachedBuildings ServiceWalker::getReachedBuildings(const TilePos& pos )
 {
   ReachedBuildings res;
 
-  TilesArea reachedTiles( _map(), reachDistance(), pos );
-  for( auto tile : reachedTiles )
-    res.addIfValid( tile->overlay<Building>() );
+  city::CoverageField& coverage = _city()->coverage();
+  const city::CoverageField::Indexes& reached = coverage.reached( pos, reachDistance() );
+  for( auto index : reached )
+    res.addIfValid( coverage.building( index ) );
 
   return res;
 }
@@ -236,29 +294,8 @@ ReachedBuildings ServiceWalker::getReachedBuildings(const TilePos& pos )
 float ServiceWalker::evaluatePath( PathwayPtr pathWay )
 {
   // evaluate all buildings along the path
-  ReachedBuildings doneBuildings;  // list of evaluated building: don't do them again
-  const TilesArray& pathTileList = pathWay->allTiles();
-
-  int distance = 0;
-  float res = 0.0;
-  for( auto tile : pathTileList )
-  {
-    ReachedBuildings reachedBuildings = getReachedBuildings( tile->pos() );
-    for( auto bld : reachedBuildings )
-    {
-      bool added = doneBuildings.insert( bld );
-      if (added)
-      {
-        // the building has not been evaluated yet
-        int oneTileValue = bld->evaluateService( this );
-        // mul serviceValue for buildingSize, need for more effectively count of path result
-        res += (oneTileValue * bld->size().area() );
-      }
-    }
-    distance++;
-  }
-
-  return res;
+  DemandMap demand( _city()->coverage(), this );
+  return demand.evaluate( *pathWay.object() );
 }
 
 void ServiceWalker::_reservePath( const Pathway& pathWay)
@@ -21,6 +21,7 @@
 #include "good/storage.hpp"
 #include "good/helper.hpp"
 #include "game/gamedate.hpp"
+#include "core/hash.hpp"
 #include "merchant.hpp"
 #include "game/funds.hpp"
 #include "game/resourcegroup.hpp"
@@ -942,13 +943,14 @@ ComputerCity::~ComputerCity() {}
 
 void ComputerCity::timeStep( unsigned int time )
 {
-  if( game::Date::isWeekChanged() )
+  unsigned int phase = game::Date::phaseOf( Hash( name() ) );
+  if( game::Date::isWeekPhase( phase ) )
   {
     _d->calcPopulationChange();
     _d->strength = math::clamp<int>( _d->strength+1, 0, _d->states.population / 100 );
   }
 
-  if( game::Date::isMonthChanged() )
+  if( game::Date::isMonthPhase( phase ) )
   {
     _d->trade.delay = math::clamp<int>( _d->trade.delay-1, 0, 99 );
     _d->calculateMonthState();